@@ -23,7 +23,7 @@ namespace MyRenderEngine {
 		) override {
 			ImGui::Begin("Basic Info");
 
-			// λ
+			// 相机位置
 			float& camX = myRenderEngine.camera.Position.x;
 			float& camY = myRenderEngine.camera.Position.y;
 			float& camZ = myRenderEngine.camera.Position.z;
@@ -32,22 +32,22 @@ namespace MyRenderEngine {
 			ImGui::InputFloat("Camera Y", &camY);
 			ImGui::InputFloat("Camera Z", &camZ);
 
-			// ƶٶ
+			// 移动速度
 			ImGui::InputFloat("Camera Speed", &myRenderEngine.camera.MovementSpeed);
 
-			// ģͷŴ
+			// 模型放大倍率
 			ImGui::InputFloat("Scale Factor", &myRenderEngine.scaleFactor, 0.1f, 1.0f, "%.3f");
 
-			// ʾģ
+			// 显示模型
 			ImGui::Checkbox("Show Model", &myRenderEngine.showModel);
 
-			// ģ͸
+			// 模型透明
 			ImGui::Checkbox("Transparent Model", &myRenderEngine.transparentModel);
 
 			ImGui::End();
 		}
 
-		// TODO: Ҫ
+		// TODO: 要尽量避免这种情况
 		BasicGuiRenderer(MyRenderEngine& myRenderEngine): myRenderEngine(myRenderEngine) {
 
 		}
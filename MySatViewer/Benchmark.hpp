@@ -0,0 +1,1035 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "stl_reader.h"
+#include "ThreadPool.hpp"
+#include "GeometryKernels.hpp"
+#include "Topology.hpp"
+#include "SatInfo.hpp"
+#include "ObjInfo.hpp"
+#include "ObjMarkNum.hpp"
+#include "HalfEdgeMesh.hpp"
+#include "EdgeHashMap.hpp"
+#include "ProcessMemory.hpp"
+
+#include <spdlog/spdlog.h>
+
+/*
+	性能测试
+	用途：对加载路径上的热点做可重复的对比测试，通过 -m bench --bench <名字> 运行，不创建窗口
+	线程数同样由 -j 决定
+*/
+
+namespace Benchmark {
+
+	// 计时（毫秒）
+	template <typename F>
+	double TimeMs(F&& f) {
+		auto start = std::chrono::steady_clock::now();
+		f();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	// 重复多次取最短时间，减少其它进程的干扰
+	template <typename F>
+	double BestTimeMs(int repeats, F&& f) {
+		double best = std::numeric_limits<double>::max();
+		for (int r = 0; r < repeats; r++) {
+			best = std::min(best, TimeMs(f));
+		}
+		return best;
+	}
+
+	void Report(const std::string& name, double ms, size_t bytes) {
+		double mb = bytes / (1024.0 * 1024.0);
+		std::cout << "  " << name << ": " << ms << " ms, " << mb / (ms / 1000.0) << " MB/s" << std::endl;
+		SPDLOG_INFO("bench {}: {} ms, {} MB/s", name, ms, mb / (ms / 1000.0));
+	}
+
+	// 生成一个ASCII STL：两个solid，每个是一张起伏的规则网格曲面，直到文件大小达到target_bytes
+	void GenerateAsciiStl(const std::string& path, size_t target_bytes) {
+		std::ofstream out(path, std::ios::binary);
+		if (!out.is_open()) {
+			throw std::runtime_error("Cannot create benchmark file: " + path);
+		}
+
+		const size_t facet_bytes = 260; // 每个facet大约的字节数
+		const size_t grid_n = static_cast<size_t>(std::sqrt(target_bytes / facet_bytes / 4)) + 1; // 每个solid有 2*n*n 个三角形
+
+		std::vector<char> buffer(1 << 20);
+		std::string text;
+		text.reserve(buffer.size() + 4096);
+
+		auto height = [](size_t i, size_t j, size_t solid) {
+			return static_cast<float>(std::sin(i * 0.01) * std::cos(j * 0.013) * 10.0 + solid * 50.0);
+		};
+
+		auto write_facet = [&](const float(&p)[3][3]) {
+			char line[128];
+			float u[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+			float v[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+			float nrm[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+			float len = std::sqrt(nrm[0] * nrm[0] + nrm[1] * nrm[1] + nrm[2] * nrm[2]);
+			if (len > 0) {
+				for (int k = 0; k < 3; k++) nrm[k] /= len;
+			}
+
+			std::snprintf(line, sizeof(line), "  facet normal %e %e %e\n", nrm[0], nrm[1], nrm[2]);
+			text += line;
+			text += "    outer loop\n";
+			for (int k = 0; k < 3; k++) {
+				std::snprintf(line, sizeof(line), "      vertex %e %e %e\n", p[k][0], p[k][1], p[k][2]);
+				text += line;
+			}
+			text += "    endloop\n";
+			text += "  endfacet\n";
+
+			if (text.size() >= buffer.size()) {
+				out.write(text.data(), text.size());
+				text.clear();
+			}
+		};
+
+		for (size_t solid = 0; solid < 2; solid++) {
+			text += "solid bench_" + std::to_string(solid) + "\n";
+
+			for (size_t i = 0; i < grid_n; i++) {
+				for (size_t j = 0; j < grid_n; j++) {
+					float p00[3] = { float(i), float(j), height(i, j, solid) };
+					float p10[3] = { float(i + 1), float(j), height(i + 1, j, solid) };
+					float p01[3] = { float(i), float(j + 1), height(i, j + 1, solid) };
+					float p11[3] = { float(i + 1), float(j + 1), height(i + 1, j + 1, solid) };
+
+					float t0[3][3] = { { p00[0], p00[1], p00[2] }, { p10[0], p10[1], p10[2] }, { p11[0], p11[1], p11[2] } };
+					float t1[3][3] = { { p00[0], p00[1], p00[2] }, { p11[0], p11[1], p11[2] }, { p01[0], p01[1], p01[2] } };
+					write_facet(t0);
+					write_facet(t1);
+				}
+			}
+
+			text += "endsolid bench_" + std::to_string(solid) + "\n";
+		}
+
+		out.write(text.data(), text.size());
+	}
+
+	// ASCII STL：原来基于iostream的逐行解析 vs 内存映射+分块并行解析
+	void RunStlAscii(const std::string& path, size_t size_mb) {
+		std::ifstream probe(path);
+		if (!probe.is_open()) {
+			std::cout << "Generating " << size_mb << " MB ASCII STL: " << path << std::endl;
+			GenerateAsciiStl(path, size_mb * 1024 * 1024);
+		}
+		probe.close();
+
+		Utils::MappedFile file;
+		if (!file.Open(path)) {
+			throw std::runtime_error("Cannot open benchmark file: " + path);
+		}
+		size_t file_size = file.Size();
+		file.Close();
+
+		std::cout << "ASCII STL " << path << " (" << file_size / (1024.0 * 1024.0) << " MB), threads: " << Utils::ThreadPool::GetInstance().ThreadCount() << std::endl;
+
+		std::vector<float> coords_stream, normals_stream, coords_chunked, normals_chunked;
+		std::vector<unsigned int> tris_stream, solids_stream, tris_chunked, solids_chunked;
+
+		double stream_ms = TimeMs([&]() {
+			stl_reader::ReadStlFile_ASCII_Stream(path.c_str(), coords_stream, normals_stream, tris_stream, solids_stream);
+		});
+		Report("iostream", stream_ms, file_size);
+
+		double chunked_ms = TimeMs([&]() {
+			stl_reader::ReadStlFile_ASCII(path.c_str(), coords_chunked, normals_chunked, tris_chunked, solids_chunked);
+		});
+		Report("mapped chunks", chunked_ms, file_size);
+
+		bool same = coords_stream == coords_chunked && normals_stream == normals_chunked
+			&& tris_stream == tris_chunked && solids_stream == solids_chunked;
+
+		std::cout << "  triangles: " << tris_chunked.size() / 3 << ", unique vertices: " << coords_chunked.size() / 3
+			<< ", speedup: " << stream_ms / chunked_ms << "x, identical: " << (same ? "yes" : "NO") << std::endl;
+	}
+
+	// 面法向+包围盒：原来STL加载（glm逐三角形）和OBJ渲染（Topology::Coordinate逐三角形push_back）的写法 vs GeometryKernels的各指令集版本
+	// 输入为随机三角形，数据量按输出的顶点数组（每个三角形72字节）计算
+	void RunNormals(size_t size_mb) {
+		size_t num_tris = size_mb * 1024 * 1024 / (18 * sizeof(float));
+		size_t out_bytes = num_tris * 18 * sizeof(float);
+
+		std::vector<float> positions(num_tris * 9);
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+		for (auto& v : positions) {
+			v = dist(rng);
+		}
+
+		std::cout << "Normals + AABB: " << num_tris << " triangles, threads: " << Utils::ThreadPool::GetInstance().ThreadCount()
+			<< ", best ISA: " << GeometryKernels::IsaName(GeometryKernels::BestIsa()) << std::endl;
+
+		auto& pool = Utils::ThreadPool::GetInstance();
+		std::vector<float> legacy(num_tris * 18);
+
+		// 原来的STL加载：按块并行，每个三角形用glm求法向、逐分量求最小值
+		const int repeats = 5;
+
+		glm::vec3 legacy_min;
+		double legacy_ms = BestTimeMs(repeats, [&]() {
+			legacy_min = glm::vec3{ std::numeric_limits<float>::max() };
+			std::vector<glm::vec3> chunk_min(pool.ChunkCount(num_tris), legacy_min);
+			pool.ParallelFor(num_tris, [&](size_t begin, size_t end, size_t chunk_index) {
+				glm::vec3 min_pos = chunk_min[chunk_index];
+				for (size_t t = begin; t < end; t++) {
+					const float* p = positions.data() + 9 * t;
+					glm::vec3 triangle_points[3] = { { p[0], p[1], p[2] }, { p[3], p[4], p[5] }, { p[6], p[7], p[8] } };
+					glm::vec3 normal = glm::normalize(glm::cross(triangle_points[1] - triangle_points[0], triangle_points[2] - triangle_points[0]));
+
+					float* out = legacy.data() + 18 * t;
+					for (int j = 0; j < 3; j++) {
+						*out++ = triangle_points[j].x;
+						*out++ = triangle_points[j].y;
+						*out++ = triangle_points[j].z;
+						*out++ = normal.x;
+						*out++ = normal.y;
+						*out++ = normal.z;
+						min_pos = glm::min(min_pos, triangle_points[j]);
+					}
+				}
+				chunk_min[chunk_index] = min_pos;
+			});
+			for (auto& min_pos : chunk_min) {
+				legacy_min = glm::min(legacy_min, min_pos);
+			}
+		});
+		Report("legacy stl (glm)", legacy_ms, out_bytes);
+
+		// 原来的OBJ渲染：单线程，double精度的Coordinate，逐个push_back（法向未归一化）
+		{
+			double obj_ms = BestTimeMs(repeats, [&]() {
+				std::vector<float> obj_vertices;
+				for (size_t t = 0; t < num_tris; t++) {
+					const float* p = positions.data() + 9 * t;
+					Topology::Coordinate p1(p[0], p[1], p[2]);
+					Topology::Coordinate p2(p[3], p[4], p[5]);
+					Topology::Coordinate p3(p[6], p[7], p[8]);
+					auto normal = (p2 - p1).Cross(p3 - p1);
+
+					for (auto* q : { &p1, &p2, &p3 }) {
+						obj_vertices.emplace_back(q->x());
+						obj_vertices.emplace_back(q->y());
+						obj_vertices.emplace_back(q->z());
+						obj_vertices.emplace_back(normal.x());
+						obj_vertices.emplace_back(normal.y());
+						obj_vertices.emplace_back(normal.z());
+					}
+				}
+			});
+			Report("legacy obj (Coordinate)", obj_ms, out_bytes);
+		}
+
+		std::vector<GeometryKernels::Isa> isas = { GeometryKernels::Isa::Scalar };
+		if (GeometryKernels::BestIsa() != GeometryKernels::Isa::Scalar) {
+			isas.push_back(GeometryKernels::Isa::AVX2);
+		}
+		if (GeometryKernels::BestIsa() == GeometryKernels::Isa::AVX512) {
+			isas.push_back(GeometryKernels::Isa::AVX512);
+		}
+
+		std::vector<float> scalar_result;
+		for (auto isa : isas) {
+			std::vector<float> out(num_tris * 18);
+			GeometryKernels::Bounds bounds;
+
+			double ms = BestTimeMs(repeats, [&]() {
+				bounds = GeometryKernels::ParallelFillTriangles(out.data(), num_tris, [&](size_t t, int j) {
+					return positions.data() + 9 * t + 3 * j;
+				}, isa);
+			});
+			Report(std::string("kernel ") + GeometryKernels::IsaName(isa), ms, out_bytes);
+
+			float max_diff = 0.0f;
+			for (size_t i = 0; i < out.size(); i++) {
+				max_diff = std::max(max_diff, std::fabs(out[i] - legacy[i]));
+			}
+			std::cout << "    max diff vs legacy stl: " << max_diff << ", min corner matches: " << (bounds.min == legacy_min ? "yes" : "NO");
+
+			if (isa == GeometryKernels::Isa::Scalar) {
+				scalar_result = std::move(out);
+			}
+			else {
+				std::cout << ", bitwise identical to scalar: " << (std::memcmp(out.data(), scalar_result.data(), out.size() * sizeof(float)) == 0 ? "yes" : "NO");
+			}
+			std::cout << std::endl;
+		}
+	}
+
+	const size_t GENERATED_BODY_COUNT = 4;
+
+	// 生成一个geometry json：格式与导出工具一致（键按字母序，缩进3个空格），边的数量按目标大小决定
+	// 每条边有400个采样点，直线/椭圆/intcurve轮流出现；另外每条边带一个有pcurve的coedge，每4个coedge组成一个环和一个面
+	// 所有记录按环的顺序平均分到GENERATED_BODY_COUNT个body中
+	void GenerateGeometryJson(const std::string& path, size_t target_bytes) {
+		std::ofstream out(path, std::ios::binary);
+		if (!out.is_open()) {
+			throw std::runtime_error("Cannot create benchmark file: " + path);
+		}
+
+		const size_t points_per_edge = 400;
+		const size_t edge_bytes = points_per_edge * 155 + 2500; // 每条边（连同对应的coedge、顶点和分摊的环、面）大约的字节数
+		const size_t edge_count = std::max<size_t>(1, target_bytes / edge_bytes);
+		const size_t vertex_count = edge_count;
+		const size_t coedge_count = edge_count;
+		const size_t loop_count = (coedge_count + 3) / 4;
+
+		// 第i个环（以及其中的coedge、边、顶点）所属的body
+		auto body_of_loop = [&](size_t i) {
+			return i * GENERATED_BODY_COUNT / loop_count + 1;
+		};
+
+		std::string text;
+		char line[512];
+
+		auto flush = [&]() {
+			if (text.size() >= (1 << 20)) {
+				out.write(text.data(), text.size());
+				text.clear();
+			}
+		};
+
+		auto write_point = [&](const char* indent, double x, double y, double z, bool last) {
+			std::snprintf(line, sizeof(line), "%s{\n%s   \"x\" : %.15f,\n%s   \"y\" : %.15f,\n%s   \"z\" : %.15f\n%s}%s\n",
+				indent, indent, x, indent, y, indent, z, indent, last ? "" : ",");
+			text += line;
+		};
+
+		text += "{\n   \"basic_statistics\" : {\n";
+		std::snprintf(line, sizeof(line),
+			"      \"marknum_body\" : %zu,\n      \"marknum_coedge\" : %zu,\n      \"marknum_edge\" : %zu,\n      \"marknum_face\" : %zu,\n"
+			"      \"marknum_loop\" : %zu,\n      \"marknum_lump\" : 1,\n      \"marknum_shell\" : 1,\n      \"marknum_vertex\" : %zu,\n      \"marknum_wire\" : 0\n   },\n",
+			GENERATED_BODY_COUNT, coedge_count, edge_count, loop_count, loop_count, vertex_count);
+		text += line;
+		text += "   \"root_bodies\" : null,\n";
+
+		// coedge：每条边一个，带pcurve；每4个coedge组成一个环，每个环一个面
+		text += "   \"root_coedges\" : [\n";
+		for (size_t i = 0; i < coedge_count; i++) {
+			std::snprintf(line, sizeof(line), "      {\n         \"body\" : %zu,\n         \"edge_marknum\" : %zu,\n         \"face_marknum\" : %zu,\n"
+				"         \"loop_marknum\" : %zu,\n         \"marknum\" : %zu,\n         \"property\" : {\n            \"ctrlpts\" : [\n",
+				body_of_loop(i / 4), i + 1, i / 4 + 1, i / 4 + 1, i + 1);
+			text += line;
+			for (int k = 0; k < 4; k++) {
+				std::snprintf(line, sizeof(line), "               {\n                  \"u\" : %.15f,\n                  \"v\" : %.15f\n               }%s\n",
+					k / 3.0, (i % 4) * 0.25, k == 3 ? "" : ",");
+				text += line;
+			}
+			std::snprintf(line, sizeof(line), "            ],\n            \"curve_degree\" : 3,\n            \"curve_name\" : \"pcurve\",\n"
+				"            \"knots\" : [ 0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 1.0 ]\n         },\n         \"sense\" : %d\n      }%s\n",
+				int(i % 2), i + 1 == coedge_count ? "" : ",");
+			text += line;
+			flush();
+		}
+		text += "   ],\n";
+
+		text += "   \"root_edges\" : [\n";
+		for (size_t i = 0; i < edge_count; i++) {
+			double ox = (i % 100) * 10.0, oy = (i / 100) * 10.0;
+			const char* curve_types[3] = { "straight", "ellipse", "intcurve" };
+			const char* curve_type = curve_types[i % 3];
+
+			std::snprintf(line, sizeof(line), "      {\n         \"body\" : %zu,\n         \"curve_type\" : \"%s\",\n         \"ed_marknum\" : %zu,\n         \"marknum\" : %zu,\n         \"nonmanifold_count\" : %zu,\n         \"property\" : {\n",
+				body_of_loop(i / 4), curve_type, (i + 1) % vertex_count + 1, i + 1, i % 4);
+			text += line;
+
+			if (i % 3 == 0) {
+				std::snprintf(line, sizeof(line), "            \"direction_x\" : 1.0,\n            \"direction_y\" : 0.0,\n            \"direction_z\" : 0.0,\n"
+					"            \"root_point_x\" : %.15f,\n            \"root_point_y\" : %.15f,\n            \"root_point_z\" : 0.0\n", ox, oy);
+				text += line;
+			}
+			else if (i % 3 == 1) {
+				std::snprintf(line, sizeof(line), "            \"centre_x\" : %.15f,\n            \"centre_y\" : %.15f,\n            \"centre_z\" : 0.0,\n"
+					"            \"major_axis_x\" : 3.0,\n            \"major_axis_y\" : 0.0,\n            \"major_axis_z\" : 0.0,\n", ox, oy);
+				text += line;
+				text += "            \"major_length\" : 3.0,\n            \"minor_length\" : 2.0,\n"
+					"            \"normal_x\" : 0.0,\n            \"normal_y\" : 0.0,\n            \"normal_z\" : 1.0\n";
+			}
+			else {
+				text += "            \"ctrlpts\" : [\n";
+				for (int k = 0; k < 8; k++) {
+					write_point("               ", ox + k, oy + std::sin(k * 0.5), 0.0, k == 7);
+				}
+				text += "            ]\n";
+			}
+			text += "         },\n         \"sampled_points\" : [\n";
+
+			for (size_t k = 0; k < points_per_edge; k++) {
+				double t = k / double(points_per_edge - 1);
+				write_point("            ", ox + t * 7.0, oy + std::sin(t * 6.0) * 3.0, std::cos(t * 4.0), k + 1 == points_per_edge);
+			}
+
+			std::snprintf(line, sizeof(line), "         ],\n         \"st_marknum\" : %zu\n      }%s\n", i % vertex_count + 1, i + 1 == edge_count ? "" : ",");
+			text += line;
+			flush();
+		}
+		text += "   ],\n";
+
+		// 面：平面和3x3的样条面交替出现
+		text += "   \"root_faces\" : [\n";
+		for (size_t i = 0; i < loop_count; i++) {
+			double ox = (i % 100) * 10.0, oy = (i / 100) * 10.0;
+			std::snprintf(line, sizeof(line), "      {\n         \"body\" : %zu,\n         \"geometry_info\" : {\n", body_of_loop(i));
+			text += line;
+			if (i % 2 == 0) {
+				text += "            \"face_type\" : \"plane\",\n            \"normal_x\" : 0.0,\n            \"normal_y\" : 0.0,\n            \"normal_z\" : 1.0,\n";
+				std::snprintf(line, sizeof(line), "            \"root_point_x\" : %.15f,\n            \"root_point_y\" : %.15f,\n            \"root_point_z\" : 0.0\n", ox, oy);
+				text += line;
+			}
+			else {
+				text += "            \"control_points\" : [\n";
+				for (int k = 0; k < 9; k++) {
+					write_point("               ", ox + k % 3, oy + k / 3, std::sin(k * 0.7), k == 8);
+				}
+				text += "            ],\n            \"degree_u\" : 2,\n            \"degree_v\" : 2,\n            \"face_type\" : \"spline\",\n"
+					"            \"knots_u\" : [ 0.0, 0.0, 0.0, 1.0, 1.0, 1.0 ],\n            \"knots_v\" : [ 0.0, 0.0, 0.0, 1.0, 1.0, 1.0 ],\n"
+					"            \"num_knots_u\" : 6,\n            \"num_knots_v\" : 6,\n            \"num_u\" : 3,\n            \"num_v\" : 3,\n"
+					"            \"weight_num_u\" : 3,\n            \"weight_num_v\" : 3,\n"
+					"            \"weights\" : [ 1.0, 1.0, 1.0, 1.0, 2.0, 1.0, 1.0, 1.0, 1.0 ]\n";
+			}
+			std::snprintf(line, sizeof(line), "         },\n         \"loop_marknum\" : %zu,\n         \"marknum\" : %zu,\n         \"sense\" : 0\n      }%s\n",
+				i + 1, i + 1, i + 1 == loop_count ? "" : ",");
+			text += line;
+			flush();
+		}
+		text += "   ],\n";
+
+		text += "   \"root_loops\" : [\n";
+		for (size_t i = 0; i < loop_count; i++) {
+			std::snprintf(line, sizeof(line), "      {\n         \"body\" : %zu,\n         \"coedge_list\" : [\n", body_of_loop(i));
+			text += line;
+			size_t first = i * 4, last = std::min(first + 4, coedge_count);
+			for (size_t k = first; k < last; k++) {
+				std::snprintf(line, sizeof(line), "            {\n               \"coedge_marknum\" : %zu,\n               \"edge_marknum\" : %zu\n            }%s\n",
+					k + 1, k + 1, k + 1 == last ? "" : ",");
+				text += line;
+			}
+			std::snprintf(line, sizeof(line), "         ],\n         \"face_marknum\" : %zu,\n         \"marknum\" : %zu\n      }%s\n",
+				i + 1, i + 1, i + 1 == loop_count ? "" : ",");
+			text += line;
+			flush();
+		}
+		text += "   ],\n   \"root_lumps\" : null,\n   \"root_shells\" : null,\n";
+
+		text += "   \"root_vertices\" : [\n";
+		for (size_t i = 0; i < vertex_count; i++) {
+			std::snprintf(line, sizeof(line), "      {\n         \"body\" : %zu,\n         \"marknum\" : %zu,\n         \"point\" : {\n", body_of_loop(i / 4), i + 1);
+			text += line;
+			std::snprintf(line, sizeof(line), "            \"x\" : %.15f,\n            \"y\" : %.15f,\n            \"z\" : 0.0\n         }\n      }%s\n",
+				(i % 100) * 10.0, (i / 100) * 10.0, i + 1 == vertex_count ? "" : ",");
+			text += line;
+			flush();
+		}
+		text += "   ]\n}\n";
+
+		out.write(text.data(), text.size());
+	}
+
+	// 两次加载的结果是否一致
+	bool SameBrepInfo(Info::SatInfo& a, Info::SatInfo& b) {
+		auto& va = a.brepInfo.vertexInfos;
+		auto& vb = b.brepInfo.vertexInfos;
+		if (va.size() != vb.size()) return false;
+		for (size_t i = 0; i < va.size(); i++) {
+			if (va[i].markNum != vb[i].markNum || va[i].bodyId != vb[i].bodyId || va[i].pos != vb[i].pos) return false;
+		}
+
+		auto& ea = a.brepInfo.edgeInfos;
+		auto& eb = b.brepInfo.edgeInfos;
+		if (ea.size() != eb.size()) return false;
+		for (size_t i = 0; i < ea.size(); i++) {
+			if (ea[i].markNum != eb[i].markNum || ea[i].bodyId != eb[i].bodyId || ea[i].pos != eb[i].pos
+				|| ea[i].stMarkNum != eb[i].stMarkNum || ea[i].edMarkNum != eb[i].edMarkNum || ea[i].nonmanifoldCount != eb[i].nonmanifoldCount) return false;
+
+			// 两边的行号可以不同（例如并行解析时块的顺序），只比较行的内容。延迟解码的参数在这里读取
+			int ra = ea[i].geometryIndex;
+			int rb = eb[i].geometryIndex;
+			if ((ra < 0) != (rb < 0)) return false;
+			if (ra < 0) continue;
+			if (a.DecodeEdgeGeometry(ra) != b.DecodeEdgeGeometry(rb)) return false;
+
+			auto& ta = a.brepInfo.edgeGeometries;
+			auto& tb = b.brepInfo.edgeGeometries;
+			if (ta.curveTypes[ra] != tb.curveTypes[rb] || ta.CurveTypeName(ra) != tb.CurveTypeName(rb) || ta.PointCount(ra) != tb.PointCount(rb)
+				|| !std::equal(ta.Points(ra), ta.Points(ra) + ta.PointCount(ra), tb.Points(rb))) return false;
+
+			if (ta.curveTypes[ra] == Info::CurveType::STRAIGHT) {
+				auto& sa = ta.Straight(ra);
+				auto& sb = tb.Straight(rb);
+				if (sa.rootPoint != sb.rootPoint || sa.direction != sb.direction) return false;
+			}
+			else if (ta.curveTypes[ra] == Info::CurveType::ELLIPSE) {
+				auto& la = ta.Ellipse(ra);
+				auto& lb = tb.Ellipse(rb);
+				if (la.centre != lb.centre || la.normal != lb.normal || la.majorAxis != lb.majorAxis
+					|| la.majorAxisLength != lb.majorAxisLength || la.minorAxisLength != lb.minorAxisLength) return false;
+			}
+			else if (ta.curveTypes[ra] == Info::CurveType::INTCURVE) {
+				if (ta.IntcurveCtrlptCount(ra) != tb.IntcurveCtrlptCount(rb)
+					|| !std::equal(ta.IntcurveCtrlpts(ra), ta.IntcurveCtrlpts(ra) + ta.IntcurveCtrlptCount(ra), tb.IntcurveCtrlpts(rb))) return false;
+			}
+		}
+
+		auto& ha = a.brepInfo.halfEdgeInfos;
+		auto& hb = b.brepInfo.halfEdgeInfos;
+		if (ha.size() != hb.size()) return false;
+		for (size_t i = 0; i < ha.size(); i++) {
+			if (ha[i].markNum != hb[i].markNum || ha[i].bodyId != hb[i].bodyId || ha[i].pos != hb[i].pos || ha[i].sense != hb[i].sense
+				|| ha[i].edgeMarkNum != hb[i].edgeMarkNum || ha[i].loopMarkNum != hb[i].loopMarkNum || ha[i].partnerMarkNum != hb[i].partnerMarkNum
+				|| ha[i].preMarkNum != hb[i].preMarkNum || ha[i].nextMarkNum != hb[i].nextMarkNum) return false;
+
+			auto* ga = ha[i].halfEdgeGeometry.get();
+			auto* gb = hb[i].halfEdgeGeometry.get();
+			if ((ga == nullptr) != (gb == nullptr)) return false;
+			if (ga == nullptr) continue;
+			if (ga->curveType != gb->curveType) return false;
+
+			if (ga->curveType == "pcurve") {
+				auto* pa = static_cast<Info::PcurveHalfEdgeGeometry*>(ga);
+				auto* pb = static_cast<Info::PcurveHalfEdgeGeometry*>(gb);
+				if (pa->curveDegree != pb->curveDegree || pa->ctrlpts != pb->ctrlpts || pa->knots != pb->knots) return false;
+			}
+		}
+
+		auto& la = a.brepInfo.loopInfos;
+		auto& lb = b.brepInfo.loopInfos;
+		if (la.size() != lb.size()) return false;
+		for (size_t i = 0; i < la.size(); i++) {
+			if (la[i].markNum != lb[i].markNum || la[i].bodyId != lb[i].bodyId || la[i].pos != lb[i].pos
+				|| la[i].faceMarkNum != lb[i].faceMarkNum || la[i].halfEdgesMarkNums != lb[i].halfEdgesMarkNums) return false;
+		}
+
+		auto& fa = a.brepInfo.faceInfos;
+		auto& fb = b.brepInfo.faceInfos;
+		if (fa.size() != fb.size()) return false;
+		for (size_t i = 0; i < fa.size(); i++) {
+			if (fa[i].markNum != fb[i].markNum || fa[i].bodyId != fb[i].bodyId || fa[i].pos != fb[i].pos || fa[i].stLoopMarkNum != fb[i].stLoopMarkNum) return false;
+
+			auto* ga = fa[i].faceGeometry.get();
+			auto* gb = fb[i].faceGeometry.get();
+			if ((ga == nullptr) != (gb == nullptr)) return false;
+			if (ga == nullptr) continue;
+			if (ga->faceType != gb->faceType) return false;
+
+			if (ga->faceType == "plane") {
+				auto* pa = static_cast<Info::PlaneFaceGeometry*>(ga);
+				auto* pb = static_cast<Info::PlaneFaceGeometry*>(gb);
+				if (pa->rootPoint != pb->rootPoint || pa->normal != pb->normal) return false;
+			}
+			else if (ga->faceType == "sphere") {
+				auto* sa = static_cast<Info::SphereFaceGeometry*>(ga);
+				auto* sb = static_cast<Info::SphereFaceGeometry*>(gb);
+				if (sa->centre != sb->centre || sa->radius != sb->radius) return false;
+			}
+			else if (ga->faceType == "torus") {
+				auto* ta = static_cast<Info::TorusFaceGeometry*>(ga);
+				auto* tb = static_cast<Info::TorusFaceGeometry*>(gb);
+				if (ta->centre != tb->centre || ta->normal != tb->normal || ta->minorRadius != tb->minorRadius || ta->majorRadius != tb->majorRadius) return false;
+			}
+			else if (ga->faceType == "cone") {
+				auto* ca = static_cast<Info::ConeFaceGeometry*>(ga);
+				auto* cb = static_cast<Info::ConeFaceGeometry*>(gb);
+				if (ca->rootPoint != cb->rootPoint || ca->majorAxis != cb->majorAxis || ca->direction != cb->direction
+					|| ca->ratio != cb->ratio || ca->cos != cb->cos || ca->sin != cb->sin || ca->angle != cb->angle) return false;
+			}
+			else if (ga->faceType == "spline") {
+				auto* sa = static_cast<Info::SplineFaceGeometry*>(ga);
+				auto* sb = static_cast<Info::SplineFaceGeometry*>(gb);
+				if (sa->degreeU != sb->degreeU || sa->degreeV != sb->degreeV || sa->numU != sb->numU || sa->numV != sb->numV
+					|| sa->numKnotsU != sb->numKnotsU || sa->numKnotsV != sb->numKnotsV || sa->numWeightU != sb->numWeightU || sa->numWeightV != sb->numWeightV
+					|| sa->ctrlpts != sb->ctrlpts || sa->uknots != sb->uknots || sa->vknots != sb->vknots || sa->weights != sb->weights) return false;
+			}
+		}
+		return true;
+	}
+
+	// geometry json：专用解析器 vs nlohmann的SAX流式解析 vs 原来的整体DOM解析
+	// 峰值内存是进程的历史最大值，因此按内存占用从小到大的顺序测
+	void RunGeometryJson(const std::string& path, size_t size_mb) {
+		std::ifstream probe(path);
+		if (!probe.is_open()) {
+			std::cout << "Generating " << size_mb << " MB geometry json: " << path << std::endl;
+			GenerateGeometryJson(path, size_mb * 1024 * 1024);
+		}
+		probe.close();
+
+		size_t file_size = std::filesystem::file_size(path);
+		auto to_mb = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+
+		std::cout << "Geometry json " << path << " (" << to_mb(file_size) << " MB), RSS before: " << to_mb(Utils::CurrentRssBytes()) << " MB" << std::endl;
+
+		Info::SatInfo fast_info;
+		fast_info.useGeometryCache = false;
+		double fast_ms = TimeMs([&]() {
+			fast_info.LoadGeometryJson(path);
+		});
+		Report("fast", fast_ms, file_size);
+		std::cout << "    peak RSS: " << to_mb(Utils::PeakRssBytes()) << " MB, result RSS: " << to_mb(Utils::CurrentRssBytes()) << " MB"
+			<< ", edge geometry: " << to_mb(fast_info.brepInfo.edgeGeometries.MemoryBytes()) << " MB" << std::endl;
+
+		Info::SatInfo lazy_info;
+		lazy_info.useGeometryCache = false;
+		lazy_info.lazyEdgeProperties = true;
+		double lazy_ms = TimeMs([&]() {
+			lazy_info.LoadGeometryJson(path);
+		});
+		Report("fast, lazy edge properties", lazy_ms, file_size);
+		std::cout << "    edge geometry: " << to_mb(lazy_info.brepInfo.edgeGeometries.MemoryBytes()) << " MB" << std::endl;
+
+		Info::SatInfo sax_info;
+		sax_info.useGeometryCache = false;
+		sax_info.useFastGeometryJsonParser = false;
+		double sax_ms = TimeMs([&]() {
+			sax_info.LoadGeometryJson(path);
+		});
+		Report("sax", sax_ms, file_size);
+		std::cout << "    peak RSS: " << to_mb(Utils::PeakRssBytes()) << " MB" << std::endl;
+
+		Info::SatInfo dom_info;
+		double dom_ms = TimeMs([&]() {
+			dom_info.LoadGeometryJsonDom(path);
+		});
+		Report("dom", dom_ms, file_size);
+		std::cout << "    peak RSS: " << to_mb(Utils::PeakRssBytes()) << " MB" << std::endl;
+
+		std::cout << "  vertices: " << fast_info.brepInfo.vertexInfos.size() << ", edges: " << fast_info.brepInfo.edgeInfos.size()
+			<< ", half edges: " << fast_info.brepInfo.halfEdgeInfos.size() << ", loops: " << fast_info.brepInfo.loopInfos.size() << ", faces: " << fast_info.brepInfo.faceInfos.size()
+			<< ", fast vs sax: " << sax_ms / fast_ms << "x, identical: " << (SameBrepInfo(fast_info, sax_info) ? "yes" : "NO")
+			<< ", fast vs dom: " << dom_ms / fast_ms << "x, identical: " << (SameBrepInfo(fast_info, dom_info) ? "yes" : "NO") << std::endl;
+
+		// 比较时会逐条解码全部边的参数
+		double decode_ms = TimeMs([&]() {
+			std::cout << "  lazy vs fast: " << fast_ms / lazy_ms << "x, identical after decoding: " << (SameBrepInfo(lazy_info, fast_info) ? "yes" : "NO");
+		});
+		std::cout << ", decoding every edge one by one: " << decode_ms << " ms" << std::endl;
+	}
+
+	// geometry json：SAX解析 vs 读取二进制缓存（第一次解析时写出缓存）
+	void RunGeometryCache(const std::string& path, size_t size_mb) {
+		std::ifstream probe(path);
+		if (!probe.is_open()) {
+			std::cout << "Generating " << size_mb << " MB geometry json: " << path << std::endl;
+			GenerateGeometryJson(path, size_mb * 1024 * 1024);
+		}
+		probe.close();
+
+		std::error_code ec;
+		std::filesystem::remove(Info::GeometryCachePath(path), ec);
+
+		size_t file_size = std::filesystem::file_size(path);
+
+		Info::SatInfo parsed_info;
+		double parse_ms = TimeMs([&]() {
+			parsed_info.LoadGeometryJson(path); // 没有缓存：解析并写出缓存
+		});
+		Report("parse + write cache", parse_ms, file_size);
+
+		std::unique_ptr<Info::SatInfo> cached_info;
+		double cache_ms = std::numeric_limits<double>::max();
+		for (int i = 0; i < 3; i++) {
+			cached_info = std::make_unique<Info::SatInfo>(); // 上一次的结果在计时之外释放
+			cache_ms = std::min(cache_ms, TimeMs([&]() {
+				cached_info->LoadGeometryJson(path);
+			}));
+		}
+		std::cout << "  cache: " << cache_ms << " ms (" << std::filesystem::file_size(Info::GeometryCachePath(path)) / (1024.0 * 1024.0) << " MB)"
+			<< ", speedup: " << parse_ms / cache_ms << "x, identical: " << (SameBrepInfo(parsed_info, *cached_info) ? "yes" : "NO") << std::endl;
+	}
+
+	// geometry json：只读取一个body vs 读取全部body（生成的文件有GENERATED_BODY_COUNT个body）
+	// 峰值内存是进程的历史最大值，因此先测只读一个body的情况；之后再比较有缓存时的筛选
+	void RunGeometryBody(const std::string& path, size_t size_mb) {
+		std::ifstream probe(path);
+		if (!probe.is_open()) {
+			std::cout << "Generating " << size_mb << " MB geometry json: " << path << std::endl;
+			GenerateGeometryJson(path, size_mb * 1024 * 1024);
+		}
+		probe.close();
+
+		size_t file_size = std::filesystem::file_size(path);
+		auto to_mb = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+		const std::set<int> selected_bodies{ 1 };
+
+		std::cout << "Geometry json " << path << " (" << to_mb(file_size) << " MB), RSS before: " << to_mb(Utils::CurrentRssBytes()) << " MB" << std::endl;
+
+		Info::SatInfo one_info;
+		one_info.useGeometryCache = false;
+		double one_ms = TimeMs([&]() {
+			one_info.LoadGeometryJson(path, selected_bodies);
+		});
+		Report("body 1 only", one_ms, file_size);
+		std::cout << "    peak RSS: " << to_mb(Utils::PeakRssBytes()) << " MB, result RSS: " << to_mb(Utils::CurrentRssBytes()) << " MB"
+			<< ", edge geometry: " << to_mb(one_info.brepInfo.edgeGeometries.MemoryBytes()) << " MB" << std::endl;
+
+		Info::SatInfo all_info;
+		all_info.useGeometryCache = false;
+		double all_ms = TimeMs([&]() {
+			all_info.LoadGeometryJson(path);
+		});
+		Report("all bodies", all_ms, file_size);
+		std::cout << "    peak RSS: " << to_mb(Utils::PeakRssBytes()) << " MB, result RSS: " << to_mb(Utils::CurrentRssBytes()) << " MB"
+			<< ", edge geometry: " << to_mb(all_info.brepInfo.edgeGeometries.MemoryBytes()) << " MB" << std::endl;
+
+		// 同样的筛选用SAX、DOM和缓存得到的结果应当一致
+		Info::SatInfo sax_info;
+		sax_info.useGeometryCache = false;
+		sax_info.useFastGeometryJsonParser = false;
+		sax_info.LoadGeometryJson(path, selected_bodies);
+
+		Info::SatInfo dom_info;
+		dom_info.LoadGeometryJsonDom(path, selected_bodies);
+
+		std::error_code ec;
+		std::filesystem::remove(Info::GeometryCachePath(path), ec);
+		Info::SatInfo cache_writer;
+		cache_writer.LoadGeometryJson(path);
+		Info::SatInfo cached_info;
+		double cache_ms = TimeMs([&]() {
+			cached_info.LoadGeometryJson(path, selected_bodies);
+		});
+
+		std::cout << "  edges: " << one_info.brepInfo.edgeInfos.size() << " of " << all_info.brepInfo.edgeInfos.size()
+			<< ", speedup: " << all_ms / one_ms << "x, body 1 from cache: " << cache_ms << " ms"
+			<< ", identical to sax: " << (SameBrepInfo(one_info, sax_info) ? "yes" : "NO")
+			<< ", dom: " << (SameBrepInfo(one_info, dom_info) ? "yes" : "NO")
+			<< ", cache: " << (SameBrepInfo(one_info, cached_info) ? "yes" : "NO") << std::endl;
+	}
+
+	// 生成一个OBJ：若干个"o"物体，每个是一张起伏的规则网格曲面，直到文件大小达到target_bytes
+	// 其中穿插了"g"分组、空的组、四边形面、负数索引和 v/vt/vn 形式的面，用来检查分块解析在组边界和索引换算上与tinyobj一致
+	void GenerateObj(const std::string& path, size_t target_bytes) {
+		std::ofstream out(path, std::ios::binary);
+		if (!out.is_open()) {
+			throw std::runtime_error("Cannot create benchmark file: " + path);
+		}
+
+		const size_t object_count = 4;
+		const size_t bytes_per_vertex = 90; // 一个顶点行和两个三角形行大约的字节数
+		const size_t grid_n = static_cast<size_t>(std::sqrt(target_bytes / bytes_per_vertex / object_count)) + 2;
+
+		std::string text;
+		text.reserve((1 << 20) + 4096);
+		auto flush = [&](bool force) {
+			if (force || text.size() >= (1 << 20)) {
+				out.write(text.data(), text.size());
+				text.clear();
+			}
+		};
+
+		char line[128];
+		size_t vertex_base = 0;
+		text += "vt 0 0\nvn 0 0 1\n";
+		for (size_t object = 0; object < object_count; object++) {
+			text += "o bench_" + std::to_string(object) + "\n";
+			if (object == 1) {
+				text += "g empty_group\n";
+			}
+
+			for (size_t i = 0; i < grid_n; i++) {
+				for (size_t j = 0; j < grid_n; j++) {
+					float z = static_cast<float>(std::sin(i * 0.01) * std::cos(j * 0.013) * 10.0 + object * 50.0);
+					std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", float(i), float(j), z);
+					text += line;
+				}
+				flush(false);
+			}
+
+			for (size_t i = 0; i + 1 < grid_n; i++) {
+				if (i == grid_n / 2) {
+					text += "g half_" + std::to_string(object) + "\n";
+				}
+				for (size_t j = 0; j + 1 < grid_n; j++) {
+					size_t v00 = vertex_base + i * grid_n + j + 1;
+					size_t v10 = v00 + grid_n;
+					if (object == 2 && j % 7 == 0) {
+						std::snprintf(line, sizeof(line), "f %zu %zu %zu %zu\n", v00, v10, v10 + 1, v00 + 1);
+					}
+					else if (object == 3) {
+						long long total = static_cast<long long>(vertex_base + grid_n * grid_n);
+						std::snprintf(line, sizeof(line), "f %lld/1/1 %lld/1/1 %lld/1/1\nf %zu//1 %zu//1 %zu//1\n",
+							static_cast<long long>(v00) - total - 1, static_cast<long long>(v10) - total - 1, static_cast<long long>(v10 + 1) - total - 1, v00, v10 + 1, v00 + 1);
+					}
+					else {
+						std::snprintf(line, sizeof(line), "f %zu %zu %zu\nf %zu %zu %zu\n", v00, v10, v10 + 1, v00, v10 + 1, v00 + 1);
+					}
+					text += line;
+				}
+				flush(false);
+			}
+
+			vertex_base += grid_n * grid_n;
+		}
+
+		flush(true);
+	}
+
+	// OBJ：原来的tinyobj加载 vs 内存映射+分块并行解析
+	void RunObj(const std::string& path, size_t size_mb) {
+		std::ifstream probe(path);
+		if (!probe.is_open()) {
+			std::cout << "Generating " << size_mb << " MB OBJ: " << path << std::endl;
+			GenerateObj(path, size_mb * 1024 * 1024);
+		}
+		probe.close();
+
+		size_t file_size = std::filesystem::file_size(path);
+		auto to_mb = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+
+		std::cout << "OBJ " << path << " (" << to_mb(file_size) << " MB), threads: " << Utils::ThreadPool::GetInstance().ThreadCount() << std::endl;
+
+		Info::ObjInfo fast_info;
+		double fast_ms = TimeMs([&]() {
+			fast_info.LoadFromObj(path);
+		});
+		Report("mapped chunks", fast_ms, file_size);
+		std::cout << "    peak RSS: " << to_mb(Utils::PeakRssBytes()) << " MB" << std::endl;
+
+		Info::ObjInfo tinyobj_info;
+		double tinyobj_ms = TimeMs([&]() {
+			tinyobj_info.LoadFromObjTinyObj(path);
+		});
+		Report("tinyobj", tinyobj_ms, file_size);
+		std::cout << "    peak RSS: " << to_mb(Utils::PeakRssBytes()) << " MB" << std::endl;
+
+		bool same = fast_info.vertices == tinyobj_info.vertices && fast_info.indices == tinyobj_info.indices
+			&& fast_info.solidIndicesRange == tinyobj_info.solidIndicesRange;
+
+		std::cout << "  vertices: " << fast_info.vertices.size() / 3 << ", triangles: " << fast_info.indices.size() / 3 << ", solids: " << fast_info.solidIndicesRange.size()
+			<< ", speedup: " << tinyobj_ms / fast_ms << "x, identical: " << (same ? "yes" : "NO") << std::endl;
+	}
+
+	// 紧凑半边结构与ObjMarkNum的图是否一致：编号、边的端点和半边、半边的方向、partner、环
+	bool SameTopology(const Topology::HalfEdgeMesh& mesh, ObjMarkNum& marknum) {
+		if (marknum.Capacity(TopoType::Vertex) != mesh.VertexCount() || marknum.Capacity(TopoType::Edge) != mesh.EdgeCount()
+			|| marknum.Capacity(TopoType::HalfEdge) != mesh.HalfEdgeCount() || marknum.Capacity(TopoType::Face) != mesh.FaceCount()
+			|| static_cast<int>(marknum.solids.size()) != mesh.SolidCount() || marknum.edgesMap.size() != mesh.EdgeOrder().size()) {
+			return false;
+		}
+
+		// edgesMap按边的创建顺序遍历，第k项就是编号为k的边
+		int e = 0;
+		for (auto& edge_pair : marknum.edgesMap) {
+			const std::shared_ptr<Edge>& edge = edge_pair.second;
+			if (marknum.GetId(edge) != e || marknum.GetId(edge->st) != mesh.EdgeStart(e) || marknum.GetId(edge->ed) != mesh.EdgeEnd(e)
+				|| static_cast<int>(edge->halfEdges.size()) != mesh.EdgeHalfEdgeCount(e) || mesh.FindEdge(mesh.EdgeEnd(e), mesh.EdgeStart(e)) != e
+				|| mesh.FindEdge(Topology::EdgeHashMap<int>::KeyMin(edge_pair.first), Topology::EdgeHashMap<int>::KeyMax(edge_pair.first)) != e
+				|| marknum.FindEdgeBetweenVertices(edge->ed, edge->st) != edge) {
+				return false;
+			}
+
+			for (auto& half_edge : edge->halfEdges) {
+				int he = marknum.GetId(half_edge);
+				if (mesh.HalfEdgeEdge(he) != e || mesh.HalfEdgeSense(he) != half_edge->sense || marknum.GetId(half_edge->partner) != mesh.HalfEdgePartner(he)
+					|| marknum.GetId(half_edge->next) != mesh.HalfEdgeNext(he) || marknum.GetId(half_edge->pre) != mesh.HalfEdgePre(he)
+					|| marknum.GetId(half_edge->loop) != mesh.HalfEdgeLoop(he) || marknum.GetId(half_edge->loop->face) != mesh.LoopFace(mesh.HalfEdgeLoop(he))
+					|| marknum.GetId(half_edge->loop->face->solid) != mesh.FaceSolid(mesh.LoopFace(mesh.HalfEdgeLoop(he)))) {
+					return false;
+				}
+			}
+			e++;
+		}
+		return true;
+	}
+
+	// OBJ的拓扑：紧凑半边结构 vs 原来ObjMarkNum中由shared_ptr连接的图
+	// 内存按建立前后常驻内存的差计算（先建紧凑结构，它的临时数组释放后可能被ObjMarkNum复用，对ObjMarkNum有利）
+	void RunTopology(const std::string& path, size_t size_mb) {
+		std::ifstream probe(path);
+		if (!probe.is_open()) {
+			std::cout << "Generating " << size_mb << " MB OBJ: " << path << std::endl;
+			GenerateObj(path, size_mb * 1024 * 1024);
+		}
+		probe.close();
+
+		auto to_mb = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+
+		Info::ObjInfo obj_info;
+		obj_info.LoadFromObj(path);
+		size_t triangle_count = obj_info.indices.size() / 3;
+
+		std::cout << "OBJ " << path << ": " << triangle_count << " triangles, threads: " << Utils::ThreadPool::GetInstance().ThreadCount() << std::endl;
+
+		Topology::HalfEdgeMesh mesh;
+		size_t rss_before = Utils::CurrentRssBytes();
+		double mesh_ms = TimeMs([&]() {
+			mesh.Build(obj_info);
+		});
+		size_t mesh_bytes = Utils::CurrentRssBytes() - std::min(rss_before, Utils::CurrentRssBytes());
+		std::cout << "  half edge mesh: " << mesh_ms << " ms, RSS +" << to_mb(mesh_bytes) << " MB (" << static_cast<double>(mesh_bytes) / triangle_count << " bytes per triangle)"
+			<< ", arrays: " << static_cast<double>(mesh.MemoryBytes()) / triangle_count << " bytes per triangle" << std::endl;
+
+		// 每个半边反方向查找一次边
+		int found = 0;
+		double find_ms = TimeMs([&]() {
+			for (int he = 0; he < mesh.HalfEdgeCount(); he++) {
+				found += mesh.FindEdge(mesh.HalfEdgeEnd(he), mesh.HalfEdgeStart(he)) == mesh.HalfEdgeEdge(he);
+			}
+		});
+		std::cout << "  FindEdge: " << find_ms * 1e6 / std::max(mesh.HalfEdgeCount(), 1) << " ns per lookup, found: " << (found == mesh.HalfEdgeCount() ? "all" : "NOT ALL") << std::endl;
+
+		ObjMarkNum& marknum = ObjMarkNum::GetInstance();
+		rss_before = Utils::CurrentRssBytes();
+		double marknum_ms = TimeMs([&]() {
+			marknum.LoadFromObjInfo(obj_info);
+		});
+		size_t marknum_bytes = Utils::CurrentRssBytes() - std::min(rss_before, Utils::CurrentRssBytes());
+		std::cout << "  ObjMarkNum: " << marknum_ms << " ms, RSS +" << to_mb(marknum_bytes) << " MB (" << static_cast<double>(marknum_bytes) / triangle_count << " bytes per triangle)" << std::endl;
+
+		std::cout << "  vertices: " << mesh.VertexCount() << ", edges: " << mesh.EdgeCount() << ", solids: " << mesh.SolidCount()
+			<< ", build speedup: " << marknum_ms / mesh_ms << "x, memory: " << static_cast<double>(marknum_bytes) / std::max<size_t>(mesh_bytes, 1) << "x"
+			<< ", identical: " << (SameTopology(mesh, marknum) ? "yes" : "NO") << std::endl;
+
+		marknum.Clear();
+	}
+
+	// 由两个顶点查找边：开放寻址的EdgeHashMap vs 原来ObjMarkNum中的std::map<std::pair<int, int>, ...>
+	// 按ObjMarkNum的用法：建立时每条半边查找一次、不存在时插入（原来的写法是find之后再用operator[]插入），之后按反方向逐条查找（FindEdgeBetweenVertices）
+	void RunEdgeHash(const std::string& path, size_t size_mb) {
+		std::ifstream probe(path);
+		if (!probe.is_open()) {
+			std::cout << "Generating " << size_mb << " MB OBJ: " << path << std::endl;
+			GenerateObj(path, size_mb * 1024 * 1024);
+		}
+		probe.close();
+
+		auto to_mb = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+
+		Info::ObjInfo obj_info;
+		obj_info.LoadFromObj(path);
+		size_t triangle_count = obj_info.indices.size() / 3;
+		const std::vector<int>& indices = obj_info.indices;
+
+		std::cout << "OBJ " << path << ": " << triangle_count << " triangles" << std::endl;
+
+		std::map<std::pair<int, int>, int> edge_tree;
+		size_t rss_before = Utils::CurrentRssBytes();
+		double tree_build_ms = TimeMs([&]() {
+			for (size_t t = 0; t < triangle_count; t++) {
+				for (int k = 0; k < 3; k++) {
+					int i = indices[t * 3 + k];
+					int j = indices[t * 3 + (k + 1) % 3];
+					std::pair<int, int> key = std::minmax(i, j);
+					if (edge_tree.find(key) == edge_tree.end()) {
+						int e = static_cast<int>(edge_tree.size());
+						edge_tree[key] = e;
+					}
+				}
+			}
+		});
+		size_t tree_bytes = Utils::CurrentRssBytes() - std::min(rss_before, Utils::CurrentRssBytes());
+
+		int tree_found = 0;
+		double tree_find_ms = TimeMs([&]() {
+			for (size_t t = 0; t < triangle_count; t++) {
+				for (int k = 0; k < 3; k++) {
+					int i = indices[t * 3 + (k + 1) % 3];
+					int j = indices[t * 3 + k];
+					if (auto it = edge_tree.find({ i, j }); it != edge_tree.end()) {
+						tree_found += it->second >= 0;
+					}
+					else if (auto it2 = edge_tree.find({ j, i }); it2 != edge_tree.end()) {
+						tree_found += it2->second >= 0;
+					}
+				}
+			}
+		});
+
+		Topology::EdgeHashMap<int> edge_hash;
+		rss_before = Utils::CurrentRssBytes();
+		double hash_build_ms = TimeMs([&]() {
+			edge_hash.Reserve(triangle_count * 3 / 2 + 1);
+			for (size_t t = 0; t < triangle_count; t++) {
+				for (int k = 0; k < 3; k++) {
+					auto [e, inserted] = edge_hash.TryEmplace(indices[t * 3 + k], indices[t * 3 + (k + 1) % 3]);
+					if (inserted) {
+						e = static_cast<int>(edge_hash.size()) - 1;
+					}
+				}
+			}
+		});
+		size_t hash_bytes = Utils::CurrentRssBytes() - std::min(rss_before, Utils::CurrentRssBytes());
+
+		int hash_found = 0;
+		double hash_find_ms = TimeMs([&]() {
+			for (size_t t = 0; t < triangle_count; t++) {
+				for (int k = 0; k < 3; k++) {
+					if (const int* e = edge_hash.Find(indices[t * 3 + (k + 1) % 3], indices[t * 3 + k])) {
+						hash_found += *e >= 0;
+					}
+				}
+			}
+		});
+
+		std::cout << "  std::map: build " << tree_build_ms << " ms, find " << tree_find_ms << " ms, RSS +" << to_mb(tree_bytes) << " MB ("
+			<< static_cast<double>(tree_bytes) / std::max<size_t>(edge_tree.size(), 1) << " bytes per edge)" << std::endl;
+		std::cout << "  EdgeHashMap: build " << hash_build_ms << " ms, find " << hash_find_ms << " ms, RSS +" << to_mb(hash_bytes) << " MB ("
+			<< static_cast<double>(hash_bytes) / std::max<size_t>(edge_hash.size(), 1) << " bytes per edge), arrays: "
+			<< static_cast<double>(edge_hash.MemoryBytes()) / std::max<size_t>(edge_hash.size(), 1) << " bytes per edge" << std::endl;
+
+		// 同样的边和编号；哈希表按插入顺序遍历，第e项的编号就是e
+		bool same = edge_tree.size() == edge_hash.size() && tree_found == hash_found;
+		int e = 0;
+		for (auto& entry : edge_hash) {
+			auto it = edge_tree.find({ Topology::EdgeHashMap<int>::KeyMin(entry.first), Topology::EdgeHashMap<int>::KeyMax(entry.first) });
+			same = same && entry.second == e && it != edge_tree.end() && it->second == e;
+			e++;
+		}
+
+		std::cout << "  edges: " << edge_hash.size() << ", build speedup: " << tree_build_ms / hash_build_ms << "x, find speedup: " << tree_find_ms / hash_find_ms
+			<< "x, memory: " << static_cast<double>(tree_bytes) / std::max<size_t>(hash_bytes, 1) << "x, identical: " << (same ? "yes" : "NO") << std::endl;
+	}
+
+	// 按名字运行，返回值作为进程返回值
+	int Run(const std::string& name, const std::string& path, size_t size_mb) {
+		if (name == "stl_ascii") {
+			RunStlAscii(path.empty() ? "bench_ascii.stl" : path, size_mb);
+		}
+		else if (name == "geometry_json") {
+			RunGeometryJson(path.empty() ? "bench_geometry.json" : path, size_mb);
+		}
+		else if (name == "geometry_cache") {
+			RunGeometryCache(path.empty() ? "bench_geometry.json" : path, size_mb);
+		}
+		else if (name == "geometry_body") {
+			RunGeometryBody(path.empty() ? "bench_geometry.json" : path, size_mb);
+		}
+		else if (name == "obj") {
+			RunObj(path.empty() ? "bench.obj" : path, size_mb);
+		}
+		else if (name == "topology") {
+			RunTopology(path.empty() ? "bench.obj" : path, size_mb);
+		}
+		else if (name == "edge_hash") {
+			RunEdgeHash(path.empty() ? "bench.obj" : path, size_mb);
+		}
+		else if (name == "normals") {
+			RunNormals(size_mb);
+		}
+		else {
+			std::cout << "Unknown benchmark: " << name << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+}
@@ -21,6 +21,7 @@
 #include "json.hpp"
 
 #include "TopologyInfo.hpp"
+#include "JsonFields.hpp"
 
 
 namespace Info {
@@ -42,28 +43,28 @@ namespace Info {
 		}
 
 		void _LoadCellBoxes(const json& data) {
-			auto cell_boxes = data["cell_boxes"];
+			const json& cell_boxes = Utils::GetJsonRecords(data, "cell_boxes");
 			things.cellBoxInfos.reserve(cell_boxes.size());
-			for (auto&& element : cell_boxes) {
-				try {
-
-					int id = element.at("id");
 
-					float min_x = element.at("min_x");
-					float min_y = element.at("min_y");
-					float min_z = element.at("min_z");
+			Utils::FieldFailures failures;
+			for (auto&& element : cell_boxes) {
+				int id = 0;
+				glm::vec3 min_pos;
+				glm::vec3 max_pos;
 
-					float max_x = element.at("max_x");
-					float max_y = element.at("max_y");
-					float max_z = element.at("max_z");
+				bool ok = true;
+				ok &= Utils::GetJsonNumber(element, "id", id, failures);
+				ok &= Utils::GetJsonVec3(element, "min_x", "min_y", "min_z", min_pos, failures);
+				ok &= Utils::GetJsonVec3(element, "max_x", "max_y", "max_z", max_pos, failures);
 
-					things.cellBoxInfos.push_back({ id, glm::vec3{min_x, min_y, min_z}, glm::vec3{max_x, max_y, max_z } });
+				if (ok) {
+					things.cellBoxInfos.push_back({ id, min_pos, max_pos });
 				}
-				catch (json::out_of_range& e) {
-					SPDLOG_INFO("Cell Box load failed");
+				else {
+					failures.failedRecords++;
 				}
 			}
-
+			failures.Log("Cell boxes", cell_boxes.size());
 		}
 	};
 
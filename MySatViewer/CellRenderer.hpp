@@ -43,7 +43,7 @@ namespace MyRenderEngine {
 
 			shader->setVec3("subcolor", color);
 			glBindVertexArray(lineVAO);
-			glDrawArrays(GL_LINES, 0, lines.size() / 3); // һǶͼԪ
+			glDrawArrays(GL_LINES, 0, lines.size() / 3); // 最后一个参数是顶点个数（而非图元个数）
 			glBindVertexArray(0);
 		}
 
@@ -56,7 +56,7 @@ namespace MyRenderEngine {
 
 			for (auto&& one_box_info : cellInfo.things.cellBoxInfos) {
 
-				// 12 
+				// 12 条线
 
 				// l1
 				lines.emplace_back(one_box_info.min_point[0]);
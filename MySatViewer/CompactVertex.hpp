@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "ThreadPool.hpp"
+#include "GeometryKernels.hpp"
+
+/*
+	紧凑顶点格式
+	坐标：按模型包围盒量化为3个16位无符号整数（第4个分量补齐到8字节）
+	法向：八面体编码后量化为2个16位有符号整数
+	每个顶点12字节（原来坐标+法向共24字节），只有坐标时8字节（原来12字节）
+	着色器中的解码见 stlShader.vs / objShader.vs 的 compactVertices 分支
+*/
+
+namespace Utils {
+
+	struct CompactVertex {
+		uint16_t position[4];
+		int16_t normal[2];
+	};
+
+	struct CompactPosition {
+		uint16_t position[4];
+	};
+
+	static_assert(sizeof(CompactVertex) == 12, "CompactVertex must be 12 bytes");
+	static_assert(sizeof(CompactPosition) == 8, "CompactPosition must be 8 bytes");
+
+	// 量化用的包围盒：解码时 position = min + q / 65535 * extent
+	struct QuantizationBox {
+		glm::vec3 min{ 0.0f };
+		glm::vec3 extent{ 1.0f };
+	};
+
+	// 由包围盒得到量化参数
+	QuantizationBox QuantizationBoxFromBounds(const glm::vec3& min_pos, const glm::vec3& max_pos) {
+		QuantizationBox box;
+		if (!(min_pos.x <= max_pos.x && min_pos.y <= max_pos.y && min_pos.z <= max_pos.z)) {
+			return box; // 没有顶点
+		}
+
+		box.min = min_pos;
+		box.extent = max_pos - min_pos;
+		for (int k = 0; k < 3; k++) {
+			if (box.extent[k] <= 0.0f) {
+				box.extent[k] = 1.0f; // 退化的轴：所有坐标都量化为0
+			}
+		}
+		return box;
+	}
+
+	// 计算count个顶点（每个顶点stride个float，前3个为坐标）的包围盒
+	QuantizationBox ComputeQuantizationBox(const float* vertices, size_t count, size_t stride) {
+		GeometryKernels::Bounds bounds = GeometryKernels::ParallelPointBounds(vertices, count, stride);
+		return QuantizationBoxFromBounds(bounds.min, bounds.max);
+	}
+
+	uint16_t QuantizeUnorm16(float v) {
+		v = std::min(std::max(v, 0.0f), 1.0f);
+		return static_cast<uint16_t>(std::lround(v * 65535.0f));
+	}
+
+	int16_t QuantizeSnorm16(float v) {
+		v = std::min(std::max(v, -1.0f), 1.0f);
+		return static_cast<int16_t>(std::lround(v * 32767.0f));
+	}
+
+	// 八面体编码：把单位球面投影到八面体上再展开到 [-1, 1]^2，零向量编码为 (0, 0)（解码为 +z）
+	void OctEncode(const glm::vec3& n, int16_t out[2]) {
+		float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+		if (l1 <= 0.0f || !std::isfinite(l1)) {
+			out[0] = out[1] = 0;
+			return;
+		}
+
+		float x = n.x / l1;
+		float y = n.y / l1;
+		if (n.z < 0.0f) {
+			float ox = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			float oy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = ox;
+			y = oy;
+		}
+
+		out[0] = QuantizeSnorm16(x);
+		out[1] = QuantizeSnorm16(y);
+	}
+
+	// 与着色器中的解码一致，用于检查误差
+	glm::vec3 OctDecode(const int16_t in[2]) {
+		float x = std::max(in[0] / 32767.0f, -1.0f);
+		float y = std::max(in[1] / 32767.0f, -1.0f);
+		glm::vec3 n{ x, y, 1.0f - std::fabs(x) - std::fabs(y) };
+		if (n.z < 0.0f) {
+			float ox = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			float oy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			n.x = ox;
+			n.y = oy;
+		}
+		return glm::normalize(n);
+	}
+
+	void QuantizePosition(const float* p, const QuantizationBox& box, uint16_t out[4]) {
+		for (int k = 0; k < 3; k++) {
+			out[k] = QuantizeUnorm16((p[k] - box.min[k]) / box.extent[k]);
+		}
+		out[3] = 0;
+	}
+
+	// vertices：每个顶点6个float（坐标3个 + 法向3个）
+	std::vector<CompactVertex> EncodeCompactVertices(const float* vertices, size_t count, const QuantizationBox& box) {
+		std::vector<CompactVertex> res(count);
+
+		ThreadPool::GetInstance().ParallelFor(count, [&](size_t begin, size_t end, size_t) {
+			for (size_t i = begin; i < end; i++) {
+				const float* v = vertices + i * 6;
+				QuantizePosition(v, box, res[i].position);
+				OctEncode(glm::vec3{ v[3], v[4], v[5] }, res[i].normal);
+			}
+		});
+
+		return res;
+	}
+
+	// coords：每个顶点3个float
+	std::vector<CompactPosition> EncodeCompactPositions(const float* coords, size_t count, const QuantizationBox& box) {
+		std::vector<CompactPosition> res(count);
+
+		ThreadPool::GetInstance().ParallelFor(count, [&](size_t begin, size_t end, size_t) {
+			for (size_t i = begin; i < end; i++) {
+				QuantizePosition(coords + i * 3, box, res[i].position);
+			}
+		});
+
+		return res;
+	}
+}
@@ -34,7 +34,7 @@ namespace MyRenderEngine {
 						ImGui::Text("Color: (%f, %f, %f)", point_info.color.x, point_info.color.y, point_info.color.z);
 
 						if (ImGui::Button("GO")) {
-							// λõ¼
+							// 设置相机位置的事件
 
 							EventSystem::SetCameraPosEvent e{ point_info.pos };
 							EventSystem::Dispatcher::GetInstance().Dispatch(e);
@@ -22,6 +22,7 @@
 
 
 #include "TopologyInfo.hpp"
+#include "JsonFields.hpp"
 
 
 
@@ -47,28 +48,30 @@ namespace Info {
 		void _LoadDebugShowPoints(const json& data) {
 
 
-			auto debug_points = data["debug_points"];
+			const json& debug_points = Utils::GetJsonRecords(data, "debug_points");
 
 			things.pointInfos.reserve(debug_points.size());
 
+			Utils::FieldFailures failures;
 			for (auto&& element: debug_points) {
+				std::string name;
+				glm::vec3 pos;
 
-				try {
-					std::string name = element.at("name");
-					float x = element.at("x");
-					float y = element.at("y");
-					float z = element.at("z");
+				bool ok = true;
+				ok &= Utils::GetJsonString(element, "name", name, failures);
+				ok &= Utils::GetJsonVec3(element, "x", "y", "z", pos, failures);
 
-					// TEMP: color 
-					glm::vec3 color = (name.length() < 4) ? (glm::vec3{ 1.0f, 0.0f, 0.0f }) : (glm::vec3{ 0.0f, 1.0f, 0.0f });
-
-					things.pointInfos.push_back({ name, glm::vec3{x, y, z},  color});
-				}
-				catch (std::exception& e) {
-					SPDLOG_INFO("DebugShowPoints load failed");
+				if (!ok) {
+					failures.failedRecords++;
+					continue;
 				}
 
+				// TEMP: color 
+				glm::vec3 color = (name.length() < 4) ? (glm::vec3{ 1.0f, 0.0f, 0.0f }) : (glm::vec3{ 0.0f, 1.0f, 0.0f });
+
+				things.pointInfos.push_back({ name, pos,  color});
 			}
+			failures.Log("DebugShow points", debug_points.size());
 		}
 
 	};
@@ -46,11 +46,11 @@ namespace MyRenderEngine {
 			glBindBuffer(GL_ARRAY_BUFFER, VBO);
 			glBufferData(GL_ARRAY_BUFFER, sizeof(float) * points_with_color.size(), points_with_color.data(), GL_STATIC_DRAW);
 
-			// ԣpos
+			// 属性：pos
 			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
 			glEnableVertexAttribArray(0);
 
-			// ԣcolor
+			// 属性：color
 			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
 			glEnableVertexAttribArray(1);
 
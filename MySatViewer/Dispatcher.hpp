@@ -11,9 +11,9 @@
 #include <iostream>
 
 /*
-	¼ַ
-	ڷַ¼
-	οhttps://zhuanlan.zhihu.com/p/535574136
+	事件分发器
+	用于分发事件
+	参考：https://zhuanlan.zhihu.com/p/535574136
 */
 
 namespace EventSystem {
@@ -22,12 +22,12 @@ namespace EventSystem {
 
 	public:
 
-		Dispatcher(const Dispatcher&) = delete; // ֹ
-		Dispatcher& operator=(const Dispatcher&) = delete; // ֵֹ
+		Dispatcher(const Dispatcher&) = delete; // 禁止拷贝构造
+		Dispatcher& operator=(const Dispatcher&) = delete; // 禁止拷贝赋值
 
 
 
-		// 
+		// 单例
 		static Dispatcher& GetInstance() {
 			static Dispatcher instance;
 			return instance;
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/*
+	边几何的列式存储
+	用途：所有边的几何放在同一张表中，每条边一行（EdgeInfo::geometryIndex为行号）。曲线类型是一列枚举，各类型的参数各自一张表，
+	所有边的采样点连续地放在一个数组中、按偏移量划分，这样加载时不需要为每条边分配内存，渲染时可以把采样点整体上传
+	追加一行的方式：先把该行的采样点（intcurve还有控制点）追加到对应数组末尾，再调用AddRow；中途失败时调用DiscardPending丢弃
+	延迟解码：straight/ellipse/intcurve的行可以先不读参数（参数下标为PARAMS_PENDING），只记下该边的记录在json中的字节范围，
+		用到时由SatInfo::DecodeEdgeGeometry重新解析这一条记录后调用SetParams补上
+*/
+
+namespace Info {
+
+	enum class CurveType : uint8_t {
+		OTHER, // 没有单独处理的类型，名字记在otherCurveTypes中
+		STRAIGHT,
+		ELLIPSE,
+		INTCURVE,
+	};
+
+	CurveType CurveTypeFromName(const std::string& name) {
+		if (name == "straight") return CurveType::STRAIGHT;
+		if (name == "ellipse") return CurveType::ELLIPSE;
+		if (name == "intcurve") return CurveType::INTCURVE;
+		return CurveType::OTHER;
+	}
+
+	struct StraightCurveParams {
+		glm::vec3 rootPoint;
+		glm::vec3 direction;
+	};
+
+	struct EllipseCurveParams {
+		glm::vec3 centre;
+		glm::vec3 normal;
+		glm::vec3 majorAxis;
+
+		double majorAxisLength;
+		double minorAxisLength;
+	};
+
+	struct EdgeGeometryTable {
+		static constexpr int PARAMS_PENDING = -1; // 参数还没有读取（延迟解码）
+		static constexpr int PARAMS_FAILED = -2; // 延迟解码时读取失败
+
+		// 每行一个元素
+		std::vector<CurveType> curveTypes;
+		std::vector<int> paramIndices; // 在对应类型参数表中的下标：straights / ellipses / intcurve控制点的分段 / otherCurveTypes
+		std::vector<uint32_t> pointOffsets{ 0 }; // 行数+1个，第i行的采样点为 sampledPoints[pointOffsets[i], pointOffsets[i + 1])
+		std::vector<uint64_t> recordOffsets; // 延迟解码时每行一个：该边的记录在json中的起始字节；全部参数都已读取时为空
+		std::vector<uint32_t> recordSizes; // 与recordOffsets对应的记录长度
+
+		std::vector<glm::vec3> sampledPoints;
+
+		// 各类型的参数表
+		std::vector<StraightCurveParams> straights;
+		std::vector<EllipseCurveParams> ellipses;
+		std::vector<uint32_t> intcurveCtrlptOffsets{ 0 }; // intcurve个数+1个
+		std::vector<glm::vec3> intcurveCtrlpts;
+		std::vector<std::string> otherCurveTypes; // 不重复
+
+		size_t Size() const {
+			return curveTypes.size();
+		}
+
+		void Clear() {
+			*this = EdgeGeometryTable();
+		}
+
+		// 追加一行，该行的采样点是上一行之后追加到sampledPoints中的全部点。返回行号
+		int AddRow(CurveType curve_type, int param_index) {
+			curveTypes.push_back(curve_type);
+			paramIndices.push_back(param_index);
+			pointOffsets.push_back(static_cast<uint32_t>(sampledPoints.size()));
+			return static_cast<int>(curveTypes.size()) - 1;
+		}
+
+		// 延迟解码时在AddRow之后调用，记下该行的记录在json中的范围
+		void AddRecordRange(uint64_t offset, uint32_t size) {
+			recordOffsets.push_back(offset);
+			recordSizes.push_back(size);
+		}
+
+		bool ParamsPending(int row) const {
+			return paramIndices[row] == PARAMS_PENDING && curveTypes[row] != CurveType::OTHER;
+		}
+
+		bool ParamsFailed(int row) const {
+			return paramIndices[row] == PARAMS_FAILED;
+		}
+
+		// 延迟解码：把decoded第0行的参数追加到参数表中，作为第row行的参数（采样点已经在表中，不再拷贝）
+		void SetParams(int row, const EdgeGeometryTable& decoded) {
+			switch (curveTypes[row]) {
+			case CurveType::STRAIGHT:
+				straights.push_back(decoded.Straight(0));
+				paramIndices[row] = static_cast<int>(straights.size()) - 1;
+				break;
+			case CurveType::ELLIPSE:
+				ellipses.push_back(decoded.Ellipse(0));
+				paramIndices[row] = static_cast<int>(ellipses.size()) - 1;
+				break;
+			case CurveType::INTCURVE:
+				intcurveCtrlpts.insert(intcurveCtrlpts.end(), decoded.IntcurveCtrlpts(0), decoded.IntcurveCtrlpts(0) + decoded.IntcurveCtrlptCount(0));
+				paramIndices[row] = AddIntcurveCtrlpts();
+				break;
+			default:
+				break;
+			}
+		}
+
+		// 上一个intcurve之后追加到intcurveCtrlpts中的点作为一个intcurve的控制点，返回参数下标
+		int AddIntcurveCtrlpts() {
+			intcurveCtrlptOffsets.push_back(static_cast<uint32_t>(intcurveCtrlpts.size()));
+			return static_cast<int>(intcurveCtrlptOffsets.size()) - 2;
+		}
+
+		int AddOtherCurveType(const std::string& name) {
+			for (size_t i = 0; i < otherCurveTypes.size(); i++) {
+				if (otherCurveTypes[i] == name) {
+					return static_cast<int>(i);
+				}
+			}
+			otherCurveTypes.push_back(name);
+			return static_cast<int>(otherCurveTypes.size()) - 1;
+		}
+
+		// 丢弃还没有归属到某一行的采样点和控制点
+		void DiscardPending() {
+			sampledPoints.resize(pointOffsets.back());
+			intcurveCtrlpts.resize(intcurveCtrlptOffsets.back());
+		}
+
+		// 把other的所有行接到后面，返回other第0行在这里的行号
+		int Append(const EdgeGeometryTable& other) {
+			int row_base = static_cast<int>(Size());
+			uint32_t point_base = pointOffsets.back();
+			int straight_base = static_cast<int>(straights.size());
+			int ellipse_base = static_cast<int>(ellipses.size());
+			int intcurve_base = static_cast<int>(intcurveCtrlptOffsets.size()) - 1;
+			uint32_t ctrlpt_base = intcurveCtrlptOffsets.back();
+
+			std::vector<int> other_names(other.otherCurveTypes.size());
+			for (size_t i = 0; i < other.otherCurveTypes.size(); i++) {
+				other_names[i] = AddOtherCurveType(other.otherCurveTypes[i]);
+			}
+
+			for (size_t i = 0; i < other.Size(); i++) {
+				int param_index = other.paramIndices[i];
+				if (param_index >= 0) { // 还没有读取的参数保持原样
+					switch (other.curveTypes[i]) {
+					case CurveType::STRAIGHT: param_index += straight_base; break;
+					case CurveType::ELLIPSE: param_index += ellipse_base; break;
+					case CurveType::INTCURVE: param_index += intcurve_base; break;
+					case CurveType::OTHER: param_index = other_names[param_index]; break;
+					}
+				}
+				curveTypes.push_back(other.curveTypes[i]);
+				paramIndices.push_back(param_index);
+				pointOffsets.push_back(other.pointOffsets[i + 1] + point_base);
+			}
+
+			for (size_t i = 1; i < other.intcurveCtrlptOffsets.size(); i++) {
+				intcurveCtrlptOffsets.push_back(other.intcurveCtrlptOffsets[i] + ctrlpt_base);
+			}
+
+			sampledPoints.insert(sampledPoints.end(), other.sampledPoints.begin(), other.sampledPoints.begin() + other.pointOffsets.back());
+			straights.insert(straights.end(), other.straights.begin(), other.straights.end());
+			ellipses.insert(ellipses.end(), other.ellipses.begin(), other.ellipses.end());
+			intcurveCtrlpts.insert(intcurveCtrlpts.end(), other.intcurveCtrlpts.begin(), other.intcurveCtrlpts.begin() + other.intcurveCtrlptOffsets.back());
+			recordOffsets.insert(recordOffsets.end(), other.recordOffsets.begin(), other.recordOffsets.end());
+			recordSizes.insert(recordSizes.end(), other.recordSizes.begin(), other.recordSizes.end());
+
+			return row_base;
+		}
+
+		const std::string& CurveTypeName(int row) const {
+			static const std::string names[] = { "", "straight", "ellipse", "intcurve" };
+			if (curveTypes[row] == CurveType::OTHER) {
+				return otherCurveTypes[paramIndices[row]];
+			}
+			return names[static_cast<int>(curveTypes[row])];
+		}
+
+		const glm::vec3* Points(int row) const {
+			return sampledPoints.data() + pointOffsets[row];
+		}
+
+		size_t PointCount(int row) const {
+			return pointOffsets[row + 1] - pointOffsets[row];
+		}
+
+		// 以下只能用于对应类型的行
+		const StraightCurveParams& Straight(int row) const {
+			return straights[paramIndices[row]];
+		}
+
+		const EllipseCurveParams& Ellipse(int row) const {
+			return ellipses[paramIndices[row]];
+		}
+
+		const glm::vec3* IntcurveCtrlpts(int row) const {
+			return intcurveCtrlpts.data() + intcurveCtrlptOffsets[paramIndices[row]];
+		}
+
+		size_t IntcurveCtrlptCount(int row) const {
+			int i = paramIndices[row];
+			return intcurveCtrlptOffsets[i + 1] - intcurveCtrlptOffsets[i];
+		}
+
+		// 占用的堆内存（按容量计）
+		size_t MemoryBytes() const {
+			size_t bytes = curveTypes.capacity() * sizeof(CurveType) + paramIndices.capacity() * sizeof(int) + pointOffsets.capacity() * sizeof(uint32_t)
+				+ sampledPoints.capacity() * sizeof(glm::vec3) + straights.capacity() * sizeof(StraightCurveParams) + ellipses.capacity() * sizeof(EllipseCurveParams)
+				+ intcurveCtrlptOffsets.capacity() * sizeof(uint32_t) + intcurveCtrlpts.capacity() * sizeof(glm::vec3)
+				+ recordOffsets.capacity() * sizeof(uint64_t) + recordSizes.capacity() * sizeof(uint32_t);
+			for (auto& name : otherCurveTypes) {
+				bytes += sizeof(std::string) + name.capacity();
+			}
+			return bytes;
+		}
+	};
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+/*
+	由两个顶点下标查找边的开放寻址哈希表
+	用途：代替ObjMarkNum中的std::map<std::pair<int, int>, ...>，建立拓扑时每个三角形要查三次
+	键为（较小的顶点下标，较大的顶点下标）压成的64位整数，因此查找与两个顶点的顺序无关
+	槽位只存键和条目下标（线性探测，容量为2的幂，负载不超过1/2）；值按插入顺序存放在连续数组中
+	遍历顺序就是插入顺序，与哈希函数和容量无关，同样的输入每次得到同样的顺序
+*/
+
+namespace Topology {
+
+	template<typename Value>
+	class EdgeHashMap {
+	public:
+		using Entry = std::pair<uint64_t, Value>;
+
+		static uint64_t Key(int v1, int v2) {
+			uint32_t a = static_cast<uint32_t>(v1);
+			uint32_t b = static_cast<uint32_t>(v2);
+			if (a > b) {
+				std::swap(a, b);
+			}
+			return (static_cast<uint64_t>(a) << 32) | b;
+		}
+
+		static int KeyMin(uint64_t key) {
+			return static_cast<int>(key >> 32);
+		}
+
+		static int KeyMax(uint64_t key) {
+			return static_cast<int>(key & 0xffffffffu);
+		}
+
+		// 预留count个条目，插入不超过count个条目时不会重新散列
+		void Reserve(size_t count) {
+			entries.reserve(count);
+			size_t capacity = MIN_CAPACITY;
+			while (capacity < count * 2) {
+				capacity <<= 1;
+			}
+			if (capacity > slotKeys.size()) {
+				_Rehash(capacity);
+			}
+		}
+
+		// 预取(v1, v2)所在的槽位：按顺序逐个插入时，提前若干个键预取，可以把随机访问的缓存缺失重叠起来
+		void Prefetch(int v1, int v2) const {
+			if (!slotKeys.empty()) {
+				size_t slot = _HomeSlot(Key(v1, v2));
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+				_mm_prefetch(reinterpret_cast<const char*>(slotKeys.data() + slot), _MM_HINT_T0);
+				_mm_prefetch(reinterpret_cast<const char*>(slotEntries.data() + slot), _MM_HINT_T0);
+#elif defined(__GNUC__)
+				__builtin_prefetch(slotKeys.data() + slot);
+				__builtin_prefetch(slotEntries.data() + slot);
+#else
+				(void)slot; // 其他编译器（如ARM64上的MSVC）不预取，只影响速度
+#endif
+			}
+		}
+
+		// 不存在时返回nullptr；返回的指针在下一次插入前有效
+		Value* Find(int v1, int v2) {
+			size_t slot = _FindSlot(Key(v1, v2));
+			return slotKeys.empty() || slotKeys[slot] == EMPTY_KEY ? nullptr : &entries[slotEntries[slot]].second;
+		}
+
+		const Value* Find(int v1, int v2) const {
+			return const_cast<EdgeHashMap*>(this)->Find(v1, v2);
+		}
+
+		// 不存在时插入一个默认构造的值；返回值的引用（在下一次插入前有效）与是否为新插入
+		std::pair<Value&, bool> TryEmplace(int v1, int v2) {
+			if ((entries.size() + 1) * 2 > slotKeys.size()) {
+				_Rehash(slotKeys.empty() ? MIN_CAPACITY : slotKeys.size() * 2);
+			}
+
+			uint64_t key = Key(v1, v2);
+			size_t slot = _FindSlot(key);
+			if (slotKeys[slot] != EMPTY_KEY) {
+				return { entries[slotEntries[slot]].second, false };
+			}
+
+			slotKeys[slot] = key;
+			slotEntries[slot] = static_cast<uint32_t>(entries.size());
+			entries.emplace_back(key, Value());
+			return { entries.back().second, true };
+		}
+
+		void Clear() {
+			slotKeys.clear();
+			slotKeys.shrink_to_fit();
+			slotEntries.clear();
+			slotEntries.shrink_to_fit();
+			entries.clear();
+			entries.shrink_to_fit();
+			shift = 64;
+		}
+
+		size_t size() const {
+			return entries.size();
+		}
+
+		bool empty() const {
+			return entries.empty();
+		}
+
+		// 按插入顺序遍历（键, 值）
+		typename std::vector<Entry>::const_iterator begin() const {
+			return entries.begin();
+		}
+
+		typename std::vector<Entry>::const_iterator end() const {
+			return entries.end();
+		}
+
+		// 槽位与条目数组占用的字节数（不含Value自身指向的内存）
+		size_t MemoryBytes() const {
+			return slotKeys.capacity() * sizeof(uint64_t) + slotEntries.capacity() * sizeof(uint32_t) + entries.capacity() * sizeof(Entry);
+		}
+
+	private:
+		// 顶点下标非负，两个下标都为0xffffffff的键不会出现
+		static constexpr uint64_t EMPTY_KEY = ~0ull;
+		static constexpr size_t MIN_CAPACITY = 16;
+
+		std::vector<uint64_t> slotKeys;
+		std::vector<uint32_t> slotEntries;
+		std::vector<Entry> entries;
+		int shift = 64; // 64 - log2(容量)
+
+		size_t _HomeSlot(uint64_t key) const {
+			return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift);
+		}
+
+		// 键所在的槽位，不存在时为探测到的第一个空槽位
+		size_t _FindSlot(uint64_t key) const {
+			if (slotKeys.empty()) {
+				return 0;
+			}
+			size_t mask = slotKeys.size() - 1;
+			size_t slot = _HomeSlot(key);
+			while (slotKeys[slot] != EMPTY_KEY && slotKeys[slot] != key) {
+				slot = (slot + 1) & mask;
+			}
+			return slot;
+		}
+
+		void _Rehash(size_t capacity) {
+			slotKeys.assign(capacity, EMPTY_KEY);
+			slotEntries.assign(capacity, 0);
+			shift = 64;
+			for (size_t c = capacity; c > 1; c >>= 1) {
+				shift--;
+			}
+
+			for (size_t e = 0; e < entries.size(); e++) {
+				size_t slot = _FindSlot(entries[e].first);
+				slotKeys[slot] = entries[e].first;
+				slotEntries[slot] = static_cast<uint32_t>(e);
+			}
+		}
+	};
+}
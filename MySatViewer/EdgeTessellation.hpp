@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "EdgeGeometryTable.hpp"
+
+/*
+	边的CPU求值与按容差重新离散
+	用途：SatLineRenderer按屏幕空间误差重新生成每条边的折线，远处的边用很少的点，拉近时曲线仍然光滑
+	straight和ellipse按解析参数求值；ellipse的参数范围由json中采样点的首尾点和中间点确定（json中没有给出参数范围）
+	intcurve在json中只有控制点，没有次数和节点向量，无法按B样条求值，因此和其余类型一样在采样点上做Catmull-Rom插值：
+		分段数少于采样点时相当于抽稀，多于采样点时在采样点之间加密
+	参数还没有读取（延迟解码）或者参数与采样点对不上的边，同样按采样点处理
+*/
+
+namespace Info {
+
+	// 一条边的求值器，参数s在[0, 1]上，s为0和1时正好是首尾两个采样点
+	struct EdgeCurve {
+		enum class Kind : uint8_t {
+			NONE, // 没有采样点，不绘制
+			STRAIGHT,
+			ELLIPSE,
+			SAMPLED
+		};
+
+		Kind kind = Kind::NONE;
+
+		uint32_t firstSample = 0; // 在EdgeGeometryTable::sampledPoints中的范围
+		uint32_t sampleCount = 0;
+
+		// ellipse：p(t) = centre + majorAxis * cos(t) + minorAxis * sin(t)，t从startAngle变化sweepAngle
+		glm::vec3 centre{ 0.0f };
+		glm::vec3 majorAxis{ 0.0f };
+		glm::vec3 minorAxis{ 0.0f };
+		float startAngle = 0.0f;
+		float sweepAngle = 0.0f;
+
+		// 用于估计分段数：弦高误差约为 maxCurvature * (length / n)^2 / 8
+		float length = 0.0f;
+		float maxCurvature = 0.0f;
+
+		// 采样点的包围球，用于求边到相机的距离
+		glm::vec3 boundsCentre{ 0.0f };
+		float boundsRadius = 0.0f;
+
+		glm::vec3 Evaluate(const std::vector<glm::vec3>& sampled_points, float s) const {
+			const glm::vec3* samples = sampled_points.data() + firstSample;
+			if (s <= 0.0f) {
+				return samples[0];
+			}
+			if (s >= 1.0f) {
+				return samples[sampleCount - 1];
+			}
+
+			switch (kind) {
+			case Kind::STRAIGHT:
+				return samples[0] + (samples[sampleCount - 1] - samples[0]) * s;
+			case Kind::ELLIPSE: {
+				float t = startAngle + sweepAngle * s;
+				return centre + majorAxis * std::cos(t) + minorAxis * std::sin(t);
+			}
+			default: {
+				// 均匀参数的Catmull-Rom，经过每个采样点
+				float u = s * static_cast<float>(sampleCount - 1);
+				uint32_t i = std::min(static_cast<uint32_t>(u), sampleCount - 2);
+				float f = u - static_cast<float>(i);
+				const glm::vec3& p0 = samples[i > 0 ? i - 1 : 0];
+				const glm::vec3& p1 = samples[i];
+				const glm::vec3& p2 = samples[i + 1];
+				const glm::vec3& p3 = samples[std::min(i + 2, sampleCount - 1)];
+				float f2 = f * f;
+				float f3 = f2 * f;
+				return (p1 * 2.0f + (p2 - p0) * f + (p0 * 2.0f - p1 * 5.0f + p2 * 4.0f - p3) * f2 + (p1 * 3.0f - p0 - p2 * 3.0f + p3) * f3) * 0.5f;
+			}
+			}
+		}
+
+		// 弦高误差不超过tolerance（与坐标同单位）所需的分段数，至少为1，至多为max_segments
+		int SegmentCount(float tolerance, int max_segments) const {
+			if (kind == Kind::STRAIGHT || maxCurvature <= 0.0f || length <= 0.0f) {
+				return 1;
+			}
+			float segments = length * std::sqrt(maxCurvature / (8.0f * std::max(tolerance, 1e-12f)));
+			return static_cast<int>(std::min(std::ceil(segments), static_cast<float>(max_segments)));
+		}
+	};
+
+	// 由边几何表的第row行构造求值器
+	EdgeCurve MakeEdgeCurve(const EdgeGeometryTable& geometries, int row) {
+		EdgeCurve curve;
+		size_t count = geometries.PointCount(row);
+		if (count < 2) {
+			return curve;
+		}
+
+		const glm::vec3* samples = geometries.Points(row);
+		curve.firstSample = geometries.pointOffsets[row];
+		curve.sampleCount = static_cast<uint32_t>(count);
+		curve.kind = EdgeCurve::Kind::SAMPLED;
+
+		// 采样折线的长度、包围球和离散曲率（相邻两段的转角 / 两段的平均长度）
+		glm::vec3 min_pos = samples[0];
+		glm::vec3 max_pos = samples[0];
+		for (size_t i = 1; i < count; i++) {
+			curve.length += glm::length(samples[i] - samples[i - 1]);
+			min_pos = glm::min(min_pos, samples[i]);
+			max_pos = glm::max(max_pos, samples[i]);
+		}
+		curve.boundsCentre = (min_pos + max_pos) * 0.5f;
+		curve.boundsRadius = glm::length(max_pos - min_pos) * 0.5f;
+
+		for (size_t i = 1; i + 1 < count; i++) {
+			glm::vec3 d0 = samples[i] - samples[i - 1];
+			glm::vec3 d1 = samples[i + 1] - samples[i];
+			float l0 = glm::length(d0);
+			float l1 = glm::length(d1);
+			if (l0 <= 0.0f || l1 <= 0.0f) {
+				continue;
+			}
+			float cos_angle = std::clamp(glm::dot(d0, d1) / (l0 * l1), -1.0f, 1.0f);
+			curve.maxCurvature = std::max(curve.maxCurvature, 2.0f * std::acos(cos_angle) / (l0 + l1));
+		}
+
+		if (geometries.ParamsPending(row) || geometries.ParamsFailed(row)) {
+			return curve;
+		}
+
+		if (geometries.curveTypes[row] == CurveType::STRAIGHT) {
+			curve.kind = EdgeCurve::Kind::STRAIGHT;
+			curve.maxCurvature = 0.0f;
+		}
+		else if (geometries.curveTypes[row] == CurveType::ELLIPSE) {
+			const EllipseCurveParams& ellipse = geometries.Ellipse(row);
+			float a = static_cast<float>(ellipse.majorAxisLength);
+			float b = static_cast<float>(ellipse.minorAxisLength);
+			glm::vec3 normal_cross = glm::cross(ellipse.normal, ellipse.majorAxis);
+			if (a <= 0.0f || b <= 0.0f || glm::length(ellipse.majorAxis) <= 0.0f || glm::length(normal_cross) <= 0.0f) {
+				return curve;
+			}
+			glm::vec3 u = glm::normalize(ellipse.majorAxis);
+			glm::vec3 v = glm::normalize(normal_cross);
+
+			// 点对应的离心角；点到椭圆上同一离心角的点的距离作为拟合误差
+			const float two_pi = 6.283185307f;
+			float max_error = 0.0f;
+			auto angle_of = [&](const glm::vec3& p) {
+				glm::vec3 d = p - ellipse.centre;
+				float t = std::atan2(glm::dot(d, v) / b, glm::dot(d, u) / a);
+				glm::vec3 on_curve = ellipse.centre + u * (a * std::cos(t)) + v * (b * std::sin(t));
+				max_error = std::max(max_error, glm::length(on_curve - p));
+				return t < 0.0f ? t + two_pi : t;
+			};
+			auto wrap = [&](float t) {
+				t = std::fmod(t, two_pi);
+				return t < 0.0f ? t + two_pi : t;
+			};
+
+			float t0 = angle_of(samples[0]);
+			float t1 = angle_of(samples[count - 1]);
+			float tm = angle_of(samples[count / 2]);
+			float tq = angle_of(samples[count / 4]);
+			if (max_error > 1e-3f * a + 1e-6f) {
+				return curve; // 参数与采样点对不上（例如长度的含义不同），仍然用采样点
+			}
+
+			// 逆时针（绕normal）从t0到t1的角度，首尾重合时为整圈；中间的采样点不在这段上时改为顺时针
+			float sweep = wrap(t1 - t0);
+			bool closed = glm::length(samples[count - 1] - samples[0]) <= 1e-6f * a;
+			if (closed || sweep <= 1e-6f) {
+				sweep = wrap(tq - t0) > 0.5f * two_pi ? -two_pi : two_pi;
+			}
+			else if (wrap(tm - t0) > sweep) {
+				sweep = sweep - two_pi;
+			}
+
+			curve.kind = EdgeCurve::Kind::ELLIPSE;
+			curve.centre = ellipse.centre;
+			curve.majorAxis = u * a;
+			curve.minorAxis = v * b;
+			curve.startAngle = t0;
+			curve.sweepAngle = sweep;
+			curve.length = std::abs(sweep) * std::max(a, b);
+			curve.maxCurvature = std::max(a / (b * b), b / (a * a));
+		}
+
+		return curve;
+	}
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "TopologyInfo.hpp"
+
+#include <spdlog/spdlog.h>
+
+/*
+	geometry json 的二进制缓存
+	用途：同一个json第一次解析后，在旁边写出 <json文件名>.geomcache，之后直接映射缓存文件，不再解析文本
+	缓存以源文件的 大小 + 修改时间 + 内容哈希 为键：大小和修改时间都一致时直接使用；
+	只有修改时间不同（例如文件被复制或touch过）时再计算内容哈希确认，一致则仍然使用并更新记录的修改时间
+	文件布局：GeometryCacheHeader，之后各段按8字节对齐依次存放（每段的偏移和元素个数记录在文件头的sections中）：
+		顶点、边、半边、环、面的定长记录
+		三维点 float[3]：边的采样点、intcurve的控制点、样条面的控制点都放在这里，记录中保存自己的起点和数量
+		二维点 float[2]：pcurve的控制点
+		int32：环中半边的markNum
+		double：pcurve的节点、样条面的节点和权重
+		字符串表：uint32 偏移[个数 + 1]，之后是字符串内容（curve_type、curve_name、face_type）
+	半边之间的引用、各记录的位置等由_LinkTopology重新计算，不写入缓存
+	格式或解析逻辑变化时增加 GEOMETRY_CACHE_VERSION，旧缓存会被忽略并重新生成
+*/
+
+namespace Info {
+
+	const uint32_t GEOMETRY_CACHE_MAGIC = 0x434F4547; // "GEOC"
+	const uint32_t GEOMETRY_CACHE_VERSION = 2;
+
+	enum GeometryCacheSection {
+		GEOMETRY_CACHE_VERTICES,
+		GEOMETRY_CACHE_EDGES,
+		GEOMETRY_CACHE_HALF_EDGES,
+		GEOMETRY_CACHE_LOOPS,
+		GEOMETRY_CACHE_FACES,
+		GEOMETRY_CACHE_POINTS,
+		GEOMETRY_CACHE_UV_POINTS,
+		GEOMETRY_CACHE_INTS,
+		GEOMETRY_CACHE_DOUBLES,
+		GEOMETRY_CACHE_STRING_OFFSETS, // 元素个数为字符串个数 + 1
+		GEOMETRY_CACHE_STRING_CHARS,
+		GEOMETRY_CACHE_SECTION_COUNT
+	};
+
+	struct GeometryCacheSectionInfo {
+		uint64_t offset;
+		uint64_t count;
+	};
+
+	struct GeometryCacheHeader {
+		uint32_t magic;
+		uint32_t version;
+
+		// 键
+		uint64_t sourceSize;
+		int64_t sourceMtime;
+		uint64_t sourceHash;
+
+		int32_t basicStat[9]; // 与SatInfo::BasicStat的字段顺序一致
+		uint32_t reserved;
+
+		GeometryCacheSectionInfo sections[GEOMETRY_CACHE_SECTION_COUNT];
+		uint64_t fileSize; // 整个缓存文件的大小，用于检查截断
+	};
+
+	struct GeometryCacheVertex {
+		int32_t markNum;
+		int32_t bodyId;
+		float pos[3];
+		uint32_t reserved;
+	};
+
+	struct GeometryCacheEdge {
+		int32_t markNum;
+		int32_t bodyId;
+		int32_t nonmanifoldCount;
+		int32_t stMarkNum;
+		int32_t edMarkNum;
+		int32_t curveType; // 字符串表中的下标，-1表示没有几何信息（读取失败的记录）
+
+		float pos[3];
+		float geometry[9]; // straight: rootPoint, direction；ellipse: centre, normal, majorAxis
+		double majorAxisLength;
+		double minorAxisLength;
+
+		uint64_t pointBegin;
+		uint64_t ctrlptBegin;
+		uint32_t pointCount;
+		uint32_t ctrlptCount;
+	};
+
+	struct GeometryCacheHalfEdge {
+		int32_t markNum;
+		int32_t bodyId;
+		int32_t edgeMarkNum;
+		int32_t loopMarkNum;
+		int32_t sense;
+		int32_t curveType; // 字符串表中的下标，-1表示读取失败的记录
+		int32_t curveDegree;
+		uint32_t reserved;
+
+		uint64_t ctrlptBegin; // 二维点
+		uint64_t knotBegin; // double
+		uint32_t ctrlptCount;
+		uint32_t knotCount;
+	};
+
+	struct GeometryCacheLoop {
+		int32_t markNum;
+		int32_t bodyId;
+		int32_t faceMarkNum;
+		uint32_t halfEdgeCount;
+		uint64_t halfEdgeBegin; // int32
+	};
+
+	struct GeometryCacheFace {
+		int32_t markNum;
+		int32_t bodyId;
+		int32_t stLoopMarkNum;
+		int32_t faceType; // 字符串表中的下标，-1表示读取失败的记录
+
+		float vectors[9]; // plane: rootPoint, normal；sphere: centre；torus: centre, normal；cone: rootPoint, majorAxis, direction
+		int32_t ints[8]; // spline: degreeU, degreeV, numU, numV, numKnotsU, numKnotsV, numWeightU, numWeightV
+		uint32_t reserved;
+		double values[4]; // sphere: radius；torus: minorRadius, majorRadius；cone: ratio, cos, sin, angle
+
+		uint64_t ctrlptBegin; // 三维点
+		uint64_t knotUBegin; // 以下为double
+		uint64_t knotVBegin;
+		uint64_t weightBegin;
+		uint32_t ctrlptCount;
+		uint32_t knotUCount;
+		uint32_t knotVCount;
+		uint32_t weightCount;
+	};
+
+	// 各段元素的大小
+	const size_t GEOMETRY_CACHE_ELEMENT_SIZES[GEOMETRY_CACHE_SECTION_COUNT] = {
+		sizeof(GeometryCacheVertex), sizeof(GeometryCacheEdge), sizeof(GeometryCacheHalfEdge), sizeof(GeometryCacheLoop), sizeof(GeometryCacheFace),
+		3 * sizeof(float), 2 * sizeof(float), sizeof(int32_t), sizeof(double), sizeof(uint32_t), sizeof(char)
+	};
+
+	static_assert(sizeof(GeometryCacheHeader) % 8 == 0, "GeometryCacheHeader must be 8-byte aligned");
+	static_assert(sizeof(GeometryCacheVertex) == 24, "GeometryCacheVertex layout changed");
+	static_assert(sizeof(GeometryCacheEdge) == 112, "GeometryCacheEdge layout changed");
+	static_assert(sizeof(GeometryCacheHalfEdge) == 56, "GeometryCacheHalfEdge layout changed");
+	static_assert(sizeof(GeometryCacheLoop) == 24, "GeometryCacheLoop layout changed");
+	static_assert(sizeof(GeometryCacheFace) == 168, "GeometryCacheFace layout changed");
+
+	// 64位内容哈希：每次处理32字节（4路独立累加，便于流水），不要求密码学强度
+	uint64_t HashBytes(const char* data, size_t size) {
+		const uint64_t k0 = 0x9E3779B97F4A7C15ull;
+		const uint64_t k1 = 0xC2B2AE3D27D4EB4Full;
+
+		auto mix = [&](uint64_t h, uint64_t v) {
+			h ^= v * k1;
+			h = (h << 31) | (h >> 33);
+			return h * k0;
+		};
+
+		uint64_t h[4] = { k0, k1, k0 ^ size, k1 ^ size };
+		size_t i = 0;
+		for (; i + 32 <= size; i += 32) {
+			uint64_t v[4];
+			std::memcpy(v, data + i, sizeof(v));
+			for (int lane = 0; lane < 4; lane++) {
+				h[lane] = mix(h[lane], v[lane]);
+			}
+		}
+
+		uint64_t res = h[0] ^ (h[1] * 3) ^ (h[2] * 5) ^ (h[3] * 7);
+		for (; i < size; i++) {
+			res = mix(res, static_cast<unsigned char>(data[i]));
+		}
+
+		res ^= res >> 33;
+		res *= k1;
+		res ^= res >> 29;
+		return res;
+	}
+
+	std::string GeometryCachePath(const std::string& json_path) {
+		return json_path + ".geomcache";
+	}
+
+	// 源文件的修改时间（只用于判断是否变化，不关心具体的时间单位）
+	int64_t FileMtime(const std::string& path) {
+		std::error_code ec;
+		auto t = std::filesystem::last_write_time(path, ec);
+		if (ec) {
+			return 0;
+		}
+		return static_cast<int64_t>(t.time_since_epoch().count());
+	}
+
+	size_t AlignCacheOffset(size_t offset) {
+		return (offset + 7) & ~size_t(7);
+	}
+
+	// 打开并校验缓存：只在修改时间不一致时才映射源文件计算内容哈希
+	// 校验通过时返回true，此时header指向映射中的文件头
+	bool OpenGeometryCache(const std::string& json_path, Utils::MappedFile& cache_file, const GeometryCacheHeader*& header, bool& mtime_changed) {
+		mtime_changed = false;
+
+		std::string cache_path = GeometryCachePath(json_path);
+		std::error_code ec;
+		if (!std::filesystem::exists(cache_path, ec) || !cache_file.Open(cache_path) || cache_file.Size() < sizeof(GeometryCacheHeader)) {
+			return false;
+		}
+
+		header = reinterpret_cast<const GeometryCacheHeader*>(cache_file.Data());
+		if (header->magic != GEOMETRY_CACHE_MAGIC || header->version != GEOMETRY_CACHE_VERSION || header->fileSize != cache_file.Size()) {
+			SPDLOG_INFO("Geometry cache {} is outdated or broken, ignored.", cache_path);
+			return false;
+		}
+
+		// 各段必须落在文件内
+		for (int i = 0; i < GEOMETRY_CACHE_SECTION_COUNT; i++) {
+			const GeometryCacheSectionInfo& section = header->sections[i];
+			if (section.offset % 8 != 0 || section.offset > header->fileSize || section.count > (header->fileSize - section.offset) / GEOMETRY_CACHE_ELEMENT_SIZES[i]) {
+				SPDLOG_WARN("Geometry cache {} is truncated, ignored.", cache_path);
+				return false;
+			}
+		}
+
+		uint64_t source_size = std::filesystem::file_size(json_path, ec);
+		if (ec || source_size != header->sourceSize) {
+			return false;
+		}
+
+		if (FileMtime(json_path) != header->sourceMtime) {
+			Utils::MappedFile json_file;
+			if (!json_file.Open(json_path) || HashBytes(json_file.Data(), json_file.Size()) != header->sourceHash) {
+				return false;
+			}
+			mtime_changed = true;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,975 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <emmintrin.h>
+
+#include "GeometryJsonSax.hpp"
+#include "ThreadPool.hpp"
+
+/*
+	geometry json 的专用解析器
+	用途：只针对geometry json的结构手写的递归下降解析，直接在映射的文件内容上工作：
+		键不拷贝（string_view指向文件内容），数字直接转换，不经过nlohmann的token缓冲和通用的值分发
+	记录的组装复用GeometryJsonSaxHandler（_FinishVertex/_FinishEdge等），因此缺字段、类型不符等情况的处理与SAX解析完全一致
+	遇到带转义的键或curve_type、语法错误、数字溢出等情况时返回false，调用者应改用nlohmann的SAX解析重新解析整个文件
+*/
+
+namespace Info {
+
+	class GeometryJsonFastParser : public GeometryJsonSaxHandler {
+	public:
+		size_t errorOffset = 0; // Parse返回false时停下的位置
+
+		bool Parse(const char* first, const char* last) {
+			begin = first;
+			cur = first;
+			end = last;
+
+			size_t thread_count = Utils::ThreadPool::GetInstance().ThreadCount();
+			parallel = thread_count > 1;
+			chunkBytes = std::max<size_t>(256 * 1024, static_cast<size_t>(last - first) / (thread_count * 8));
+
+			std::vector<Chunk> chunks;
+			_SkipWs();
+			bool ok = _ParseRoot(chunks);
+			if (ok) {
+				_SkipWs();
+				ok = cur == end;
+			}
+			if (ok && !chunks.empty()) {
+				ok = _ParseChunks(chunks);
+			}
+
+			if (!ok) {
+				errorOffset = static_cast<size_t>(cur - begin);
+			}
+			return ok;
+		}
+
+		// 延迟解码：[first, last)为一条边记录（即Parse时记下的范围），完整地重新解析它，结果为edgeInfos[0]和edgeGeometries的第0行
+		// 记录不完整（缺少字段等）时返回false
+		bool ParseEdgeRecord(const char* first, const char* last) {
+			begin = first;
+			cur = first;
+			end = last;
+			lazyEdgeProperty = false;
+			if (!_ParseEdge()) {
+				return false;
+			}
+			_SkipWs();
+			return cur == end && edgeInfos.size() == 1 && edgeInfos[0].geometryIndex == 0;
+		}
+
+	private:
+		enum class Section {
+			Vertices,
+			Edges,
+			HalfEdges,
+			Loops,
+			Faces
+		};
+
+		// 某一段中连续的若干条记录：除了段中的第一块，都从上一条记录的 '}' 之后开始（以逗号开头）
+		struct Chunk {
+			Section section;
+			const char* first;
+			const char* last;
+			size_t firstIndex; // 第一条记录在段中的序号
+		};
+
+		const char* begin = nullptr;
+		const char* cur = nullptr;
+		const char* end = nullptr;
+
+		bool parallel = false;
+		size_t chunkBytes = 0;
+
+		char _Peek() const {
+			return cur < end ? *cur : '\0';
+		}
+
+		void _SkipWs() {
+			while (cur < end && (*cur == ' ' || *cur == '\n' || *cur == '\r' || *cur == '\t')) {
+				cur++;
+			}
+		}
+
+		bool _Consume(char c) {
+			_SkipWs();
+			if (_Peek() != c) {
+				return false;
+			}
+			cur++;
+			return true;
+		}
+
+		bool _PeekNumber() {
+			_SkipWs();
+			char c = _Peek();
+			return c == '-' || (c >= '0' && c <= '9');
+		}
+
+		// 不含转义的字符串，结果指向文件内容；含转义时返回false
+		bool _ParseRawString(std::string_view& out) {
+			if (!_Consume('"')) {
+				return false;
+			}
+			const char* first = cur;
+			while (cur < end && *cur != '"') {
+				if (*cur == '\\' || static_cast<unsigned char>(*cur) < 0x20) {
+					return false;
+				}
+				cur++;
+			}
+			if (cur == end) {
+				return false;
+			}
+			out = std::string_view(first, cur - first);
+			cur++;
+			return true;
+		}
+
+		// 遍历对象的成员，on_member(key)负责解析值
+		template<typename F>
+		bool _ParseObject(F&& on_member) {
+			if (!_Consume('{')) {
+				return false;
+			}
+			if (_Consume('}')) {
+				return true;
+			}
+			while (true) {
+				std::string_view key;
+				if (!_ParseRawString(key) || !_Consume(':') || !on_member(key)) {
+					return false;
+				}
+				if (_Consume(',')) {
+					continue;
+				}
+				return _Consume('}');
+			}
+		}
+
+		// 遍历数组的元素，on_element()负责解析元素
+		template<typename F>
+		bool _ParseArray(F&& on_element) {
+			if (!_Consume('[')) {
+				return false;
+			}
+			if (_Consume(']')) {
+				return true;
+			}
+			while (true) {
+				if (!on_element()) {
+					return false;
+				}
+				if (_Consume(',')) {
+					continue;
+				}
+				return _Consume(']');
+			}
+		}
+
+		// 数字转成double，结果与nlohmann一致：整数按整数转换，小数为正确舍入
+		// 有效数字不超过19位、去掉末尾的0后尾数不超过2^53且10的幂次不超过22时，一次乘除法就是正确舍入的结果（Clinger），其余交给from_chars
+		bool _ParseNumber(double& out) {
+			static const double pow10[23] = {
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+			};
+
+			_SkipWs();
+			const char* first = cur;
+			const char* p = cur;
+
+			bool negative = false;
+			if (p < end && *p == '-') {
+				negative = true;
+				p++;
+			}
+			if (p == end || *p < '0' || *p > '9') {
+				return false;
+			}
+
+			uint64_t mantissa = 0;
+			int significant_digits = 0;
+			int exponent = 0;
+			bool too_many_digits = false;
+			bool is_integer = true;
+
+			auto add_digit = [&](int digit) {
+				if (mantissa == 0 && digit == 0) {
+					return;
+				}
+				if (significant_digits < 19) {
+					mantissa = mantissa * 10 + digit;
+					significant_digits++;
+				}
+				else {
+					too_many_digits = true;
+				}
+			};
+
+			if (*p == '0') {
+				p++;
+			}
+			else {
+				while (p < end && *p >= '0' && *p <= '9') {
+					add_digit(*p - '0');
+					p++;
+				}
+			}
+
+			if (p < end && *p == '.') {
+				is_integer = false;
+				p++;
+				if (p == end || *p < '0' || *p > '9') {
+					return false;
+				}
+				while (p < end && *p >= '0' && *p <= '9') {
+					add_digit(*p - '0');
+					exponent--;
+					p++;
+				}
+			}
+
+			if (p < end && (*p == 'e' || *p == 'E')) {
+				is_integer = false;
+				p++;
+				bool exponent_negative = false;
+				if (p < end && (*p == '+' || *p == '-')) {
+					exponent_negative = *p == '-';
+					p++;
+				}
+				if (p == end || *p < '0' || *p > '9') {
+					return false;
+				}
+				int explicit_exponent = 0;
+				while (p < end && *p >= '0' && *p <= '9') {
+					if (explicit_exponent < 100000) {
+						explicit_exponent = explicit_exponent * 10 + (*p - '0');
+					}
+					p++;
+				}
+				exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+			}
+
+			cur = p;
+
+			if (!too_many_digits) {
+				if (is_integer) {
+					// nlohmann把 -0 当作整数0
+					out = negative ? -static_cast<double>(mantissa) : static_cast<double>(mantissa);
+					if (mantissa == 0) {
+						out = 0.0;
+					}
+					return true;
+				}
+
+				const uint64_t max_exact = uint64_t(1) << 53;
+				while (mantissa > max_exact && mantissa % 10 == 0) {
+					mantissa /= 10;
+					exponent++;
+				}
+				if (mantissa <= max_exact && exponent >= -22 && exponent <= 22) {
+					double value = static_cast<double>(mantissa);
+					value = exponent < 0 ? value / pow10[-exponent] : value * pow10[exponent];
+					out = negative ? -value : value;
+					return true;
+				}
+			}
+
+			auto res = std::from_chars(first, p, out);
+			return res.ec == std::errc() && res.ptr == p;
+		}
+
+		// 跳过任意一个值（同时检查语法）
+		bool _SkipValue() {
+			_SkipWs();
+			switch (_Peek()) {
+			case '{':
+				return _ParseObject([&](std::string_view) { return _SkipValue(); });
+			case '[':
+				return _ParseArray([&]() { return _SkipValue(); });
+			case '"':
+				return _SkipString();
+			case 't':
+				return _SkipLiteral("true");
+			case 'f':
+				return _SkipLiteral("false");
+			case 'n':
+				return _SkipLiteral("null");
+			default:
+				return _SkipNumber();
+			}
+		}
+
+		// 跳过的数字只按json的语法检查，不做转换（被跳过的property中大部分是数字）
+		bool _SkipNumber() {
+			auto skip_digits = [&]() {
+				const char* first = cur;
+				while (cur < end && *cur >= '0' && *cur <= '9') {
+					cur++;
+				}
+				return cur > first;
+			};
+
+			if (cur < end && *cur == '-') {
+				cur++;
+			}
+			if (cur < end && *cur == '0') {
+				cur++;
+			}
+			else if (!skip_digits()) {
+				return false;
+			}
+			if (cur < end && *cur == '.') {
+				cur++;
+				if (!skip_digits()) {
+					return false;
+				}
+			}
+			if (cur < end && (*cur == 'e' || *cur == 'E')) {
+				cur++;
+				if (cur < end && (*cur == '+' || *cur == '-')) {
+					cur++;
+				}
+				if (!skip_digits()) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool _SkipString() {
+			cur++; // '"'
+			while (cur < end) {
+				char c = *cur++;
+				if (c == '"') {
+					return true;
+				}
+				if (static_cast<unsigned char>(c) < 0x20) {
+					return false;
+				}
+				if (c == '\\') {
+					if (cur == end) {
+						return false;
+					}
+					char e = *cur++;
+					if (e == 'u') {
+						for (int i = 0; i < 4; i++) {
+							if (cur == end || !std::isxdigit(static_cast<unsigned char>(*cur))) {
+								return false;
+							}
+							cur++;
+						}
+					}
+					else if (std::string_view("\"\\/bfnrt").find(e) == std::string_view::npos) {
+						return false;
+					}
+				}
+			}
+			return false;
+		}
+
+		bool _SkipLiteral(std::string_view literal) {
+			if (static_cast<size_t>(end - cur) < literal.size() || std::string_view(cur, literal.size()) != literal) {
+				return false;
+			}
+			cur += literal.size();
+			return true;
+		}
+
+		// 以下与GeometryJsonSaxHandler的处理对应：需要数字的位置不是数字、需要对象/数组的位置不是对象/数组时，与SAX一样忽略这个值
+
+		bool _ParseRoot(std::vector<Chunk>& chunks) {
+			return _ParseObject([&](std::string_view key) {
+				_SkipWs();
+				if (key == "basic_statistics" && _Peek() == '{') {
+					return _ParseStats();
+				}
+
+				Section section;
+				if (_Peek() == '[' && _SectionOf(key, section)) {
+					if (parallel) {
+						return _ScanSection(section, chunks);
+					}
+					return _ParseArray([&]() { return _ParseElement(section); });
+				}
+
+				return _SkipValue();
+			});
+		}
+
+		static bool _SectionOf(std::string_view key, Section& section) {
+			if (key == "root_vertices") section = Section::Vertices;
+			else if (key == "root_edges") section = Section::Edges;
+			else if (key == "root_coedges") section = Section::HalfEdges;
+			else if (key == "root_loops") section = Section::Loops;
+			else if (key == "root_faces") section = Section::Faces;
+			else return false;
+			return true;
+		}
+
+		bool _ParseElement(Section section) {
+			_SkipWs();
+			if (_Peek() != '{') {
+				return _SkipValue();
+			}
+			switch (section) {
+			case Section::Vertices:
+				return _ParseVertex();
+			case Section::Edges:
+				return _ParseEdge();
+			case Section::HalfEdges:
+				return _ParseHalfEdge();
+			case Section::Loops:
+				return _ParseLoop();
+			case Section::Faces:
+				return _ParseFace();
+			}
+			return false;
+		}
+
+		// 从p开始找下一个引号、反斜杠或括号，没有时返回end
+		const char* _NextStructural(const char* p) const {
+			const __m128i quote = _mm_set1_epi8('"');
+			const __m128i backslash = _mm_set1_epi8('\\');
+			const __m128i open_brace = _mm_set1_epi8('{');
+			const __m128i close_brace = _mm_set1_epi8('}');
+			const __m128i open_bracket = _mm_set1_epi8('[');
+			const __m128i close_bracket = _mm_set1_epi8(']');
+
+			while (end - p >= 16) {
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				__m128i hit = _mm_or_si128(
+					_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+					_mm_or_si128(
+						_mm_or_si128(_mm_cmpeq_epi8(v, open_brace), _mm_cmpeq_epi8(v, close_brace)),
+						_mm_or_si128(_mm_cmpeq_epi8(v, open_bracket), _mm_cmpeq_epi8(v, close_bracket))));
+				unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+				if (mask != 0) {
+					return p + _LowestBit(mask);
+				}
+				p += 16;
+			}
+
+			while (p < end && *p != '"' && *p != '\\' && *p != '{' && *p != '}' && *p != '[' && *p != ']') {
+				p++;
+			}
+			return p;
+		}
+
+		static int _LowestBit(unsigned mask) {
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return static_cast<int>(index);
+#else
+			return __builtin_ctz(mask);
+#endif
+		}
+
+		// 只看括号和字符串，找出段数组的结尾，并在记录之间切块（语法检查留给各块的解析）
+		bool _ScanSection(Section section, std::vector<Chunk>& chunks) {
+			const char* p = cur + 1; // '['
+			const char* chunk_first = p;
+			size_t chunk_index = 0;
+			size_t object_count = 0;
+			int depth = 0;
+			bool in_string = false;
+
+			while (p < end) {
+				p = _NextStructural(p);
+				if (p >= end) {
+					break;
+				}
+
+				char c = *p;
+				if (in_string) {
+					if (c == '\\') {
+						// 反斜杠是最后一个字节时文件被截断
+						if (end - p < 2) {
+							break;
+						}
+						p += 2;
+						continue;
+					}
+					if (c == '"') {
+						in_string = false;
+					}
+					p++;
+					continue;
+				}
+
+				switch (c) {
+				case '"':
+					in_string = true;
+					break;
+				case '{':
+				case '[':
+					depth++;
+					break;
+				case '}':
+				case ']':
+					if (depth == 0) {
+						if (c != ']') {
+							cur = p;
+							return false;
+						}
+						chunks.push_back({ section, chunk_first, p, chunk_index });
+						cur = p + 1;
+						return true;
+					}
+					depth--;
+					if (depth == 0 && c == '}') {
+						object_count++;
+						if (static_cast<size_t>(p + 1 - chunk_first) >= chunkBytes) {
+							chunks.push_back({ section, chunk_first, p + 1, chunk_index });
+							chunk_first = p + 1;
+							chunk_index = object_count;
+						}
+					}
+					break;
+				default: // 字符串外的反斜杠，交给解析时报错
+					break;
+				}
+				p++;
+			}
+
+			// 没有找到段数组的结尾
+			cur = end;
+			return false;
+		}
+
+		bool _ParseChunk(const Chunk& chunk) {
+			cur = chunk.first;
+			end = chunk.last;
+
+			bool after_element = chunk.firstIndex > 0;
+			while (true) {
+				_SkipWs();
+				if (cur == end) {
+					return true;
+				}
+				if (after_element && !_Consume(',')) {
+					return false;
+				}
+				if (!_ParseElement(chunk.section)) {
+					return false;
+				}
+				after_element = true;
+			}
+		}
+
+		template<typename T>
+		static void _Append(std::vector<T>& dst, std::vector<T>& src) {
+			if (dst.empty()) {
+				dst = std::move(src);
+			}
+			else {
+				dst.insert(dst.end(), std::make_move_iterator(src.begin()), std::make_move_iterator(src.end()));
+			}
+			src.clear();
+		}
+
+		bool _ParseChunks(const std::vector<Chunk>& chunks) {
+			std::vector<GeometryJsonFastParser> parsers(chunks.size());
+			std::vector<char> chunk_ok(chunks.size(), 0);
+
+			Utils::ThreadPool::GetInstance().ParallelFor(chunks.size(), [&](size_t first, size_t last, size_t chunk_index) {
+				for (size_t i = first; i < last; i++) {
+					parsers[i].begin = begin;
+					parsers[i].selectedBodies = selectedBodies;
+					parsers[i].lazyEdgeProperty = lazyEdgeProperty;
+					chunk_ok[i] = parsers[i]._ParseChunk(chunks[i]);
+				}
+			}, 1);
+
+			for (size_t i = 0; i < chunks.size(); i++) {
+				if (!chunk_ok[i]) {
+					cur = parsers[i].cur;
+					return false;
+				}
+			}
+
+			// 每段各自统计总数预留空间后按块的顺序拼接
+			size_t counts[5] = {};
+			size_t point_count = 0;
+			for (auto& parser : parsers) {
+				point_count += parser.edgeGeometries.sampledPoints.size();
+				counts[0] += parser.vertexInfos.size();
+				counts[1] += parser.edgeInfos.size();
+				counts[2] += parser.halfEdgeInfos.size();
+				counts[3] += parser.loopInfos.size();
+				counts[4] += parser.faceInfos.size();
+			}
+			vertexInfos.reserve(vertexInfos.size() + counts[0]);
+			edgeInfos.reserve(edgeInfos.size() + counts[1]);
+			halfEdgeInfos.reserve(halfEdgeInfos.size() + counts[2]);
+			loopInfos.reserve(loopInfos.size() + counts[3]);
+			faceInfos.reserve(faceInfos.size() + counts[4]);
+			edgeGeometries.sampledPoints.reserve(edgeGeometries.sampledPoints.size() + point_count);
+
+			for (auto& parser : parsers) {
+				_Append(vertexInfos, parser.vertexInfos);
+
+				// 边的几何行号要加上前面各块的行数
+				int row_base = edgeGeometries.Append(parser.edgeGeometries);
+				for (auto& info : parser.edgeInfos) {
+					if (info.geometryIndex >= 0) {
+						info.geometryIndex += row_base;
+					}
+				}
+				parser.edgeGeometries.Clear();
+				_Append(edgeInfos, parser.edgeInfos);
+				_Append(halfEdgeInfos, parser.halfEdgeInfos);
+				_Append(loopInfos, parser.loopInfos);
+				_Append(faceInfos, parser.faceInfos);
+
+				vertexFailures.Merge(parser.vertexFailures);
+				edgeFailures.Merge(parser.edgeFailures);
+				halfEdgeFailures.Merge(parser.halfEdgeFailures);
+				loopFailures.Merge(parser.loopFailures);
+				faceFailures.Merge(parser.faceFailures);
+				skippedRecordCount += parser.skippedRecordCount;
+			}
+			return true;
+		}
+
+		bool _ParseStats() {
+			return _ParseObject([&](std::string_view key) {
+				if (!_PeekNumber()) {
+					return _SkipValue();
+				}
+				double val;
+				if (!_ParseNumber(val)) {
+					return false;
+				}
+				basicStatistics[std::string(key)] = static_cast<int>(val);
+				return true;
+			});
+		}
+
+		// 三维点用x、y、z，二维点（uv为true）用u、v
+		bool _ParsePoint(bool uv = false) {
+			point = PointRecord();
+			return _ParseObject([&](std::string_view key) {
+				int axis = key.size() == 1 ? (uv ? _UvIndex(key[0]) : _AxisIndex(key[0])) : -1;
+				if (axis < 0 || !_PeekNumber()) {
+					return _SkipValue();
+				}
+				double val;
+				if (!_ParseNumber(val)) {
+					return false;
+				}
+				point.v[axis] = static_cast<float>(val);
+				point.mask |= 1 << axis;
+				return true;
+			});
+		}
+
+		static int _AxisIndex(char c) {
+			if (c == 'x') return 0;
+			if (c == 'y') return 1;
+			if (c == 'z') return 2;
+			return -1;
+		}
+
+		static int _UvIndex(char c) {
+			if (c == 'u') return 0;
+			if (c == 'v') return 1;
+			return -1;
+		}
+
+		// 点的数组：每读完一个点调用on_point()，由它检查point.mask
+		template<typename F>
+		bool _ParsePoints(bool uv, F&& on_point) {
+			return _ParseArray([&]() {
+				_SkipWs();
+				if (_Peek() != '{') {
+					return _SkipValue();
+				}
+				if (!_ParsePoint(uv)) {
+					return false;
+				}
+				on_point();
+				return true;
+			});
+		}
+
+		bool _ParseNumbers(std::vector<double>& out) {
+			return _ParseArray([&]() {
+				if (!_PeekNumber()) {
+					return _SkipValue();
+				}
+				double val;
+				if (!_ParseNumber(val)) {
+					return false;
+				}
+				out.push_back(val);
+				return true;
+			});
+		}
+
+		// 标量字段：数字按names设置（不在表中的数字直接丢弃），其余的值跳过
+		bool _ParseField(const char* const* names, int count, std::string_view key, int* fields, int& mask) {
+			if (!_PeekNumber()) {
+				return _SkipValue();
+			}
+			double val;
+			if (!_ParseNumber(val)) {
+				return false;
+			}
+			_SetField(names, count, key, val, fields, mask);
+			if (key == "body") {
+				_SetBody(static_cast<int>(val));
+			}
+			return true;
+		}
+
+		// property/geometry_info中的数字暂存到property，其余的值跳过
+		bool _ParsePropertyNumber(std::string_view key, PropertyList& property) {
+			if (!_PeekNumber()) {
+				return _SkipValue();
+			}
+			double val;
+			if (!_ParseNumber(val)) {
+				return false;
+			}
+			property.emplace_back(std::string(key), val);
+			return true;
+		}
+
+		bool _ParseString(std::string& out) {
+			std::string_view val;
+			if (!_ParseRawString(val)) {
+				return false;
+			}
+			out.assign(val.data(), val.size());
+			return true;
+		}
+
+		bool _ParseVertex() {
+			vertex = VertexRecord();
+			bool ok = _ParseObject([&](std::string_view key) {
+				if (recordSkipped) {
+					return _SkipValue();
+				}
+				_SkipWs();
+				if (key == "point" && _Peek() == '{') {
+					if (!_ParsePoint()) {
+						return false;
+					}
+					vertex.hasPoint = point.mask == 7;
+					vertex.pos = glm::vec3{ point.v[0], point.v[1], point.v[2] };
+					return true;
+				}
+				if ((key == "body" || key == "marknum") && _PeekNumber()) {
+					double val;
+					if (!_ParseNumber(val)) {
+						return false;
+					}
+					if (key == "body") {
+						vertex.bodyId = static_cast<int>(val);
+						vertex.mask |= 1;
+						_SetBody(vertex.bodyId);
+					}
+					else {
+						vertex.markNum = static_cast<int>(val);
+						vertex.mask |= 2;
+					}
+					return true;
+				}
+				return _SkipValue();
+			});
+			if (ok) {
+				_FinishVertex();
+			}
+			return ok;
+		}
+
+		bool _ParseEdgeProperty() {
+			edge.hasProperty = true;
+			return _ParseObject([&](std::string_view key) {
+				_SkipWs();
+				if (key == "ctrlpts" && _Peek() == '[') {
+					edge.hasCtrlpts = true;
+					return _ParsePoints(false, [&]() { _AddEdgePoint(true); });
+				}
+				return _ParsePropertyNumber(key, edge.property);
+			});
+		}
+
+		bool _ParseEdge() {
+			edge = EdgeRecord();
+			_SkipWs();
+			const char* record_first = cur;
+			bool ok = _ParseObject([&](std::string_view key) {
+				if (recordSkipped) {
+					return _SkipValue();
+				}
+				_SkipWs();
+				char c = _Peek();
+				if (key == "sampled_points" && c == '[') {
+					edge.hasSampledPoints = true;
+					return _ParsePoints(false, [&]() { _AddEdgePoint(false); });
+				}
+				if (key == "property" && c == '{') {
+					if (lazyEdgeProperty) {
+						edge.hasProperty = true;
+						return _SkipValue();
+					}
+					return _ParseEdgeProperty();
+				}
+				if (key == "curve_type" && c == '"') {
+					return _ParseString(edge.curveType);
+				}
+				return _ParseField(EDGE_FIELD_NAMES, EDGE_FIELD_COUNT, key, edge.fields, edge.mask);
+			});
+			if (ok) {
+				edge.recordOffset = static_cast<uint64_t>(record_first - begin);
+				edge.recordSize = static_cast<uint32_t>(cur - record_first);
+				_FinishEdge();
+			}
+			return ok;
+		}
+
+		bool _ParseHalfEdgeProperty() {
+			halfEdge.hasProperty = true;
+			return _ParseObject([&](std::string_view key) {
+				_SkipWs();
+				char c = _Peek();
+				if (key == "ctrlpts" && c == '[') {
+					halfEdge.hasCtrlpts = true;
+					return _ParsePoints(true, [&]() { _AddUvPoint(); });
+				}
+				if (key == "knots" && c == '[') {
+					halfEdge.hasKnots = true;
+					return _ParseNumbers(halfEdge.knots);
+				}
+				if (key == "curve_name" && c == '"') {
+					return _ParseString(halfEdge.curveName);
+				}
+				return _ParsePropertyNumber(key, halfEdge.property);
+			});
+		}
+
+		bool _ParseHalfEdge() {
+			halfEdge = HalfEdgeRecord();
+			bool ok = _ParseObject([&](std::string_view key) {
+				if (recordSkipped) {
+					return _SkipValue();
+				}
+				_SkipWs();
+				char c = _Peek();
+				if (key == "property" && c == '{') {
+					return _ParseHalfEdgeProperty();
+				}
+				if (key == "sense" && (c == 't' || c == 'f')) {
+					bool sense = c == 't';
+					if (!_SkipLiteral(sense ? "true" : "false")) {
+						return false;
+					}
+					_SetField(HALF_EDGE_FIELD_NAMES, HALF_EDGE_FIELD_COUNT, key, sense ? 1.0 : 0.0, halfEdge.fields, halfEdge.mask);
+					return true;
+				}
+				return _ParseField(HALF_EDGE_FIELD_NAMES, HALF_EDGE_FIELD_COUNT, key, halfEdge.fields, halfEdge.mask);
+			});
+			if (ok) {
+				_FinishHalfEdge();
+			}
+			return ok;
+		}
+
+		bool _ParseLoopCoedge() {
+			loop.hasCoedgeMarkNum = false;
+			bool ok = _ParseObject([&](std::string_view key) {
+				if (key != "coedge_marknum" || !_PeekNumber()) {
+					return _SkipValue();
+				}
+				double val;
+				if (!_ParseNumber(val)) {
+					return false;
+				}
+				loop.coedgeMarkNum = static_cast<int>(val);
+				loop.hasCoedgeMarkNum = true;
+				return true;
+			});
+			if (ok) {
+				_AddLoopCoedge();
+			}
+			return ok;
+		}
+
+		bool _ParseLoop() {
+			loop = LoopRecord();
+			bool ok = _ParseObject([&](std::string_view key) {
+				if (recordSkipped) {
+					return _SkipValue();
+				}
+				_SkipWs();
+				if (key == "coedge_list" && _Peek() == '[') {
+					loop.hasCoedgeList = true;
+					return _ParseArray([&]() {
+						_SkipWs();
+						return _Peek() == '{' ? _ParseLoopCoedge() : _SkipValue();
+					});
+				}
+				return _ParseField(LOOP_FIELD_NAMES, LOOP_FIELD_COUNT, key, loop.fields, loop.mask);
+			});
+			if (ok) {
+				_FinishLoop();
+			}
+			return ok;
+		}
+
+		bool _ParseFaceGeometry() {
+			face.hasGeometry = true;
+			return _ParseObject([&](std::string_view key) {
+				_SkipWs();
+				char c = _Peek();
+				if (key == "face_type" && c == '"') {
+					return _ParseString(face.faceType);
+				}
+				if (c == '[') {
+					if (key == "control_points") {
+						face.hasCtrlpts = true;
+						return _ParsePoints(false, [&]() { _AddFaceCtrlpt(); });
+					}
+					std::vector<double>* numbers = face.NumberArray(key);
+					return numbers != nullptr ? _ParseNumbers(*numbers) : _SkipValue();
+				}
+				return _ParsePropertyNumber(key, face.property);
+			});
+		}
+
+		bool _ParseFace() {
+			face = FaceRecord();
+			bool ok = _ParseObject([&](std::string_view key) {
+				if (recordSkipped) {
+					return _SkipValue();
+				}
+				_SkipWs();
+				if (key == "geometry_info" && _Peek() == '{') {
+					return _ParseFaceGeometry();
+				}
+				return _ParseField(FACE_FIELD_NAMES, FACE_FIELD_COUNT, key, face.fields, face.mask);
+			});
+			if (ok) {
+				_FinishFace();
+			}
+			return ok;
+		}
+	};
+}
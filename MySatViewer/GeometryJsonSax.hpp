@@ -0,0 +1,978 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "json.hpp"
+
+#include "TopologyInfo.hpp"
+#include "JsonFields.hpp"
+
+#include <spdlog/spdlog.h>
+
+/*
+	geometry json 的流式（SAX）解析
+	用途：不建立整个文件的DOM，在token到达时直接构造VertexInfo/EdgeInfo/HalfEdgeInfo/LoopInfo/FaceInfo，峰值内存只比结果本身多出一条记录
+	只关心 basic_statistics、root_vertices、root_edges、root_coedges、root_loops、root_faces，其余的键整棵子树跳过
+	设置了selectedBodies时，读到记录的body字段后如果没有选中，记录中其余的子树（采样点等）也整棵跳过，不分配内存
+	单条记录缺少字段时的处理与原来基于DOM的加载一致：该记录记为失败，结果中保留一个默认构造的占位
+	半边的partner/pre/next以及各记录之间的引用在文件中没有直接给出，由SatInfo::_LinkTopology在全部记录读完后补上
+*/
+
+namespace Info {
+
+	class GeometryJsonSaxHandler {
+	public:
+		using json = nlohmann::json;
+
+		std::map<std::string, int> basicStatistics;
+		std::vector<VertexInfo> vertexInfos;
+		std::vector<EdgeInfo> edgeInfos;
+		EdgeGeometryTable edgeGeometries; // edgeInfos中各边的几何，按读取顺序
+		std::vector<HalfEdgeInfo> halfEdgeInfos;
+		std::vector<LoopInfo> loopInfos;
+		std::vector<FaceInfo> faceInfos;
+
+		// 读取失败的记录数和缺少的字段，不逐条写日志，由调用者在解析完成后输出汇总
+		Utils::FieldFailures vertexFailures;
+		Utils::FieldFailures edgeFailures;
+		Utils::FieldFailures halfEdgeFailures;
+		Utils::FieldFailures loopFailures;
+		Utils::FieldFailures faceFailures;
+
+		std::set<int> selectedBodies; // 只保留这些body的记录，为空时保留全部
+		int skippedRecordCount = 0; // 因为body没有选中而跳过的记录数
+
+		// 边的property是否延迟解码：为true时straight/ellipse/intcurve的参数先不读取，只记下整条记录在文件中的范围（见EdgeGeometryTable）
+		// 需要记录在文件中的位置，因此只有专用解析器（GeometryJsonFastParser）支持，nlohmann的SAX解析总是直接读取
+		bool lazyEdgeProperty = false;
+
+		std::string errorMessage; // 语法错误时的信息
+
+		// 以下为nlohmann::json::sax_parse要求的接口，返回false时停止解析
+
+		bool null() {
+			return true;
+		}
+
+		bool boolean(bool val) {
+			if (_Top() == Ctx::HalfEdge && currentKey == "sense") {
+				_Number(val ? 1.0 : 0.0);
+			}
+			return true;
+		}
+
+		bool number_integer(json::number_integer_t val) {
+			_Number(static_cast<double>(val));
+			return true;
+		}
+
+		bool number_unsigned(json::number_unsigned_t val) {
+			_Number(static_cast<double>(val));
+			return true;
+		}
+
+		bool number_float(json::number_float_t val, const json::string_t& /*s*/) {
+			_Number(val);
+			return true;
+		}
+
+		bool string(json::string_t& val) {
+			if (_Top() == Ctx::Edge && currentKey == "curve_type") {
+				edge.curveType = std::move(val);
+			}
+			else if (_Top() == Ctx::HalfEdgeProperty && currentKey == "curve_name") {
+				halfEdge.curveName = std::move(val);
+			}
+			else if (_Top() == Ctx::FaceGeometry && currentKey == "face_type") {
+				face.faceType = std::move(val);
+			}
+			return true;
+		}
+
+		bool binary(json::binary_t& /*val*/) {
+			return true;
+		}
+
+		bool start_object(std::size_t /*elements*/) {
+			Ctx ctx = Ctx::Skip;
+
+			if (stack.empty()) {
+				ctx = Ctx::Root;
+			}
+			else if (recordSkipped && _IsRecord(_Top())) {
+				ctx = Ctx::Skip;
+			}
+			else {
+				switch (_Top()) {
+				case Ctx::Root:
+					if (currentKey == "basic_statistics") ctx = Ctx::Stats;
+					break;
+				case Ctx::Vertices:
+					ctx = Ctx::Vertex;
+					vertex = VertexRecord();
+					break;
+				case Ctx::Vertex:
+					if (currentKey == "point") {
+						ctx = Ctx::VertexPoint;
+						point = PointRecord();
+					}
+					break;
+				case Ctx::Edges:
+					ctx = Ctx::Edge;
+					edge = EdgeRecord();
+					break;
+				case Ctx::Edge:
+					if (currentKey == "property") {
+						ctx = Ctx::EdgeProperty;
+						edge.hasProperty = true;
+					}
+					break;
+				case Ctx::EdgeCtrlpts:
+				case Ctx::EdgeSampledPoints:
+					ctx = _Top() == Ctx::EdgeCtrlpts ? Ctx::EdgeCtrlpt : Ctx::EdgeSampledPoint;
+					point = PointRecord();
+					break;
+				case Ctx::HalfEdges:
+					ctx = Ctx::HalfEdge;
+					halfEdge = HalfEdgeRecord();
+					break;
+				case Ctx::HalfEdge:
+					if (currentKey == "property") {
+						ctx = Ctx::HalfEdgeProperty;
+						halfEdge.hasProperty = true;
+					}
+					break;
+				case Ctx::HalfEdgeCtrlpts:
+					ctx = Ctx::HalfEdgeCtrlpt;
+					point = PointRecord();
+					break;
+				case Ctx::Loops:
+					ctx = Ctx::Loop;
+					loop = LoopRecord();
+					break;
+				case Ctx::LoopCoedges:
+					ctx = Ctx::LoopCoedge;
+					loop.hasCoedgeMarkNum = false;
+					break;
+				case Ctx::Faces:
+					ctx = Ctx::Face;
+					face = FaceRecord();
+					break;
+				case Ctx::Face:
+					if (currentKey == "geometry_info") {
+						ctx = Ctx::FaceGeometry;
+						face.hasGeometry = true;
+					}
+					break;
+				case Ctx::FaceCtrlpts:
+					ctx = Ctx::FaceCtrlpt;
+					point = PointRecord();
+					break;
+				default:
+					break;
+				}
+			}
+
+			stack.push_back(ctx);
+			return true;
+		}
+
+		bool key(json::string_t& val) {
+			currentKey = val;
+			return true;
+		}
+
+		bool end_object() {
+			switch (_Top()) {
+			case Ctx::Vertex:
+				_FinishVertex();
+				break;
+			case Ctx::VertexPoint:
+				vertex.hasPoint = point.mask == 7;
+				vertex.pos = glm::vec3{ point.v[0], point.v[1], point.v[2] };
+				break;
+			case Ctx::Edge:
+				_FinishEdge();
+				break;
+			case Ctx::EdgeCtrlpt:
+			case Ctx::EdgeSampledPoint:
+				_AddEdgePoint(_Top() == Ctx::EdgeCtrlpt);
+				break;
+			case Ctx::HalfEdge:
+				_FinishHalfEdge();
+				break;
+			case Ctx::HalfEdgeCtrlpt:
+				_AddUvPoint();
+				break;
+			case Ctx::Loop:
+				_FinishLoop();
+				break;
+			case Ctx::LoopCoedge:
+				_AddLoopCoedge();
+				break;
+			case Ctx::Face:
+				_FinishFace();
+				break;
+			case Ctx::FaceCtrlpt:
+				_AddFaceCtrlpt();
+				break;
+			default:
+				break;
+			}
+
+			stack.pop_back();
+			return true;
+		}
+
+		bool start_array(std::size_t /*elements*/) {
+			Ctx ctx = Ctx::Skip;
+
+			if (!stack.empty() && !(recordSkipped && _IsRecord(_Top()))) {
+				switch (_Top()) {
+				case Ctx::Root:
+					if (currentKey == "root_vertices") ctx = Ctx::Vertices;
+					else if (currentKey == "root_edges") ctx = Ctx::Edges;
+					else if (currentKey == "root_coedges") ctx = Ctx::HalfEdges;
+					else if (currentKey == "root_loops") ctx = Ctx::Loops;
+					else if (currentKey == "root_faces") ctx = Ctx::Faces;
+					break;
+				case Ctx::Edge:
+					if (currentKey == "sampled_points") {
+						ctx = Ctx::EdgeSampledPoints;
+						edge.hasSampledPoints = true;
+					}
+					break;
+				case Ctx::EdgeProperty:
+					if (currentKey == "ctrlpts") {
+						ctx = Ctx::EdgeCtrlpts;
+						edge.hasCtrlpts = true;
+					}
+					break;
+				case Ctx::HalfEdgeProperty:
+					if (currentKey == "ctrlpts") {
+						ctx = Ctx::HalfEdgeCtrlpts;
+						halfEdge.hasCtrlpts = true;
+					}
+					else if (currentKey == "knots") {
+						ctx = Ctx::Numbers;
+						numbers = &halfEdge.knots;
+						halfEdge.hasKnots = true;
+					}
+					break;
+				case Ctx::Loop:
+					if (currentKey == "coedge_list") {
+						ctx = Ctx::LoopCoedges;
+						loop.hasCoedgeList = true;
+					}
+					break;
+				case Ctx::FaceGeometry:
+					if (currentKey == "control_points") {
+						ctx = Ctx::FaceCtrlpts;
+						face.hasCtrlpts = true;
+					}
+					else {
+						numbers = face.NumberArray(currentKey);
+						if (numbers != nullptr) {
+							ctx = Ctx::Numbers;
+						}
+					}
+					break;
+				default:
+					break;
+				}
+			}
+
+			stack.push_back(ctx);
+			return true;
+		}
+
+		bool end_array() {
+			stack.pop_back();
+			return true;
+		}
+
+		bool parse_error(std::size_t /*position*/, const std::string& /*last_token*/, const nlohmann::detail::exception& ex) {
+			errorMessage = ex.what();
+			return false;
+		}
+
+	protected:
+		// 当前所在的对象/数组
+		enum class Ctx {
+			Root,
+			Skip, // 不关心的子树
+			Stats,
+			Vertices,
+			Vertex,
+			VertexPoint,
+			Edges,
+			Edge,
+			EdgeProperty,
+			EdgeCtrlpts,
+			EdgeCtrlpt,
+			EdgeSampledPoints,
+			EdgeSampledPoint,
+			HalfEdges,
+			HalfEdge,
+			HalfEdgeProperty,
+			HalfEdgeCtrlpts,
+			HalfEdgeCtrlpt,
+			Loops,
+			Loop,
+			LoopCoedges,
+			LoopCoedge,
+			Faces,
+			Face,
+			FaceGeometry,
+			FaceCtrlpts,
+			FaceCtrlpt,
+			Numbers // 数字数组，写入numbers指向的位置
+		};
+
+		bool recordSkipped = false; // 当前记录的body没有选中
+
+		static bool _IsRecord(Ctx ctx) {
+			return ctx == Ctx::Vertex || ctx == Ctx::Edge || ctx == Ctx::HalfEdge || ctx == Ctx::Loop || ctx == Ctx::Face;
+		}
+
+		void _SetBody(int body) {
+			if (!selectedBodies.empty() && selectedBodies.count(body) == 0) {
+				recordSkipped = true;
+			}
+		}
+
+		// 记录结束时调用：记录被跳过时丢弃已经读到的采样点等并返回true
+		bool _SkipRecord() {
+			if (!recordSkipped) {
+				return false;
+			}
+			recordSkipped = false;
+			edgeGeometries.DiscardPending();
+			skippedRecordCount++;
+			return true;
+		}
+
+		// 解析中的一个点：mask的第k位表示第k个分量已经读到（二维点用u、v两个分量）
+		struct PointRecord {
+			float v[3] = { 0.0f, 0.0f, 0.0f };
+			int mask = 0;
+		};
+
+		using PropertyList = std::vector<std::pair<std::string, double>>;
+
+		struct VertexRecord {
+			int bodyId = 0;
+			int markNum = 0;
+			int mask = 0; // 1: body, 2: marknum
+			bool hasPoint = false;
+			glm::vec3 pos{ 0.0f };
+		};
+
+		// 边的标量字段按顺序存放，property中的字段先暂存，等整条记录读完再按curve_type构造几何（键的顺序不保证）
+		enum EdgeField {
+			EDGE_BODY,
+			EDGE_MARKNUM,
+			EDGE_ST_MARKNUM,
+			EDGE_ED_MARKNUM,
+			EDGE_NONMANIFOLD_COUNT,
+			EDGE_FIELD_COUNT
+		};
+
+		static constexpr const char* EDGE_FIELD_NAMES[EDGE_FIELD_COUNT] = { "body", "marknum", "st_marknum", "ed_marknum", "nonmanifold_count" };
+
+		struct EdgeRecord {
+			int fields[EDGE_FIELD_COUNT] = {};
+			int mask = 0;
+			std::string curveType;
+			bool hasProperty = false;
+			bool hasCtrlpts = false;
+			bool hasSampledPoints = false;
+			bool failed = false;
+			bool ctrlptsFailed = false;
+			PropertyList property;
+			// 采样点和控制点直接追加到edgeGeometries中，读完整条记录后再决定保留还是丢弃
+			uint64_t recordOffset = 0; // 延迟解码时整条记录在文件中的范围
+			uint32_t recordSize = 0;
+		};
+
+		// 半边（文件中的coedge）
+		enum HalfEdgeField {
+			HALF_EDGE_BODY,
+			HALF_EDGE_MARKNUM,
+			HALF_EDGE_EDGE_MARKNUM,
+			HALF_EDGE_LOOP_MARKNUM,
+			HALF_EDGE_SENSE,
+			HALF_EDGE_FIELD_COUNT
+		};
+
+		static constexpr const char* HALF_EDGE_FIELD_NAMES[HALF_EDGE_FIELD_COUNT] = { "body", "marknum", "edge_marknum", "loop_marknum", "sense" };
+
+		struct HalfEdgeRecord {
+			int fields[HALF_EDGE_FIELD_COUNT] = {};
+			int mask = 0;
+			bool hasProperty = false;
+			std::string curveName;
+			PropertyList property;
+			bool hasCtrlpts = false;
+			bool ctrlptsFailed = false;
+			bool hasKnots = false;
+			std::vector<glm::vec2> ctrlpts;
+			std::vector<double> knots;
+		};
+
+		enum LoopField {
+			LOOP_BODY,
+			LOOP_MARKNUM,
+			LOOP_FACE_MARKNUM,
+			LOOP_FIELD_COUNT
+		};
+
+		static constexpr const char* LOOP_FIELD_NAMES[LOOP_FIELD_COUNT] = { "body", "marknum", "face_marknum" };
+
+		struct LoopRecord {
+			int fields[LOOP_FIELD_COUNT] = {};
+			int mask = 0;
+			bool hasCoedgeList = false;
+			bool failed = false; // coedge_list中有缺少coedge_marknum的元素
+			std::vector<int> halfEdgesMarkNums;
+
+			// 正在读取的coedge_list元素
+			int coedgeMarkNum = 0;
+			bool hasCoedgeMarkNum = false;
+		};
+
+		enum FaceField {
+			FACE_BODY,
+			FACE_MARKNUM,
+			FACE_LOOP_MARKNUM,
+			FACE_FIELD_COUNT
+		};
+
+		static constexpr const char* FACE_FIELD_NAMES[FACE_FIELD_COUNT] = { "body", "marknum", "loop_marknum" };
+
+		// geometry_info中的标量字段先暂存，等整条记录读完再按face_type构造几何
+		struct FaceRecord {
+			int fields[FACE_FIELD_COUNT] = {};
+			int mask = 0;
+			bool hasGeometry = false;
+			std::string faceType;
+			PropertyList property;
+			bool hasCtrlpts = false;
+			bool ctrlptsFailed = false;
+			std::vector<glm::vec3> ctrlpts;
+			bool hasKnotsU = false;
+			bool hasKnotsV = false;
+			bool hasWeights = false;
+			std::vector<double> knotsU;
+			std::vector<double> knotsV;
+			std::vector<double> weights;
+
+			// geometry_info中名为key的数字数组，不关心的键返回nullptr
+			template<typename K>
+			std::vector<double>* NumberArray(const K& key) {
+				if (key == "knots_u") {
+					hasKnotsU = true;
+					return &knotsU;
+				}
+				if (key == "knots_v") {
+					hasKnotsV = true;
+					return &knotsV;
+				}
+				if (key == "weights") {
+					hasWeights = true;
+					return &weights;
+				}
+				return nullptr;
+			}
+		};
+
+		std::vector<Ctx> stack;
+		std::string currentKey;
+
+		PointRecord point;
+		VertexRecord vertex;
+		EdgeRecord edge;
+		HalfEdgeRecord halfEdge;
+		LoopRecord loop;
+		FaceRecord face;
+		std::vector<double>* numbers = nullptr;
+
+		Ctx _Top() const {
+			return stack.back();
+		}
+
+		static int _AxisIndex(const std::string& key) {
+			if (key.size() != 1) return -1;
+			if (key[0] == 'x') return 0;
+			if (key[0] == 'y') return 1;
+			if (key[0] == 'z') return 2;
+			return -1;
+		}
+
+		static int _UvIndex(const std::string& key) {
+			if (key.size() != 1) return -1;
+			if (key[0] == 'u') return 0;
+			if (key[0] == 'v') return 1;
+			return -1;
+		}
+
+		// 按字段名表设置记录的标量字段，key不在表中时返回false
+		template<typename K>
+		static bool _SetField(const char* const* names, int count, const K& key, double val, int* fields, int& mask) {
+			for (int f = 0; f < count; f++) {
+				if (key == names[f]) {
+					fields[f] = static_cast<int>(val);
+					mask |= 1 << f;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void _Number(double val) {
+			if (currentKey == "body" && _IsRecord(_Top())) {
+				_SetBody(static_cast<int>(val));
+			}
+
+			switch (_Top()) {
+			case Ctx::Stats:
+				basicStatistics[currentKey] = static_cast<int>(val);
+				break;
+			case Ctx::Vertex:
+				if (currentKey == "body") {
+					vertex.bodyId = static_cast<int>(val);
+					vertex.mask |= 1;
+				}
+				else if (currentKey == "marknum") {
+					vertex.markNum = static_cast<int>(val);
+					vertex.mask |= 2;
+				}
+				break;
+			case Ctx::VertexPoint:
+			case Ctx::EdgeCtrlpt:
+			case Ctx::EdgeSampledPoint:
+			case Ctx::FaceCtrlpt:
+			case Ctx::HalfEdgeCtrlpt: {
+				int axis = _Top() == Ctx::HalfEdgeCtrlpt ? _UvIndex(currentKey) : _AxisIndex(currentKey);
+				if (axis >= 0) {
+					point.v[axis] = static_cast<float>(val);
+					point.mask |= 1 << axis;
+				}
+				break;
+			}
+			case Ctx::Edge:
+				_SetField(EDGE_FIELD_NAMES, EDGE_FIELD_COUNT, currentKey, val, edge.fields, edge.mask);
+				break;
+			case Ctx::EdgeProperty:
+				edge.property.emplace_back(currentKey, val);
+				break;
+			case Ctx::HalfEdge:
+				_SetField(HALF_EDGE_FIELD_NAMES, HALF_EDGE_FIELD_COUNT, currentKey, val, halfEdge.fields, halfEdge.mask);
+				break;
+			case Ctx::HalfEdgeProperty:
+				halfEdge.property.emplace_back(currentKey, val);
+				break;
+			case Ctx::Loop:
+				_SetField(LOOP_FIELD_NAMES, LOOP_FIELD_COUNT, currentKey, val, loop.fields, loop.mask);
+				break;
+			case Ctx::LoopCoedge:
+				if (currentKey == "coedge_marknum") {
+					loop.coedgeMarkNum = static_cast<int>(val);
+					loop.hasCoedgeMarkNum = true;
+				}
+				break;
+			case Ctx::Face:
+				_SetField(FACE_FIELD_NAMES, FACE_FIELD_COUNT, currentKey, val, face.fields, face.mask);
+				break;
+			case Ctx::FaceGeometry:
+				face.property.emplace_back(currentKey, val);
+				break;
+			case Ctx::Numbers:
+				numbers->push_back(val);
+				break;
+			default:
+				break;
+			}
+		}
+
+		void _AddUvPoint() {
+			if (point.mask != 3) {
+				halfEdge.ctrlptsFailed = true;
+			}
+			else {
+				halfEdge.ctrlpts.emplace_back(point.v[0], point.v[1]);
+			}
+		}
+
+		void _AddLoopCoedge() {
+			if (!loop.hasCoedgeMarkNum) {
+				loop.failed = true;
+			}
+			else {
+				loop.halfEdgesMarkNums.push_back(loop.coedgeMarkNum);
+			}
+		}
+
+		void _AddFaceCtrlpt() {
+			if (point.mask != 7) {
+				face.ctrlptsFailed = true;
+			}
+			else {
+				face.ctrlpts.emplace_back(point.v[0], point.v[1], point.v[2]);
+			}
+		}
+
+		// mask中没有读到的标量字段记入failures
+		static void _AddMissingFields(const char* const* names, int count, int mask, Utils::FieldFailures& failures) {
+			for (int i = 0; i < count; i++) {
+				if ((mask & (1 << i)) == 0) {
+					failures.AddField(names[i]);
+				}
+			}
+		}
+
+		void _FinishVertex() {
+			if (_SkipRecord()) {
+				return;
+			}
+
+			vertexInfos.emplace_back();
+
+			if (vertex.mask != 3 || !vertex.hasPoint) {
+				static const char* const names[2] = { "body", "marknum" };
+				_AddMissingFields(names, 2, vertex.mask, vertexFailures);
+				if (!vertex.hasPoint) {
+					vertexFailures.AddField("point");
+				}
+				vertexFailures.failedRecords++;
+				return;
+			}
+
+			VertexInfo& info = vertexInfos.back();
+			info.pos = vertex.pos;
+			info.bodyId = vertex.bodyId;
+			info.markNum = vertex.markNum;
+		}
+
+		// 从暂存的property中取出若干字段（转成T，边的字段与原来 float x = property.at("x") 一致），缺少任何一个返回false
+		template<typename T>
+		static bool _GetProperty(const PropertyList& property, std::initializer_list<const char*> names, T* out) {
+			int i = 0;
+			for (const char* name : names) {
+				bool found = false;
+				for (auto& kv : property) {
+					if (kv.first == name) {
+						out[i] = static_cast<T>(kv.second);
+						found = true;
+						break;
+					}
+				}
+				if (!found) {
+					return false;
+				}
+				i++;
+			}
+			return true;
+		}
+
+		void _AddEdgePoint(bool ctrlpt) {
+			if (point.mask != 7) {
+				// 原来的 at("x") 等会抛出异常（控制点只有intcurve才会读取）
+				(ctrlpt ? edge.ctrlptsFailed : edge.failed) = true;
+			}
+			else {
+				(ctrlpt ? edgeGeometries.intcurveCtrlpts : edgeGeometries.sampledPoints).emplace_back(point.v[0], point.v[1], point.v[2]);
+			}
+		}
+
+		// 按curve_type把参数加入对应的参数表，返回参数下标，缺少字段时返回-1
+		int _AddEdgeParams(CurveType curve_type) {
+			if (curve_type == CurveType::STRAIGHT) {
+				float v[6];
+				if (!edge.hasProperty || !_GetProperty(edge.property, { "root_point_x", "root_point_y", "root_point_z", "direction_x", "direction_y", "direction_z" }, v)) {
+					return -1;
+				}
+
+				StraightCurveParams params;
+				params.rootPoint = glm::vec3{ v[0], v[1], v[2] };
+				params.direction = glm::vec3{ v[3], v[4], v[5] };
+				edgeGeometries.straights.push_back(params);
+				return static_cast<int>(edgeGeometries.straights.size()) - 1;
+			}
+			else if (curve_type == CurveType::INTCURVE) {
+				if (!edge.hasProperty || !edge.hasCtrlpts || edge.ctrlptsFailed) {
+					return -1;
+				}
+
+				return edgeGeometries.AddIntcurveCtrlpts();
+			}
+			else if (curve_type == CurveType::ELLIPSE) {
+				float v[11];
+				if (!edge.hasProperty || !_GetProperty(edge.property, { "centre_x", "centre_y", "centre_z", "normal_x", "normal_y", "normal_z",
+					"major_axis_x", "major_axis_y", "major_axis_z", "major_length", "minor_length" }, v)) {
+					return -1;
+				}
+
+				EllipseCurveParams params;
+				params.centre = glm::vec3{ v[0], v[1], v[2] };
+				params.normal = glm::vec3{ v[3], v[4], v[5] };
+				params.majorAxis = glm::vec3{ v[6], v[7], v[8] };
+				params.majorAxisLength = v[9];
+				params.minorAxisLength = v[10];
+				edgeGeometries.ellipses.push_back(params);
+				return static_cast<int>(edgeGeometries.ellipses.size()) - 1;
+			}
+
+			return edgeGeometries.AddOtherCurveType(edge.curveType);
+		}
+
+		void _FinishEdge() {
+			if (_SkipRecord()) {
+				return;
+			}
+
+			edgeInfos.emplace_back();
+
+			CurveType curve_type = CurveTypeFromName(edge.curveType);
+			bool lazy = lazyEdgeProperty && curve_type != CurveType::OTHER; // property缺少字段要等到解码时才会发现
+			int param_index = -1;
+			bool ok = !edge.failed && edge.mask == (1 << EDGE_FIELD_COUNT) - 1 && edge.hasSampledPoints;
+			if (ok) {
+				param_index = lazy ? EdgeGeometryTable::PARAMS_PENDING : _AddEdgeParams(curve_type);
+				ok = lazy || param_index >= 0;
+			}
+
+			if (curve_type != CurveType::INTCURVE || !ok) {
+				edgeGeometries.intcurveCtrlpts.resize(edgeGeometries.intcurveCtrlptOffsets.back()); // 只有intcurve保留控制点
+			}
+
+			if (!ok) {
+				edgeGeometries.DiscardPending();
+				_AddMissingFields(EDGE_FIELD_NAMES, EDGE_FIELD_COUNT, edge.mask, edgeFailures);
+				if (!edge.hasSampledPoints || edge.failed) {
+					edgeFailures.AddField("sampled_points");
+				}
+				else if (edge.mask == (1 << EDGE_FIELD_COUNT) - 1) {
+					edgeFailures.AddField("property");
+				}
+				edgeFailures.failedRecords++;
+				return;
+			}
+
+			EdgeInfo& info = edgeInfos.back();
+			info.bodyId = edge.fields[EDGE_BODY];
+			info.markNum = edge.fields[EDGE_MARKNUM];
+			info.stMarkNum = edge.fields[EDGE_ST_MARKNUM];
+			info.edMarkNum = edge.fields[EDGE_ED_MARKNUM];
+			info.nonmanifoldCount = edge.fields[EDGE_NONMANIFOLD_COUNT];
+			info.geometryIndex = edgeGeometries.AddRow(curve_type, param_index);
+			if (lazyEdgeProperty) {
+				edgeGeometries.AddRecordRange(edge.recordOffset, edge.recordSize);
+			}
+
+			size_t point_count = edgeGeometries.PointCount(info.geometryIndex);
+			if (point_count > 0) {
+				const glm::vec3* points = edgeGeometries.Points(info.geometryIndex);
+				info.pos = (points[0] + points[point_count - 1]) / 2.0f;
+			}
+		}
+
+		// 没有property的半边只记录curve_name（为空）；pcurve需要curve_degree、ctrlpts、knots
+		std::unique_ptr<HalfEdgeGeometry> _BuildHalfEdgeGeometry() {
+			if (halfEdge.curveName == "pcurve") {
+				int degree;
+				if (!_GetProperty(halfEdge.property, { "curve_degree" }, &degree) || !halfEdge.hasCtrlpts || halfEdge.ctrlptsFailed || !halfEdge.hasKnots) {
+					return nullptr;
+				}
+
+				auto geometry_ptr = std::make_unique<PcurveHalfEdgeGeometry>();
+				geometry_ptr->curveDegree = degree;
+				geometry_ptr->ctrlpts = std::move(halfEdge.ctrlpts);
+				geometry_ptr->knots = std::move(halfEdge.knots);
+				return geometry_ptr;
+			}
+
+			return std::make_unique<HalfEdgeGeometry>();
+		}
+
+		void _FinishHalfEdge() {
+			if (_SkipRecord()) {
+				return;
+			}
+
+			halfEdgeInfos.emplace_back();
+
+			std::unique_ptr<HalfEdgeGeometry> geometry_ptr;
+			bool ok = halfEdge.mask == (1 << HALF_EDGE_FIELD_COUNT) - 1;
+			if (ok) {
+				geometry_ptr = _BuildHalfEdgeGeometry();
+				ok = geometry_ptr != nullptr;
+			}
+
+			if (!ok) {
+				_AddMissingFields(HALF_EDGE_FIELD_NAMES, HALF_EDGE_FIELD_COUNT, halfEdge.mask, halfEdgeFailures);
+				if (halfEdge.mask == (1 << HALF_EDGE_FIELD_COUNT) - 1) {
+					halfEdgeFailures.AddField("property");
+				}
+				halfEdgeFailures.failedRecords++;
+				return;
+			}
+
+			HalfEdgeInfo& info = halfEdgeInfos.back();
+			info.bodyId = halfEdge.fields[HALF_EDGE_BODY];
+			info.markNum = halfEdge.fields[HALF_EDGE_MARKNUM];
+			info.edgeMarkNum = halfEdge.fields[HALF_EDGE_EDGE_MARKNUM];
+			info.loopMarkNum = halfEdge.fields[HALF_EDGE_LOOP_MARKNUM];
+			info.sense = halfEdge.fields[HALF_EDGE_SENSE] != 0;
+
+			// 文件中没有给出，见SatInfo::_LinkTopology
+			info.partnerMarkNum = -1;
+			info.preMarkNum = -1;
+			info.nextMarkNum = -1;
+
+			geometry_ptr->curveType = std::move(halfEdge.curveName);
+			info.halfEdgeGeometry = std::move(geometry_ptr);
+		}
+
+		void _FinishLoop() {
+			if (_SkipRecord()) {
+				return;
+			}
+
+			loopInfos.emplace_back();
+
+			if (loop.mask != (1 << LOOP_FIELD_COUNT) - 1 || !loop.hasCoedgeList || loop.failed) {
+				_AddMissingFields(LOOP_FIELD_NAMES, LOOP_FIELD_COUNT, loop.mask, loopFailures);
+				if (!loop.hasCoedgeList || loop.failed) {
+					loopFailures.AddField("coedge_list");
+				}
+				loopFailures.failedRecords++;
+				return;
+			}
+
+			LoopInfo& info = loopInfos.back();
+			info.bodyId = loop.fields[LOOP_BODY];
+			info.markNum = loop.fields[LOOP_MARKNUM];
+			info.faceMarkNum = loop.fields[LOOP_FACE_MARKNUM];
+			info.halfEdgesMarkNums = std::move(loop.halfEdgesMarkNums);
+		}
+
+		std::unique_ptr<FaceGeometry> _BuildFaceGeometry() {
+			if (face.faceType == "plane") {
+				double v[6];
+				if (!_GetProperty(face.property, { "root_point_x", "root_point_y", "root_point_z", "normal_x", "normal_y", "normal_z" }, v)) {
+					return nullptr;
+				}
+
+				auto geometry_ptr = std::make_unique<PlaneFaceGeometry>();
+				geometry_ptr->rootPoint = glm::vec3{ v[0], v[1], v[2] };
+				geometry_ptr->normal = glm::vec3{ v[3], v[4], v[5] };
+				return geometry_ptr;
+			}
+			else if (face.faceType == "sphere") {
+				double v[4];
+				if (!_GetProperty(face.property, { "centre_x", "centre_y", "centre_z", "radius" }, v)) {
+					return nullptr;
+				}
+
+				auto geometry_ptr = std::make_unique<SphereFaceGeometry>();
+				geometry_ptr->centre = glm::vec3{ v[0], v[1], v[2] };
+				geometry_ptr->radius = v[3];
+				return geometry_ptr;
+			}
+			else if (face.faceType == "torus") {
+				double v[8];
+				if (!_GetProperty(face.property, { "centre_x", "centre_y", "centre_z", "normal_x", "normal_y", "normal_z", "minor_radius", "major_radius" }, v)) {
+					return nullptr;
+				}
+
+				auto geometry_ptr = std::make_unique<TorusFaceGeometry>();
+				geometry_ptr->centre = glm::vec3{ v[0], v[1], v[2] };
+				geometry_ptr->normal = glm::vec3{ v[3], v[4], v[5] };
+				geometry_ptr->minorRadius = v[6];
+				geometry_ptr->majorRadius = v[7];
+				return geometry_ptr;
+			}
+			else if (face.faceType == "cone") {
+				double v[13];
+				if (!_GetProperty(face.property, { "root_point_x", "root_point_y", "root_point_z", "major_axis_x", "major_axis_y", "major_axis_z", "ratio",
+					"direction_x", "direction_y", "direction_z", "cos", "sin", "angle" }, v)) {
+					return nullptr;
+				}
+
+				auto geometry_ptr = std::make_unique<ConeFaceGeometry>();
+				geometry_ptr->rootPoint = glm::vec3{ v[0], v[1], v[2] };
+				geometry_ptr->majorAxis = glm::vec3{ v[3], v[4], v[5] };
+				geometry_ptr->ratio = v[6];
+				geometry_ptr->direction = glm::vec3{ v[7], v[8], v[9] };
+				geometry_ptr->cos = v[10];
+				geometry_ptr->sin = v[11];
+				geometry_ptr->angle = v[12];
+				return geometry_ptr;
+			}
+			else if (face.faceType == "spline") {
+				int v[8];
+				if (!_GetProperty(face.property, { "degree_u", "degree_v", "num_u", "num_v", "num_knots_u", "num_knots_v", "weight_num_u", "weight_num_v" }, v)
+					|| !face.hasCtrlpts || face.ctrlptsFailed || !face.hasKnotsU || !face.hasKnotsV || !face.hasWeights) {
+					return nullptr;
+				}
+
+				auto geometry_ptr = std::make_unique<SplineFaceGeometry>();
+				geometry_ptr->degreeU = v[0];
+				geometry_ptr->degreeV = v[1];
+				geometry_ptr->numU = v[2];
+				geometry_ptr->numV = v[3];
+				geometry_ptr->numKnotsU = v[4];
+				geometry_ptr->numKnotsV = v[5];
+				geometry_ptr->numWeightU = v[6];
+				geometry_ptr->numWeightV = v[7];
+				geometry_ptr->ctrlpts = std::move(face.ctrlpts);
+				geometry_ptr->uknots = std::move(face.knotsU);
+				geometry_ptr->vknots = std::move(face.knotsV);
+				geometry_ptr->weights = std::move(face.weights);
+				return geometry_ptr;
+			}
+
+			return std::make_unique<FaceGeometry>();
+		}
+
+		void _FinishFace() {
+			if (_SkipRecord()) {
+				return;
+			}
+
+			faceInfos.emplace_back();
+
+			std::unique_ptr<FaceGeometry> geometry_ptr;
+			bool ok = face.mask == (1 << FACE_FIELD_COUNT) - 1 && face.hasGeometry;
+			if (ok) {
+				geometry_ptr = _BuildFaceGeometry();
+				ok = geometry_ptr != nullptr;
+			}
+
+			if (!ok) {
+				_AddMissingFields(FACE_FIELD_NAMES, FACE_FIELD_COUNT, face.mask, faceFailures);
+				if (face.mask == (1 << FACE_FIELD_COUNT) - 1) {
+					faceFailures.AddField("geometry_info");
+				}
+				faceFailures.failedRecords++;
+				return;
+			}
+
+			FaceInfo& info = faceInfos.back();
+			info.bodyId = face.fields[FACE_BODY];
+			info.markNum = face.fields[FACE_MARKNUM];
+			info.stLoopMarkNum = face.fields[FACE_LOOP_MARKNUM];
+
+			geometry_ptr->faceType = std::move(face.faceType);
+			info.faceGeometry = std::move(geometry_ptr);
+		}
+	};
+}
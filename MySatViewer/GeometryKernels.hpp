@@ -0,0 +1,557 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "ThreadPool.hpp"
+
+// MSVC的ARM64等非x86目标没有SSE/AVX内建函数，和其他平台一样只用标量实现
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define GEOMETRY_KERNELS_X86 1
+#define GEOMETRY_KERNELS_NO_CONTRACT
+#define GEOMETRY_KERNELS_TARGET_AVX2
+#define GEOMETRY_KERNELS_TARGET_AVX512
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define GEOMETRY_KERNELS_X86 1
+// 只为单个函数开启指令集，不要求整个工程用 -mavx2 编译
+// GCC开启avx512f后会把相邻的乘法和减法合并为fma，这里关掉，保证各版本和标量版本的结果逐位一致
+#if defined(__clang__)
+#define GEOMETRY_KERNELS_NO_CONTRACT
+#else
+#define GEOMETRY_KERNELS_NO_CONTRACT __attribute__((optimize("fp-contract=off")))
+#endif
+#define GEOMETRY_KERNELS_TARGET_AVX2 __attribute__((target("avx2"))) GEOMETRY_KERNELS_NO_CONTRACT
+#define GEOMETRY_KERNELS_TARGET_AVX512 __attribute__((target("avx512f"))) GEOMETRY_KERNELS_NO_CONTRACT
+#else
+#define GEOMETRY_KERNELS_X86 0
+#define GEOMETRY_KERNELS_NO_CONTRACT
+#endif
+
+/*
+	三角形几何计算内核
+	用途：STL/OBJ加载时一次遍历同时求出每个三角形的面法向和包围盒
+	调用方给出每个三角形角点坐标的位置，内核求出法向（normalize(cross(p1 - p0, p2 - p0))）并累计包围盒，
+	最后按渲染用的顶点布局写出：每个三角形18个float，3个角点各为（坐标3个 + 法向3个）
+	运行时按CPU支持选择 AVX-512（每次16个三角形）/ AVX2（每次8个三角形）/ 标量 实现，三者结果逐位一致
+	SIMD实现先把一批（至多BATCH_SIZE个）三角形按SoA布局填入TriangleBatch；标量实现和小输入直接逐个三角形处理，不经过SoA批
+*/
+
+namespace GeometryKernels {
+
+	enum class Isa {
+		Scalar,
+		AVX2,
+		AVX512
+	};
+
+	const char* IsaName(Isa isa) {
+		switch (isa) {
+		case Isa::AVX2: return "AVX2";
+		case Isa::AVX512: return "AVX-512";
+		default: return "Scalar";
+		}
+	}
+
+	struct Bounds {
+		glm::vec3 min{ std::numeric_limits<float>::max() };
+		glm::vec3 max{ std::numeric_limits<float>::lowest() };
+
+		void Merge(const Bounds& other) {
+			min = glm::min(min, other.min);
+			max = glm::max(max, other.max);
+		}
+	};
+
+	// 检查CPU和操作系统是否支持对应的指令集（操作系统需要保存ymm/zmm寄存器）
+	Isa DetectIsa() {
+#if GEOMETRY_KERNELS_X86
+		unsigned int regs1[4] = { 0, 0, 0, 0 };
+		unsigned int regs7[4] = { 0, 0, 0, 0 };
+#if defined(_MSC_VER)
+		int r[4];
+		__cpuid(r, 0);
+		int max_leaf = r[0];
+		__cpuidex(r, 1, 0);
+		for (int i = 0; i < 4; i++) regs1[i] = static_cast<unsigned int>(r[i]);
+		if (max_leaf >= 7) {
+			__cpuidex(r, 7, 0);
+			for (int i = 0; i < 4; i++) regs7[i] = static_cast<unsigned int>(r[i]);
+		}
+#else
+		unsigned int max_leaf = __get_cpuid_max(0, nullptr);
+		__cpuid_count(1, 0, regs1[0], regs1[1], regs1[2], regs1[3]);
+		if (max_leaf >= 7) {
+			__cpuid_count(7, 0, regs7[0], regs7[1], regs7[2], regs7[3]);
+		}
+#endif
+		bool osxsave = (regs1[2] & (1u << 27)) != 0;
+		if (!osxsave) {
+			return Isa::Scalar;
+		}
+
+#if defined(_MSC_VER)
+		unsigned long long xcr0 = _xgetbv(0);
+#else
+		unsigned int xcr0_lo, xcr0_hi;
+		__asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+		unsigned long long xcr0 = (static_cast<unsigned long long>(xcr0_hi) << 32) | xcr0_lo;
+#endif
+		bool os_avx = (xcr0 & 0x6) == 0x6; // xmm + ymm
+		bool os_avx512 = (xcr0 & 0xE6) == 0xE6; // xmm + ymm + opmask + zmm
+
+		bool avx2 = (regs7[1] & (1u << 5)) != 0;
+		bool avx512f = (regs7[1] & (1u << 16)) != 0;
+
+		if (avx512f && os_avx512) {
+			return Isa::AVX512;
+		}
+		if (avx2 && os_avx) {
+			return Isa::AVX2;
+		}
+#endif
+		return Isa::Scalar;
+	}
+
+	// 本机可用的最好指令集（只检测一次）
+	Isa BestIsa() {
+		static Isa best_isa = DetectIsa();
+		return best_isa;
+	}
+
+	const size_t BATCH_SIZE = 256;
+
+	// 一批三角形的坐标和法向（SoA）：p[3 * c + k][i] 为第i个三角形第c个角点的第k个分量，n[k][i] 为第i个三角形法向的第k个分量
+	struct TriangleBatch {
+		alignas(64) float p[9][BATCH_SIZE];
+		alignas(64) float n[3][BATCH_SIZE];
+
+		// xyz不要求对齐（例如直接指向二进制STL记录）
+		void SetCorner(size_t i, int corner, const void* xyz) {
+			float v[3];
+			std::memcpy(v, xyz, sizeof(v));
+			p[3 * corner + 0][i] = v[0];
+			p[3 * corner + 1][i] = v[1];
+			p[3 * corner + 2][i] = v[2];
+		}
+	};
+
+	// 标量版本，也用于处理SIMD剩下的尾部：处理批内 [begin, end)
+	GEOMETRY_KERNELS_NO_CONTRACT
+	void FlatNormalsAndBoundsScalar(TriangleBatch& batch, size_t begin, size_t end, Bounds& bounds) {
+		// 用局部变量累计，避免写法向时编译器认为可能改到bounds而反复读写
+		glm::vec3 min_pos = bounds.min;
+		glm::vec3 max_pos = bounds.max;
+
+		for (size_t i = begin; i < end; i++) {
+			float e1x = batch.p[3][i] - batch.p[0][i], e1y = batch.p[4][i] - batch.p[1][i], e1z = batch.p[5][i] - batch.p[2][i];
+			float e2x = batch.p[6][i] - batch.p[0][i], e2y = batch.p[7][i] - batch.p[1][i], e2z = batch.p[8][i] - batch.p[2][i];
+
+			float nx = e1y * e2z - e2y * e1z;
+			float ny = e1z * e2x - e2z * e1x;
+			float nz = e1x * e2y - e2x * e1y;
+
+			float inv_len = 1.0f / std::sqrt((nx * nx + ny * ny) + nz * nz);
+			batch.n[0][i] = nx * inv_len;
+			batch.n[1][i] = ny * inv_len;
+			batch.n[2][i] = nz * inv_len;
+
+			for (int c = 0; c < 3; c++) {
+				for (int k = 0; k < 3; k++) {
+					min_pos[k] = std::min(min_pos[k], batch.p[3 * c + k][i]);
+					max_pos[k] = std::max(max_pos[k], batch.p[3 * c + k][i]);
+				}
+			}
+		}
+
+		bounds.min = min_pos;
+		bounds.max = max_pos;
+	}
+
+#if GEOMETRY_KERNELS_X86
+	// AVX2：每次8个三角形
+	GEOMETRY_KERNELS_TARGET_AVX2
+	void FlatNormalsAndBoundsAVX2(TriangleBatch& batch, size_t count, Bounds& bounds) {
+		__m256 min_v[3], max_v[3];
+		for (int k = 0; k < 3; k++) {
+			min_v[k] = _mm256_set1_ps(bounds.min[k]);
+			max_v[k] = _mm256_set1_ps(bounds.max[k]);
+		}
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256 p[9];
+			for (int j = 0; j < 9; j++) {
+				p[j] = _mm256_load_ps(batch.p[j] + i);
+				min_v[j % 3] = _mm256_min_ps(min_v[j % 3], p[j]);
+				max_v[j % 3] = _mm256_max_ps(max_v[j % 3], p[j]);
+			}
+
+			__m256 e1x = _mm256_sub_ps(p[3], p[0]), e1y = _mm256_sub_ps(p[4], p[1]), e1z = _mm256_sub_ps(p[5], p[2]);
+			__m256 e2x = _mm256_sub_ps(p[6], p[0]), e2y = _mm256_sub_ps(p[7], p[1]), e2z = _mm256_sub_ps(p[8], p[2]);
+
+			__m256 nx = _mm256_sub_ps(_mm256_mul_ps(e1y, e2z), _mm256_mul_ps(e2y, e1z));
+			__m256 ny = _mm256_sub_ps(_mm256_mul_ps(e1z, e2x), _mm256_mul_ps(e2z, e1x));
+			__m256 nz = _mm256_sub_ps(_mm256_mul_ps(e1x, e2y), _mm256_mul_ps(e2x, e1y));
+
+			__m256 len2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, nx), _mm256_mul_ps(ny, ny)), _mm256_mul_ps(nz, nz));
+			__m256 inv_len = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(len2));
+
+			_mm256_store_ps(batch.n[0] + i, _mm256_mul_ps(nx, inv_len));
+			_mm256_store_ps(batch.n[1] + i, _mm256_mul_ps(ny, inv_len));
+			_mm256_store_ps(batch.n[2] + i, _mm256_mul_ps(nz, inv_len));
+		}
+
+		alignas(32) float lane[8];
+		for (int k = 0; k < 3; k++) {
+			_mm256_store_ps(lane, min_v[k]);
+			bounds.min[k] = *std::min_element(lane, lane + 8);
+			_mm256_store_ps(lane, max_v[k]);
+			bounds.max[k] = *std::max_element(lane, lane + 8);
+		}
+
+		FlatNormalsAndBoundsScalar(batch, i, count, bounds);
+	}
+
+	// AVX-512：每次16个三角形
+	GEOMETRY_KERNELS_TARGET_AVX512
+	void FlatNormalsAndBoundsAVX512(TriangleBatch& batch, size_t count, Bounds& bounds) {
+		__m512 min_v[3], max_v[3];
+		for (int k = 0; k < 3; k++) {
+			min_v[k] = _mm512_set1_ps(bounds.min[k]);
+			max_v[k] = _mm512_set1_ps(bounds.max[k]);
+		}
+
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16) {
+			__m512 p[9];
+			for (int j = 0; j < 9; j++) {
+				p[j] = _mm512_load_ps(batch.p[j] + i);
+				min_v[j % 3] = _mm512_min_ps(min_v[j % 3], p[j]);
+				max_v[j % 3] = _mm512_max_ps(max_v[j % 3], p[j]);
+			}
+
+			__m512 e1x = _mm512_sub_ps(p[3], p[0]), e1y = _mm512_sub_ps(p[4], p[1]), e1z = _mm512_sub_ps(p[5], p[2]);
+			__m512 e2x = _mm512_sub_ps(p[6], p[0]), e2y = _mm512_sub_ps(p[7], p[1]), e2z = _mm512_sub_ps(p[8], p[2]);
+
+			__m512 nx = _mm512_sub_ps(_mm512_mul_ps(e1y, e2z), _mm512_mul_ps(e2y, e1z));
+			__m512 ny = _mm512_sub_ps(_mm512_mul_ps(e1z, e2x), _mm512_mul_ps(e2z, e1x));
+			__m512 nz = _mm512_sub_ps(_mm512_mul_ps(e1x, e2y), _mm512_mul_ps(e2x, e1y));
+
+			__m512 len2 = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(nx, nx), _mm512_mul_ps(ny, ny)), _mm512_mul_ps(nz, nz));
+			__m512 inv_len = _mm512_div_ps(_mm512_set1_ps(1.0f), _mm512_sqrt_ps(len2));
+
+			_mm512_store_ps(batch.n[0] + i, _mm512_mul_ps(nx, inv_len));
+			_mm512_store_ps(batch.n[1] + i, _mm512_mul_ps(ny, inv_len));
+			_mm512_store_ps(batch.n[2] + i, _mm512_mul_ps(nz, inv_len));
+		}
+
+		for (int k = 0; k < 3; k++) {
+			bounds.min[k] = _mm512_reduce_min_ps(min_v[k]);
+			bounds.max[k] = _mm512_reduce_max_ps(max_v[k]);
+		}
+
+		FlatNormalsAndBoundsScalar(batch, i, count, bounds);
+	}
+#endif
+
+	// 求批内前count个三角形的法向，并把坐标合并进bounds
+	void FlatNormalsAndBounds(TriangleBatch& batch, size_t count, Bounds& bounds, Isa isa = BestIsa()) {
+#if GEOMETRY_KERNELS_X86
+		if (isa == Isa::AVX512) {
+			FlatNormalsAndBoundsAVX512(batch, count, bounds);
+			return;
+		}
+		if (isa == Isa::AVX2) {
+			FlatNormalsAndBoundsAVX2(batch, count, bounds);
+			return;
+		}
+#endif
+		FlatNormalsAndBoundsScalar(batch, 0, count, bounds);
+	}
+
+	// 写出的顶点数组超过该大小时使用non-temporal写（大约是末级缓存的大小，更小的数组留在缓存里反而更快）
+	const size_t STREAMING_BYTES = 32 * 1024 * 1024;
+
+	// 按渲染用的顶点布局写出批内前count个三角形（每个三角形18个float）
+	void WriteTriangleVertices(const TriangleBatch& batch, size_t count, float* out, bool streaming = false) {
+		size_t i = 0;
+#if GEOMETRY_KERNELS_X86
+		// 每4个三角形的同一个角点做一次4x4转置，得到4个 (x, y, z, nx)，再补上 (ny, nz)（SSE2在x64上总是可用）
+		// 4个三角形正好是18个完整的16字节块：先拼到栈上，streaming且目标对齐时用non-temporal写出，避免先把目标读进缓存
+		// （大的顶点数组写完后只会整体上传给GPU，不需要留在缓存里）
+		streaming = streaming && (reinterpret_cast<uintptr_t>(out) % 16) == 0;
+		alignas(16) float block[72];
+		for (; i + 4 <= count; i += 4) {
+			__m128 nx = _mm_load_ps(batch.n[0] + i);
+			__m128 ny = _mm_load_ps(batch.n[1] + i);
+			__m128 nz = _mm_load_ps(batch.n[2] + i);
+			__m128 nyz_lo = _mm_unpacklo_ps(ny, nz); // ny0 nz0 ny1 nz1
+			__m128 nyz_hi = _mm_unpackhi_ps(ny, nz); // ny2 nz2 ny3 nz3
+
+			for (int c = 0; c < 3; c++) {
+				__m128 r0 = _mm_load_ps(batch.p[3 * c + 0] + i);
+				__m128 r1 = _mm_load_ps(batch.p[3 * c + 1] + i);
+				__m128 r2 = _mm_load_ps(batch.p[3 * c + 2] + i);
+				__m128 r3 = nx;
+				_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+				float* corner = block + 6 * c;
+				_mm_storeu_ps(corner + 0 * 18, r0);
+				_mm_storel_pi(reinterpret_cast<__m64*>(corner + 0 * 18 + 4), nyz_lo);
+				_mm_storeu_ps(corner + 1 * 18, r1);
+				_mm_storeh_pi(reinterpret_cast<__m64*>(corner + 1 * 18 + 4), nyz_lo);
+				_mm_storeu_ps(corner + 2 * 18, r2);
+				_mm_storel_pi(reinterpret_cast<__m64*>(corner + 2 * 18 + 4), nyz_hi);
+				_mm_storeu_ps(corner + 3 * 18, r3);
+				_mm_storeh_pi(reinterpret_cast<__m64*>(corner + 3 * 18 + 4), nyz_hi);
+			}
+
+			float* dst = out + 18 * i;
+			if (streaming) {
+				for (int k = 0; k < 72; k += 4) {
+					_mm_stream_ps(dst + k, _mm_load_ps(block + k));
+				}
+			}
+			else {
+				for (int k = 0; k < 72; k += 4) {
+					_mm_storeu_ps(dst + k, _mm_load_ps(block + k));
+				}
+			}
+		}
+		// non-temporal写出的数据要在其他线程读取之前对外可见；没有用到时不需要
+		if (streaming && i > 0) {
+			_mm_sfence();
+		}
+		out += 18 * i;
+#endif
+		for (; i < count; i++) {
+			for (int c = 0; c < 3; c++) {
+				*out++ = batch.p[3 * c + 0][i];
+				*out++ = batch.p[3 * c + 1][i];
+				*out++ = batch.p[3 * c + 2][i];
+				*out++ = batch.n[0][i];
+				*out++ = batch.n[1][i];
+				*out++ = batch.n[2][i];
+			}
+		}
+	}
+
+	// 只求包围盒：count个点，每个点stride个float，前3个为坐标
+	void PointBoundsScalar(const float* data, size_t count, size_t stride, Bounds& bounds) {
+		for (size_t i = 0; i < count; i++) {
+			const float* p = data + i * stride;
+			for (int k = 0; k < 3; k++) {
+				bounds.min[k] = std::min(bounds.min[k], p[k]);
+				bounds.max[k] = std::max(bounds.max[k], p[k]);
+			}
+		}
+	}
+
+#if GEOMETRY_KERNELS_X86
+	GEOMETRY_KERNELS_TARGET_AVX2
+	void PointBoundsAVX2(const float* data, size_t count, size_t stride, Bounds& bounds) {
+		const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride)));
+
+		__m256 min_v[3], max_v[3];
+		for (int k = 0; k < 3; k++) {
+			min_v[k] = _mm256_set1_ps(bounds.min[k]);
+			max_v[k] = _mm256_set1_ps(bounds.max[k]);
+		}
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			const float* base = data + i * stride;
+			for (int k = 0; k < 3; k++) {
+				__m256 v = _mm256_i32gather_ps(base + k, offsets, 4);
+				min_v[k] = _mm256_min_ps(min_v[k], v);
+				max_v[k] = _mm256_max_ps(max_v[k], v);
+			}
+		}
+
+		alignas(32) float lane[8];
+		for (int k = 0; k < 3; k++) {
+			_mm256_store_ps(lane, min_v[k]);
+			bounds.min[k] = *std::min_element(lane, lane + 8);
+			_mm256_store_ps(lane, max_v[k]);
+			bounds.max[k] = *std::max_element(lane, lane + 8);
+		}
+
+		PointBoundsScalar(data + i * stride, count - i, stride, bounds);
+	}
+
+	GEOMETRY_KERNELS_TARGET_AVX512
+	void PointBoundsAVX512(const float* data, size_t count, size_t stride, Bounds& bounds) {
+		const __m512i offsets = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(static_cast<int>(stride)));
+
+		__m512 min_v[3], max_v[3];
+		for (int k = 0; k < 3; k++) {
+			min_v[k] = _mm512_set1_ps(bounds.min[k]);
+			max_v[k] = _mm512_set1_ps(bounds.max[k]);
+		}
+
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16) {
+			const float* base = data + i * stride;
+			for (int k = 0; k < 3; k++) {
+				__m512 v = _mm512_i32gather_ps(offsets, base + k, 4);
+				min_v[k] = _mm512_min_ps(min_v[k], v);
+				max_v[k] = _mm512_max_ps(max_v[k], v);
+			}
+		}
+
+		for (int k = 0; k < 3; k++) {
+			bounds.min[k] = _mm512_reduce_min_ps(min_v[k]);
+			bounds.max[k] = _mm512_reduce_max_ps(max_v[k]);
+		}
+
+		PointBoundsScalar(data + i * stride, count - i, stride, bounds);
+	}
+#endif
+
+	void PointBounds(const float* data, size_t count, size_t stride, Bounds& bounds, Isa isa = BestIsa()) {
+#if GEOMETRY_KERNELS_X86
+		if (isa == Isa::AVX512) {
+			PointBoundsAVX512(data, count, stride, bounds);
+			return;
+		}
+		if (isa == Isa::AVX2) {
+			PointBoundsAVX2(data, count, stride, bounds);
+			return;
+		}
+#endif
+		PointBoundsScalar(data, count, stride, bounds);
+	}
+
+	// 多线程求包围盒
+	Bounds ParallelPointBounds(const float* data, size_t count, size_t stride, Isa isa = BestIsa()) {
+		auto& pool = Utils::ThreadPool::GetInstance();
+		std::vector<Bounds> chunk_bounds(pool.ChunkCount(count));
+
+		pool.ParallelFor(count, [&](size_t begin, size_t end, size_t chunk_index) {
+			PointBounds(data + begin * stride, end - begin, stride, chunk_bounds[chunk_index], isa);
+		});
+
+		Bounds res;
+		for (auto& bounds : chunk_bounds) {
+			res.Merge(bounds);
+		}
+		return res;
+	}
+
+	// 标量路径：直接逐个三角形读取角点、写出顶点，不经过SoA批；运算顺序与FlatNormalsAndBoundsScalar相同，结果逐位一致
+	template <typename F>
+	GEOMETRY_KERNELS_NO_CONTRACT
+	void FillTrianglesScalar(float* vertices, size_t begin, size_t end, F& corner_coords, Bounds& bounds) {
+		// 包围盒和坐标都放在单独的局部变量中，使其留在寄存器里：
+		// 按下标访问glm::vec3或把角点拷贝到数组里，编译器会经过栈并合并为互相重叠的宽读写，无法store forwarding
+		float min_x = bounds.min.x, min_y = bounds.min.y, min_z = bounds.min.z;
+		float max_x = bounds.max.x, max_y = bounds.max.y, max_z = bounds.max.z;
+
+		auto load = [](const auto* xyz, float& x, float& y, float& z) {
+			const char* bytes = reinterpret_cast<const char*>(xyz);
+			std::memcpy(&x, bytes, sizeof(float));
+			std::memcpy(&y, bytes + sizeof(float), sizeof(float));
+			std::memcpy(&z, bytes + 2 * sizeof(float), sizeof(float));
+		};
+
+		for (size_t t = begin; t < end; t++) {
+			float x0, y0, z0, x1, y1, z1, x2, y2, z2;
+			load(corner_coords(t, 0), x0, y0, z0);
+			load(corner_coords(t, 1), x1, y1, z1);
+			load(corner_coords(t, 2), x2, y2, z2);
+
+			float e1x = x1 - x0, e1y = y1 - y0, e1z = z1 - z0;
+			float e2x = x2 - x0, e2y = y2 - y0, e2z = z2 - z0;
+
+			float nx = e1y * e2z - e2y * e1z;
+			float ny = e1z * e2x - e2z * e1x;
+			float nz = e1x * e2y - e2x * e1y;
+
+			float inv_len = 1.0f / std::sqrt((nx * nx + ny * ny) + nz * nz);
+			nx *= inv_len;
+			ny *= inv_len;
+			nz *= inv_len;
+
+			float* out = vertices + 18 * t;
+			auto write_corner = [&](float* corner, float x, float y, float z) {
+				min_x = std::min(min_x, x);
+				min_y = std::min(min_y, y);
+				min_z = std::min(min_z, z);
+				max_x = std::max(max_x, x);
+				max_y = std::max(max_y, y);
+				max_z = std::max(max_z, z);
+
+				corner[0] = x;
+				corner[1] = y;
+				corner[2] = z;
+				corner[3] = nx;
+				corner[4] = ny;
+				corner[5] = nz;
+			};
+			write_corner(out, x0, y0, z0);
+			write_corner(out + 6, x1, y1, z1);
+			write_corner(out + 12, x2, y2, z2);
+		}
+
+		bounds.min = glm::vec3(min_x, min_y, min_z);
+		bounds.max = glm::vec3(max_x, max_y, max_z);
+	}
+
+	// 在线程池上按三角形分块，求每个三角形的法向，并按顶点布局写出到 vertices + 18 * t。返回所有三角形的包围盒
+	// corner_coords(t, c) 返回第t个三角形第c个角点的3个float（不要求对齐，例如直接指向二进制STL记录）
+	// 标量时直接逐个三角形处理；SIMD时每块再按BATCH_SIZE分批，角点先填入SoA批，内核求法向后转置写出
+	template <typename F>
+	Bounds ParallelFillTriangles(float* vertices, size_t num_tris, F&& corner_coords, Isa isa) {
+		auto& pool = Utils::ThreadPool::GetInstance();
+		std::vector<Bounds> chunk_bounds(pool.ChunkCount(num_tris));
+		bool streaming = num_tris * 18 * sizeof(float) >= STREAMING_BYTES;
+
+		pool.ParallelFor(num_tris, [&](size_t begin, size_t end, size_t chunk_index) {
+			Bounds bounds;
+			if (isa == Isa::Scalar) {
+				FillTrianglesScalar(vertices, begin, end, corner_coords, bounds);
+				chunk_bounds[chunk_index] = bounds;
+				return;
+			}
+
+			auto batch = std::make_unique<TriangleBatch>();
+			for (size_t batch_begin = begin; batch_begin < end; batch_begin += BATCH_SIZE) {
+				size_t batch_end = std::min(end, batch_begin + BATCH_SIZE);
+				for (size_t t = batch_begin; t < batch_end; t++) {
+					for (int c = 0; c < 3; c++) {
+						batch->SetCorner(t - batch_begin, c, corner_coords(t, c));
+					}
+				}
+				FlatNormalsAndBounds(*batch, batch_end - batch_begin, bounds, isa);
+				WriteTriangleVertices(*batch, batch_end - batch_begin, vertices + batch_begin * 18, streaming);
+			}
+			chunk_bounds[chunk_index] = bounds;
+		});
+
+		Bounds res;
+		for (auto& bounds : chunk_bounds) {
+			res.Merge(bounds);
+		}
+		return res;
+	}
+
+	// 按CPU和输入大小选择实现：输出小于STREAMING_BYTES时用标量实现
+	// （SoA批的填入和转置写出抵消了SIMD求法向省下的时间，只有大数组的non-temporal写才比直接的标量循环快）
+	template <typename F>
+	Bounds ParallelFillTriangles(float* vertices, size_t num_tris, F&& corner_coords) {
+		Isa isa = num_tris * 18 * sizeof(float) < STREAMING_BYTES ? Isa::Scalar : BestIsa();
+		return ParallelFillTriangles(vertices, num_tris, corner_coords, isa);
+	}
+}
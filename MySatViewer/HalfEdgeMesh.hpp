@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Topology.hpp"
+#include "ObjInfo.hpp"
+#include "MarkNumIndex.hpp"
+#include "EdgeHashMap.hpp"
+
+/*
+	紧凑的三角形半边结构
+	用途：代替ObjMarkNum中由shared_ptr连接的Vertex/Edge/HalfEdge/Loop/Face/Solid图，供ObjLineRenderer、ObjGuiRenderer使用
+	所有实体都用32位下标表示，按类型分别存放在连续的数组中（SoA），没有引用计数，也没有逐个实体的堆分配
+	下标与ObjMarkNum中的markNum一致：
+		顶点为OBJ中的顶点下标；第t个三角形（按solid的顺序）的三个半边为 3t、3t+1、3t+2，环和面都为t；solid按solidIndicesRange的顺序
+		边按第一次出现的顺序编号，边的st/ed为第一次出现时半边的方向，同一条边的半边按出现的顺序首尾相连成partner环
+	每个面只有一个环、每个环都是三角形，因此next/pre、环、面都由半边下标直接算出，不需要存储
+	建立时由临时的EdgeHashMap按两个顶点查找边，每个半边查找一次；建立后不保留，FindEdge在按键排序的EdgeOrder上二分查找
+*/
+
+namespace Topology {
+
+	class HalfEdgeMesh {
+	public:
+		static constexpr int INVALID = -1;
+
+		// 由ObjInfo建立，各solid的三角形按顺序排列
+		void Build(const Info::ObjInfo& obj_info) {
+			Clear();
+
+			positions = obj_info.vertices;
+
+			size_t triangle_count = 0;
+			solidFaceOffsets.push_back(0);
+			for (auto& range : obj_info.solidIndicesRange) {
+				triangle_count += static_cast<size_t>(range.second - range.first) / 3;
+				solidFaceOffsets.push_back(static_cast<uint32_t>(triangle_count));
+			}
+
+			halfEdgeVertices.resize(triangle_count * 3);
+			size_t he = 0;
+			for (auto& range : obj_info.solidIndicesRange) {
+				size_t count = static_cast<size_t>(range.second - range.first) / 3 * 3;
+				std::copy_n(obj_info.indices.begin() + range.first, count, halfEdgeVertices.begin() + he);
+				he += count;
+			}
+
+			_BuildEdges();
+		}
+
+		void Clear() {
+			positions.clear();
+			halfEdgeVertices.clear();
+			halfEdgeEdges.clear();
+			halfEdgePartners.clear();
+			edgeHalfEdges.clear();
+			edgeHalfEdgeCounts.clear();
+			edgeOrder.clear();
+			solidFaceOffsets.clear();
+		}
+
+		int VertexCount() const { return static_cast<int>(positions.size() / 3); }
+		int EdgeCount() const { return static_cast<int>(edgeHalfEdges.size()); }
+		int HalfEdgeCount() const { return static_cast<int>(halfEdgeVertices.size()); }
+		int LoopCount() const { return FaceCount(); }
+		int FaceCount() const { return static_cast<int>(halfEdgeVertices.size() / 3); }
+		int SolidCount() const { return solidFaceOffsets.empty() ? 0 : static_cast<int>(solidFaceOffsets.size()) - 1; }
+
+		// 顶点
+		Coordinate Point(int v) const {
+			return Coordinate(positions.data() + 3 * static_cast<size_t>(v));
+		}
+
+		// 边
+		int EdgeStart(int e) const { return HalfEdgeStart(EdgeHalfEdge(e)); }
+		int EdgeEnd(int e) const { return HalfEdgeEnd(EdgeHalfEdge(e)); }
+		int EdgeHalfEdge(int e) const { return static_cast<int>(edgeHalfEdges[e]); } // 第一次出现时的半边，沿partner可以遍历所有半边
+		int EdgeHalfEdgeCount(int e) const { return static_cast<int>(edgeHalfEdgeCounts[e]); }
+
+		T_NUM EdgeLength(int e) const {
+			return Point(EdgeStart(e)).Distance(Point(EdgeEnd(e)));
+		}
+
+		// 按（较小的顶点下标，较大的顶点下标）排列的所有边，ObjLineRenderer、ObjGuiRenderer按这个顺序输出
+		// （即ObjMarkNum::edgesMap还是std::map时的遍历顺序；边表本身按边的编号遍历）
+		const std::vector<uint32_t>& EdgeOrder() const {
+			return edgeOrder;
+		}
+
+		// 连接两个顶点的边（不区分方向），没有时返回INVALID
+		// 在EdgeOrder上二分查找，不需要额外的内存；查看器本身不调用，只用于校验和性能测试
+		int FindEdge(int v1, int v2) const {
+			std::pair<int, int> key{ std::min(v1, v2), std::max(v1, v2) };
+			auto edge_key = [this](uint32_t e) {
+				int st = EdgeStart(static_cast<int>(e));
+				int ed = EdgeEnd(static_cast<int>(e));
+				return std::pair<int, int>{ std::min(st, ed), std::max(st, ed) };
+			};
+			auto it = std::lower_bound(edgeOrder.begin(), edgeOrder.end(), key, [&](uint32_t e, const std::pair<int, int>& k) {
+				return edge_key(e) < k;
+			});
+			return it != edgeOrder.end() && edge_key(*it) == key ? static_cast<int>(*it) : INVALID;
+		}
+
+		// 半边
+		int HalfEdgeEdge(int he) const { return static_cast<int>(halfEdgeEdges[he]); }
+		int HalfEdgePartner(int he) const { return static_cast<int>(halfEdgePartners[he]); }
+		int HalfEdgeLoop(int he) const { return he / 3; }
+		int HalfEdgeNext(int he) const { return he % 3 == 2 ? he - 2 : he + 1; }
+		int HalfEdgePre(int he) const { return he % 3 == 0 ? he + 2 : he - 1; }
+		int HalfEdgeStart(int he) const { return static_cast<int>(halfEdgeVertices[he]); }
+		int HalfEdgeEnd(int he) const { return static_cast<int>(halfEdgeVertices[HalfEdgeNext(he)]); }
+
+		// false: 与edge一致, true: 不一致
+		bool HalfEdgeSense(int he) const {
+			int e = HalfEdgeEdge(he);
+			return !(HalfEdgeStart(he) == EdgeStart(e) && HalfEdgeEnd(he) == EdgeEnd(e));
+		}
+
+		T_NUM HalfEdgeLength(int he) const {
+			return EdgeLength(HalfEdgeEdge(he));
+		}
+
+		// 环、面、solid
+		int LoopHalfEdge(int lp) const { return 3 * lp; }
+		int LoopFace(int lp) const { return lp; }
+		int FaceLoop(int f) const { return f; }
+
+		int FaceSolid(int f) const {
+			return static_cast<int>(std::upper_bound(solidFaceOffsets.begin(), solidFaceOffsets.end(), static_cast<uint32_t>(f)) - solidFaceOffsets.begin()) - 1;
+		}
+
+		// solid的面为 [first, second)
+		std::pair<int, int> SolidFaces(int s) const {
+			return { static_cast<int>(solidFaceOffsets[s]), static_cast<int>(solidFaceOffsets[s + 1]) };
+		}
+
+		size_t MemoryBytes() const {
+			return positions.capacity() * sizeof(float)
+				+ (halfEdgeVertices.capacity() + halfEdgeEdges.capacity() + halfEdgePartners.capacity()) * sizeof(uint32_t)
+				+ (edgeHalfEdges.capacity() + edgeHalfEdgeCounts.capacity() + edgeOrder.capacity() + solidFaceOffsets.capacity()) * sizeof(uint32_t);
+		}
+
+	private:
+		std::vector<float> positions; // 每个顶点3个float
+
+		// 每个半边：起点、所属的边、partner
+		std::vector<uint32_t> halfEdgeVertices;
+		std::vector<uint32_t> halfEdgeEdges;
+		std::vector<uint32_t> halfEdgePartners;
+
+		// 每条边：第一次出现时的半边、半边数
+		std::vector<uint32_t> edgeHalfEdges;
+		std::vector<uint32_t> edgeHalfEdgeCounts;
+		std::vector<uint32_t> edgeOrder;
+
+		std::vector<uint32_t> solidFaceOffsets; // solid个数+1个
+
+		// 按出现的顺序逐个半边在边表中查找，不存在时创建新的边，因此边按第一次出现的顺序编号
+		// 同一条边的半边按出现的顺序首尾相连成partner环
+		void _BuildEdges() {
+			size_t he_count = halfEdgeVertices.size();
+
+			// 闭合网格每条边有两个半边，另外为开放的边界留一些余量（超出时边表会翻倍）
+			size_t edge_estimate = he_count / 2 + he_count / 16 + 1;
+			EdgeHashMap<uint32_t> edge_map; // (顶点, 顶点) -> 边，只在建立时使用
+			edge_map.Reserve(edge_estimate);
+			halfEdgeEdges.resize(he_count);
+			halfEdgePartners.resize(he_count);
+			edgeHalfEdges.reserve(edge_estimate);
+			edgeHalfEdgeCounts.reserve(edge_estimate);
+			std::vector<uint32_t> last_half_edges; // 每条边目前最后出现的半边
+			last_half_edges.reserve(edge_estimate);
+
+			const size_t PREFETCH_DISTANCE = 16;
+			for (size_t he = 0; he < he_count; he++) {
+				if (he + PREFETCH_DISTANCE < he_count) {
+					int ahead = static_cast<int>(he + PREFETCH_DISTANCE);
+					edge_map.Prefetch(HalfEdgeStart(ahead), HalfEdgeEnd(ahead));
+				}
+
+				auto [edge, inserted] = edge_map.TryEmplace(HalfEdgeStart(static_cast<int>(he)), HalfEdgeEnd(static_cast<int>(he)));
+				if (inserted) {
+					edge = static_cast<uint32_t>(edgeHalfEdges.size());
+					edgeHalfEdges.push_back(static_cast<uint32_t>(he));
+					edgeHalfEdgeCounts.push_back(0);
+					last_half_edges.push_back(static_cast<uint32_t>(he));
+				}
+
+				halfEdgeEdges[he] = edge;
+				halfEdgePartners[last_half_edges[edge]] = static_cast<uint32_t>(he);
+				halfEdgePartners[he] = edgeHalfEdges[edge];
+				last_half_edges[edge] = static_cast<uint32_t>(he);
+				edgeHalfEdgeCounts[edge]++;
+			}
+			edgeHalfEdges.shrink_to_fit();
+			edgeHalfEdgeCounts.shrink_to_fit();
+
+			// 按键排序得到EdgeOrder；键只保留顶点下标的有效位，减少排序的趟数
+			int vertex_bits = 1;
+			while (vertex_bits < 32 && (static_cast<size_t>(1) << vertex_bits) < positions.size() / 3) {
+				vertex_bits++;
+			}
+			std::vector<uint64_t> keys;
+			keys.reserve(edge_map.size());
+			for (auto& entry : edge_map) {
+				uint64_t min_vertex = static_cast<uint64_t>(EdgeHashMap<uint32_t>::KeyMin(entry.first));
+				uint64_t max_vertex = static_cast<uint64_t>(EdgeHashMap<uint32_t>::KeyMax(entry.first));
+				keys.push_back((min_vertex << vertex_bits) | max_vertex);
+			}
+			edge_map.Clear();
+			std::vector<int> sorted = Info::RadixSortOrder(std::move(keys), 2 * vertex_bits);
+			edgeOrder.assign(sorted.begin(), sorted.end());
+		}
+	};
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "json.hpp"
+
+#include <glm/glm.hpp>
+
+#include <spdlog/spdlog.h>
+
+/*
+	不抛异常地读取json记录中的字段
+	用途：各个基于DOM的加载（SatInfo::LoadGeometryJsonDom、CellInfo、RayInfo、DebugShowInfo）逐条读取记录时，
+		字段不存在或者类型不对不再抛出json::out_of_range并逐条写日志，而是按字段计数，全部读完后由FieldFailures::Log输出一条汇总
+	读取一条记录时各字段的结果用 ok &= ... 累积，中间不提前退出，正常的记录只在最后判断一次
+*/
+
+namespace Utils {
+
+	using json = nlohmann::json;
+
+	// 一类记录的读取失败统计
+	class FieldFailures {
+	public:
+		int failedRecords = 0;
+		std::vector<std::pair<const char*, int>> fieldCounts; // 字段名 -> 失败次数，按第一次失败的顺序
+
+		// field应当是字符串字面量（只保存指针）
+		void AddField(const char* field) {
+			for (auto& field_count : fieldCounts) {
+				if (field_count.first == field || std::strcmp(field_count.first, field) == 0) {
+					field_count.second++;
+					return;
+				}
+			}
+			fieldCounts.emplace_back(field, 1);
+		}
+
+		void Merge(const FieldFailures& other) {
+			failedRecords += other.failedRecords;
+			for (auto& field_count : other.fieldCounts) {
+				for (int i = 0; i < field_count.second; i++) {
+					AddField(field_count.first);
+				}
+			}
+		}
+
+		// 有失败的记录时输出一条汇总：what为记录的类型，total为记录总数
+		void Log(const char* what, size_t total) const {
+			if (failedRecords == 0) {
+				return;
+			}
+
+			std::string fields;
+			for (auto& field_count : fieldCounts) {
+				if (!fields.empty()) {
+					fields += ", ";
+				}
+				fields += field_count.first;
+				fields += ": ";
+				fields += std::to_string(field_count.second);
+			}
+			SPDLOG_WARN("{}: {} of {} records failed to load (missing or invalid fields: {})", what, failedRecords, total, fields);
+		}
+	};
+
+	// 数字字段。不存在或者不是数字时记一次失败，out保持不变
+	template<typename T>
+	bool GetJsonNumber(const json& obj, const char* key, T& out, FieldFailures& failures) {
+		auto it = obj.find(key);
+		if (it == obj.end() || !it->is_number()) {
+			failures.AddField(key);
+			return false;
+		}
+		out = it->template get<T>();
+		return true;
+	}
+
+	bool GetJsonString(const json& obj, const char* key, std::string& out, FieldFailures& failures) {
+		auto it = obj.find(key);
+		if (it == obj.end() || !it->is_string()) {
+			failures.AddField(key);
+			return false;
+		}
+		out = it->get_ref<const std::string&>();
+		return true;
+	}
+
+	// 可选的字符串字段（与原来的 value(key, "") 一致）：不存在或者不是字符串时为空，不记失败
+	std::string GetJsonStringOr(const json& obj, const char* key) {
+		auto it = obj.find(key);
+		return it != obj.end() && it->is_string() ? it->get<std::string>() : std::string();
+	}
+
+	// 对象或数组字段，不存在或者类型不对时记一次失败并返回nullptr
+	const json* GetJsonChild(const json& obj, const char* key, json::value_t type, FieldFailures& failures) {
+		auto it = obj.find(key);
+		if (it == obj.end() || it->type() != type) {
+			failures.AddField(key);
+			return nullptr;
+		}
+		return &*it;
+	}
+
+	// 顶层的记录数组：不存在时按空数组处理（不记失败）
+	const json& GetJsonRecords(const json& data, const char* key) {
+		static const json empty_array = json::array();
+
+		auto it = data.find(key);
+		return it != data.end() && it->is_array() ? *it : empty_array;
+	}
+
+	// 三个数字字段组成的点，例如 x、y、z 或者 centre_x、centre_y、centre_z
+	bool GetJsonVec3(const json& obj, const char* x_key, const char* y_key, const char* z_key, glm::vec3& out, FieldFailures& failures) {
+		bool ok = true;
+		ok &= GetJsonNumber(obj, x_key, out.x, failures);
+		ok &= GetJsonNumber(obj, y_key, out.y, failures);
+		ok &= GetJsonNumber(obj, z_key, out.z, failures);
+		return ok;
+	}
+
+	// 三个数字组成的数组字段，例如 "st" : [x, y, z]
+	bool GetJsonVec3Array(const json& obj, const char* key, glm::vec3& out, FieldFailures& failures) {
+		auto it = obj.find(key);
+		if (it == obj.end() || !it->is_array() || it->size() < 3 || !(*it)[0].is_number() || !(*it)[1].is_number() || !(*it)[2].is_number()) {
+			failures.AddField(key);
+			return false;
+		}
+		out = glm::vec3{ (*it)[0].get<float>(), (*it)[1].get<float>(), (*it)[2].get<float>() };
+		return true;
+	}
+}
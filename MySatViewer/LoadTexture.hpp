@@ -14,7 +14,7 @@ namespace MyRenderEngine {
 
 	namespace LoadTexture {
 		// utility function for loading a 2D texture from file
-		// ʵݣIDԹ󼤻ԪԪ
+		// 绑定纹理对象与实际数据，并返回纹理对象ID以供随后激活纹理单元并将纹理对象与纹理单元绑定
 		// ---------------------------------------------------
 		unsigned int loadTexture(char const* path) {
 			unsigned int textureID;
@@ -35,12 +35,12 @@ namespace MyRenderEngine {
 					format = GL_RGBA;
 				}
 
-				// 󶨣ʵ
+				// 绑定：绑定纹理对象与实际数据
 				glBindTexture(GL_TEXTURE_2D, textureID);
 				glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
 				glGenerateMipmap(GL_TEXTURE_2D);
 
-				// Ʒʽ֮˳⣩
+				// 纹理环绕方式（与绑定之间的顺序随意）
 				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, format == GL_RGBA ? GL_CLAMP_TO_EDGE : GL_REPEAT); // for this tutorial: use GL_CLAMP_TO_EDGE to prevent semi-transparent borders. Due to interpolation it takes texels from next repeat 
 				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, format == GL_RGBA ? GL_CLAMP_TO_EDGE : GL_REPEAT);
 				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+	只读内存映射文件
+	用途：大文件（STL、json等）不再整体读入内存，而是直接映射后原地解析
+*/
+
+namespace Utils {
+
+	class MappedFile {
+	public:
+
+		MappedFile() {}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& other) noexcept {
+			*this = std::move(other);
+		}
+
+		MappedFile& operator=(MappedFile&& other) noexcept {
+			if (this != &other) {
+				Close();
+				std::swap(data, other.data);
+				std::swap(size, other.size);
+#ifdef _WIN32
+				std::swap(fileHandle, other.fileHandle);
+				std::swap(mappingHandle, other.mappingHandle);
+#endif
+			}
+			return *this;
+		}
+
+		~MappedFile() {
+			Close();
+		}
+
+		// 打开并映射整个文件，失败时返回false（空文件也视为失败）
+		bool Open(const std::string& path) {
+			Close();
+
+#ifdef _WIN32
+			fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (fileHandle == INVALID_HANDLE_VALUE) {
+				return false;
+			}
+
+			LARGE_INTEGER file_size;
+			if (!GetFileSizeEx(fileHandle, &file_size) || file_size.QuadPart == 0) {
+				Close();
+				return false;
+			}
+
+			mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mappingHandle == NULL) {
+				Close();
+				return false;
+			}
+
+			data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+			if (data == nullptr) {
+				Close();
+				return false;
+			}
+			size = static_cast<size_t>(file_size.QuadPart);
+#else
+			int fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0) {
+				return false;
+			}
+
+			struct stat st;
+			if (fstat(fd, &st) != 0 || st.st_size == 0) {
+				close(fd);
+				return false;
+			}
+
+			void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			close(fd); // 映射建立后即可关闭fd
+			if (p == MAP_FAILED) {
+				return false;
+			}
+			madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+			data = static_cast<const char*>(p);
+			size = static_cast<size_t>(st.st_size);
+#endif
+			return true;
+		}
+
+		void Close() {
+#ifdef _WIN32
+			if (data != nullptr) {
+				UnmapViewOfFile(data);
+			}
+			if (mappingHandle != NULL) {
+				CloseHandle(mappingHandle);
+			}
+			if (fileHandle != INVALID_HANDLE_VALUE) {
+				CloseHandle(fileHandle);
+			}
+			mappingHandle = NULL;
+			fileHandle = INVALID_HANDLE_VALUE;
+#else
+			if (data != nullptr) {
+				munmap(const_cast<char*>(data), size);
+			}
+#endif
+			data = nullptr;
+			size = 0;
+		}
+
+		bool IsOpen() const {
+			return data != nullptr;
+		}
+
+		const char* Data() const {
+			return data;
+		}
+
+		size_t Size() const {
+			return size;
+		}
+
+	private:
+		const char* data = nullptr;
+		size_t size = 0;
+
+#ifdef _WIN32
+		HANDLE fileHandle = INVALID_HANDLE_VALUE;
+		HANDLE mappingHandle = NULL;
+#endif
+	};
+}
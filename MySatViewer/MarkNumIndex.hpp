@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+/*
+	markNum -> 记录下标 的索引，以及按markNum排序的视图
+	用途：SatInfo中各类记录按读取的顺序保存，不再整体排序（排序会搬动整个记录，包括其中的unique_ptr和vector）
+		引用（半边->边、环->半边、面->环等）通过稠密的下标表在O(1)内找到对应的记录
+		需要按markNum顺序列出记录时（GUI），使用MarkNumOrder得到的下标排列
+*/
+
+namespace Info {
+
+	class MarkNumIndex {
+	public:
+		// 一遍扫描建立索引。mark_num_count为统计信息中的数量，下标表按它预留
+		// markNum重复时保留先读到的记录；超出表长很多的markNum（文件中的编号不连续时）放到散列表中，不撑大下标表
+		template<typename T>
+		void Build(const std::vector<T>& infos, int mark_num_count) {
+			size_t limit = 2 * std::max(static_cast<size_t>(std::max(mark_num_count, 0)), infos.size()) + 1024;
+
+			indices.assign(static_cast<size_t>(std::max(mark_num_count, 0)) + 1, -1);
+			sparseIndices.clear();
+
+			for (size_t i = 0; i < infos.size(); i++) {
+				int mark_num = infos[i].markNum;
+				if (mark_num < 0) {
+					continue;
+				}
+				size_t slot = static_cast<size_t>(mark_num);
+				if (slot >= limit) {
+					sparseIndices.emplace(mark_num, static_cast<int>(i));
+					continue;
+				}
+				if (slot >= indices.size()) {
+					indices.resize(std::max(slot + 1, indices.size() * 2), -1);
+				}
+				if (indices[slot] < 0) {
+					indices[slot] = static_cast<int>(i);
+				}
+			}
+		}
+
+		// markNum对应记录的下标，没有时返回-1
+		int Find(int mark_num) const {
+			if (mark_num < 0) {
+				return -1;
+			}
+			if (static_cast<size_t>(mark_num) < indices.size()) {
+				return indices[mark_num];
+			}
+			auto it = sparseIndices.find(mark_num);
+			return it != sparseIndices.end() ? it->second : -1;
+		}
+
+		template<typename T>
+		T* Find(std::vector<T>& infos, int mark_num) const {
+			int i = Find(mark_num);
+			return i >= 0 ? &infos[i] : nullptr;
+		}
+
+		void Clear() {
+			indices.clear();
+			sparseIndices.clear();
+		}
+
+	private:
+		std::vector<int> indices; // indices[markNum]为记录的下标，-1表示没有
+		std::unordered_map<int, int> sparseIndices;
+	};
+
+	// 按键升序排列的下标（键相同时保持原来的顺序），key_bits为键的有效位数（更高的位必须为0）
+	// 并行的LSD基数排序：每趟8位，各块先统计直方图，按（数字，块）的顺序求前缀和后各自分发，所有数字都相同的一趟跳过
+	template<typename Key>
+	std::vector<int> RadixSortOrder(std::vector<Key> keys, int key_bits = 8 * sizeof(Key)) {
+		const size_t MIN_CHUNK_SIZE = 16384;
+
+		size_t count = keys.size();
+		std::vector<int> order(count);
+		for (size_t i = 0; i < count; i++) {
+			order[i] = static_cast<int>(i);
+		}
+
+		Utils::ThreadPool& pool = Utils::ThreadPool::GetInstance();
+		std::vector<Key> next_keys(count);
+		std::vector<int> next_order(count);
+		std::vector<std::array<size_t, 256>> offsets(pool.ChunkCount(count, MIN_CHUNK_SIZE));
+
+		for (int shift = 0; shift < key_bits; shift += 8) {
+			pool.ParallelFor(count, [&](size_t begin, size_t end, size_t chunk_index) {
+				std::array<size_t, 256>& histogram = offsets[chunk_index];
+				histogram.fill(0);
+				for (size_t i = begin; i < end; i++) {
+					histogram[(keys[i] >> shift) & 0xFF]++;
+				}
+			}, MIN_CHUNK_SIZE);
+
+			bool trivial = false;
+			size_t sum = 0;
+			for (int digit = 0; digit < 256; digit++) {
+				size_t digit_count = 0;
+				for (auto& histogram : offsets) {
+					size_t n = histogram[digit];
+					histogram[digit] = sum;
+					sum += n;
+					digit_count += n;
+				}
+				trivial |= digit_count == count;
+			}
+			if (trivial) {
+				continue;
+			}
+
+			pool.ParallelFor(count, [&](size_t begin, size_t end, size_t chunk_index) {
+				std::array<size_t, 256>& offset = offsets[chunk_index];
+				for (size_t i = begin; i < end; i++) {
+					size_t dst = offset[(keys[i] >> shift) & 0xFF]++;
+					next_keys[dst] = keys[i];
+					next_order[dst] = order[i];
+				}
+			}, MIN_CHUNK_SIZE);
+
+			std::swap(keys, next_keys);
+			std::swap(order, next_order);
+		}
+
+		return order;
+	}
+
+	// 按markNum升序排列的下标（markNum相同时保持读取顺序）
+	template<typename T>
+	std::vector<int> MarkNumOrder(const std::vector<T>& infos) {
+		std::vector<uint32_t> keys(infos.size());
+		for (size_t i = 0; i < infos.size(); i++) {
+			keys[i] = static_cast<uint32_t>(infos[i].markNum) ^ 0x80000000u; // 负数排在前面
+		}
+		return RadixSortOrder(std::move(keys));
+	}
+}
@@ -40,7 +40,7 @@ using json = nlohmann::json;
 
 namespace MyRenderEngine {
 
-	// ͲRenderableInfoˣΪ֮ǰֻisOpaqueģֻڵmyRenderEngine.AddRenderableʱáҪĳܹ̬ģԾͲ
+	// 这里就不用RenderableInfo这个设计了，因为之前里面只是用来传递isOpaque的，而这个量只在调用myRenderEngine.AddRenderable的时候有用。现在需要改成能够动态调整的，所以就不用了
 
 	void ProcessToggleKey(GLFWwindow* window, int key, bool& var, bool& varPressed) {
 		if (glfwGetKey(window, key) == GLFW_PRESS && !varPressed) {
@@ -122,7 +122,7 @@ namespace MyRenderEngine {
 			if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
 				camera.ProcessKeyboard(RIGHT, deltaTime);
 
-			// Ϊ˷Զ̵ĳ
+			// 为了方便远程的尝试
 			if (glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS)
 				camera.ProcessMouseMovement(0.0f, keyboardMovementSpeed);
 			if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS)
@@ -165,14 +165,14 @@ namespace MyRenderEngine {
 		MouseController mouseController;
 		KeyboardController keyboardController;
 
-		// Ⱦб
-		// opaqueRenderables̶Ⱦڲ͸framebufferϵģ opaqueOrTransparentRenderables Ⱦڲ͸͸framebufferϵģͨtransparentModelл
+		// 渲染对象列表
+		// opaqueRenderables：固定渲染在不透明framebuffer上的， opaqueOrTransparentRenderables： 可能渲染在不透明或透明framebuffer上的（通过transparentModel切换）
 		std::vector<std::shared_ptr<IRenderable>> opaqueRenderables, opaqueOrTransparentRenderables, guiRenderables;
 
-		std::shared_ptr<IRenderable> screenQuad; // []
+		std::shared_ptr<IRenderable> screenQuad; // [后设置]
 
 		// Framebuffer
-		// Ѿջ
+		// 生命周期已经闭环
 		unsigned int opaqueFBO;
 		unsigned int transparentFBO;
 
@@ -269,6 +269,7 @@ namespace MyRenderEngine {
 				renderInfo.projectionMatrix = projectionMatrix;
 				renderInfo.viewMatrix = viewMatrix;
 				renderInfo.cameraPos = camera.Position;
+				renderInfo.viewportHeight = display_h > 0 ? display_h : 1;
 
 				renderInfo.showModel = showModel;
 				renderInfo.transparentModel = transparentModel;
@@ -303,7 +304,7 @@ namespace MyRenderEngine {
 				glBlendEquation(GL_FUNC_ADD);
 
 				glBindFramebuffer(GL_FRAMEBUFFER, transparentFBO);
-				glClearBufferfv(GL_COLOR, 0, &Configs::ZERO_VEC[0]); // º
+				glClearBufferfv(GL_COLOR, 0, &Configs::ZERO_VEC[0]); // 新函数
 				glClearBufferfv(GL_COLOR, 1, &Configs::ONE_VEC[0]);
 
 				if (transparentModel == true) {
@@ -373,14 +374,14 @@ namespace MyRenderEngine {
 			ImGui_ImplOpenGL3_Init("#version 130");
 		}
 
-		// û
+		// 这个没用上
 		void SetupGlobalOpenglState() {
 			glEnable(GL_DEPTH_TEST);
 			//glEnable(GL_BLEND);
 			//glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-			glDepthFunc(GL_LESS); // ȻȽͨС ĬϾɣ
-			glDepthMask(GL_TRUE); // Ȼ
+			glDepthFunc(GL_LESS); // 深度缓冲比较通过条件：小于 （默认就是这个吧）
+			glDepthMask(GL_TRUE); // 允许更新深度缓冲
 			glDisable(GL_BLEND);
 			glClearColor(backgroundColor.r, backgroundColor.g, backgroundColor.b, backgroundColor.a);
 		}
@@ -392,7 +393,7 @@ namespace MyRenderEngine {
 			// opaqueTexture
 			glGenTextures(1, &opaqueTexture);
 			glBindTexture(GL_TEXTURE_2D, opaqueTexture);
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, Configs::SCR_WIDTH, Configs::SCR_HEIGHT, 0, GL_RGBA, GL_HALF_FLOAT, NULL); // עõ gl_half_float
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, Configs::SCR_WIDTH, Configs::SCR_HEIGHT, 0, GL_RGBA, GL_HALF_FLOAT, NULL); // 注意这里用的是 gl_half_float
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 			glBindTexture(GL_TEXTURE_2D, 0);
@@ -426,7 +427,7 @@ namespace MyRenderEngine {
 			// revealTexture
 			glGenTextures(1, &revealTexture);
 			glBindTexture(GL_TEXTURE_2D, revealTexture);
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, Configs::SCR_WIDTH, Configs::SCR_HEIGHT, 0, GL_RED, GL_FLOAT, NULL); // עΪֻһͨԻͬ
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, Configs::SCR_WIDTH, Configs::SCR_HEIGHT, 0, GL_RED, GL_FLOAT, NULL); // 注意这里因为只有一个通道所以会有所不同！
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 			glBindTexture(GL_TEXTURE_2D, 0);
@@ -506,7 +507,7 @@ namespace MyRenderEngine {
 			glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
 			glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
 			glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-			//glfwWindowHint(GLFW_SAMPLES, 4); // עΪ˱framebufferû
+			//glfwWindowHint(GLFW_SAMPLES, 4); // 注意因为这里用了别的framebuffer所以这里没有意义
 			glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
 
 #ifdef __APPLE__
@@ -544,7 +545,7 @@ namespace MyRenderEngine {
 
 			glfwSetWindowUserPointer(window, this);
 			glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
-			//glfwSetCursorPosCallback(window, mouseCallback); // ʱ
+			//glfwSetCursorPosCallback(window, mouseCallback); // 暂时禁用鼠标
 			glfwSetScrollCallback(window, scrollCallback);
 
 			// glad: load all OpenGL function pointers
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+
+#include <spdlog/spdlog.h>
+
+/*
+	只读取三角形网格的OBJ解析器
+	用途：ObjInfo::LoadFromObj 不再经过tinyobj的attrib/shape，直接得到顶点坐标、三角形索引和每个solid的索引范围
+	文件映射后按行切成若干块并行解析，每块得到自己的顶点、索引以及"o"/"g"出现的位置，最后按块的顺序拼接：
+		正的索引是全局的（从1开始），直接减1；负的索引相对于当前已读到的顶点数，按块内的顶点数记录，拼接时再加上前面各块的顶点数
+		"o"/"g"所在位置换算成全局的索引位置后切分solid，没有三角形的组不产生solid（与tinyobj一致，"usemtl"不切分）
+	只读取"v"的前三个分量和"f"中每个顶点的位置索引，纹理坐标、法向、材质等全部跳过
+	四边形与tinyobj一样沿较短的对角线切开（需要顶点坐标，因此在拼接并检查索引之后再调整），更多顶点的面按扇形三角化
+*/
+
+namespace Info {
+
+	class ObjFastParser {
+	public:
+		std::vector<float> vertices;
+		std::vector<int> indices;
+		std::vector<std::pair<int, int>> solidIndicesRange;
+
+		size_t polygonCount = 0; // 多于四个顶点、按扇形三角化的面
+		size_t degenerateCount = 0; // 少于三个顶点、被跳过的面
+
+		// 失败时抛出std::runtime_error
+		void Parse(const std::string& path) {
+			Utils::MappedFile file;
+			if (!file.Open(path)) {
+				throw std::runtime_error("Cannot open OBJ file: " + path);
+			}
+
+			const char* data = file.Data();
+			size_t size = file.Size();
+
+			// 至少1MB一块，每块从行首开始
+			Utils::ThreadPool& pool = Utils::ThreadPool::GetInstance();
+			size_t chunk_count = pool.ChunkCount(size, size_t(1) << 20);
+
+			std::vector<size_t> chunk_begins(chunk_count + 1, size);
+			chunk_begins[0] = 0;
+			for (size_t c = 1; c < chunk_count; c++) {
+				chunk_begins[c] = _LineStart(data, size, std::max(chunk_begins[c - 1], size * c / chunk_count));
+			}
+
+			std::vector<Chunk> chunks(chunk_count);
+			pool.ParallelFor(chunk_count, [&](size_t begin, size_t end, size_t) {
+				for (size_t c = begin; c < end; c++) {
+					_ParseChunk(data + chunk_begins[c], data + chunk_begins[c + 1], chunks[c]);
+				}
+			}, 1);
+
+			// 按文件中的顺序报告第一个错误
+			size_t line_count = 1;
+			for (const Chunk& chunk : chunks) {
+				if (chunk.error != nullptr) {
+					throw std::runtime_error("Cannot parse OBJ file " + path + ": " + chunk.error + " in line " + std::to_string(line_count + chunk.lineCount));
+				}
+				line_count += chunk.lineCount;
+			}
+
+			_Concatenate(chunks);
+
+			// 索引越界时按第一个越界的位置报告
+			size_t vertex_count = vertices.size() / 3;
+			std::vector<size_t> first_invalid(pool.ChunkCount(indices.size()), indices.size());
+			pool.ParallelFor(indices.size(), [&](size_t begin, size_t end, size_t chunk_index) {
+				for (size_t i = begin; i < end; i++) {
+					if (indices[i] < 0 || static_cast<size_t>(indices[i]) >= vertex_count) {
+						first_invalid[chunk_index] = i;
+						return;
+					}
+				}
+			});
+			size_t invalid = *std::min_element(first_invalid.begin(), first_invalid.end());
+			if (invalid < indices.size()) {
+				throw std::runtime_error("Cannot parse OBJ file " + path + ": vertex index out of range in triangle " + std::to_string(invalid / 3));
+			}
+
+			_SplitQuads(chunks);
+
+			for (const Chunk& chunk : chunks) {
+				polygonCount += chunk.polygonCount;
+				degenerateCount += chunk.degenerateCount;
+			}
+		}
+
+	private:
+		// 一块的解析结果
+		struct Chunk {
+			std::vector<float> vertices;
+			std::vector<int> indices;
+			std::vector<size_t> relativeIndices; // indices中由负数索引得到的位置（块内的顶点下标，需要加上前面各块的顶点数）
+			std::vector<size_t> groupStarts; // "o"/"g"出现时indices的长度
+			std::vector<size_t> quadStarts; // 四边形的第一个三角形在indices中的位置
+			size_t indexOffset = 0; // 拼接后在全局indices中的起始位置
+			size_t lineCount = 0;
+			size_t polygonCount = 0;
+			size_t degenerateCount = 0;
+			const char* error = nullptr; // 解析失败时为原因，出错的行为第lineCount行
+		};
+
+		static bool _IsSpace(char c) {
+			return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+		}
+
+		// pos及之后的第一个行首
+		static size_t _LineStart(const char* data, size_t size, size_t pos) {
+			if (pos == 0 || pos >= size) {
+				return std::min(pos, size);
+			}
+			const char* nl = static_cast<const char*>(std::memchr(data + pos - 1, '\n', size - pos + 1));
+			return nl != nullptr ? static_cast<size_t>(nl - data) + 1 : size;
+		}
+
+		static void _SkipSpaces(const char*& p, const char* line_end) {
+			while (p < line_end && _IsSpace(*p)) {
+				p++;
+			}
+		}
+
+		static bool _ParseFloat(const char*& p, const char* line_end, float& out) {
+			_SkipSpaces(p, line_end);
+			if (p < line_end && *p == '+') {
+				p++;
+			}
+			auto res = std::from_chars(p, line_end, out);
+			if (res.ec != std::errc()) {
+				return false;
+			}
+			p = res.ptr;
+			return true;
+		}
+
+		// "f"中的一个顶点：v、v/vt、v//vn、v/vt/vn，只取v。返回false表示这一行已经没有顶点
+		static bool _ParseFaceVertex(const char*& p, const char* line_end, int& out, bool& ok) {
+			_SkipSpaces(p, line_end);
+			if (p == line_end) {
+				return false;
+			}
+			if (*p == '+') {
+				p++;
+			}
+			auto res = std::from_chars(p, line_end, out);
+			if (res.ec != std::errc() || out == 0) {
+				ok = false;
+				return false;
+			}
+			p = res.ptr;
+			while (p < line_end && !_IsSpace(*p)) {
+				p++;
+			}
+			return true;
+		}
+
+		static void _ParseChunk(const char* begin, const char* end, Chunk& chunk) {
+			// 按平均每行约30字节、顶点数约为三角形数的一半预留
+			size_t line_estimate = static_cast<size_t>(end - begin) / 30;
+			chunk.vertices.reserve(line_estimate);
+			chunk.indices.reserve(line_estimate * 2);
+
+			int face[3] = { 0, 0, 0 };
+			bool face_relative[3] = { false, false, false };
+
+			const char* line_begin = begin;
+			while (line_begin < end) {
+				const char* line_end = static_cast<const char*>(std::memchr(line_begin, '\n', end - line_begin));
+				if (line_end == nullptr) {
+					line_end = end;
+				}
+
+				const char* p = line_begin;
+				_SkipSpaces(p, line_end);
+
+				if (line_end - p >= 2 && _IsSpace(p[1])) {
+					switch (p[0]) {
+					case 'v': {
+						p += 2;
+						float xyz[3];
+						if (!_ParseFloat(p, line_end, xyz[0]) || !_ParseFloat(p, line_end, xyz[1]) || !_ParseFloat(p, line_end, xyz[2])) {
+							chunk.error = "vertex not specified correctly";
+							return;
+						}
+						chunk.vertices.insert(chunk.vertices.end(), xyz, xyz + 3);
+						break;
+					}
+					case 'f': {
+						p += 2;
+						int local_vertex_count = static_cast<int>(chunk.vertices.size() / 3);
+						int corner_count = 0;
+						int index = 0;
+						bool ok = true;
+						while (_ParseFaceVertex(p, line_end, index, ok)) {
+							bool relative = index < 0;
+							index = relative ? local_vertex_count + index : index - 1;
+
+							// 扇形三角化：(0, k - 1, k)
+							if (corner_count < 3) {
+								face[corner_count] = index;
+								face_relative[corner_count] = relative;
+							}
+							else {
+								face[1] = face[2];
+								face_relative[1] = face_relative[2];
+								face[2] = index;
+								face_relative[2] = relative;
+							}
+							corner_count++;
+
+							if (corner_count >= 3) {
+								for (int k = 0; k < 3; k++) {
+									if (face_relative[k]) {
+										chunk.relativeIndices.push_back(chunk.indices.size());
+									}
+									chunk.indices.push_back(face[k]);
+								}
+							}
+						}
+						if (!ok) {
+							chunk.error = "face not specified correctly";
+							return;
+						}
+						if (corner_count < 3) {
+							chunk.degenerateCount++;
+						}
+						else if (corner_count == 4) {
+							chunk.quadStarts.push_back(chunk.indices.size() - 6);
+						}
+						else if (corner_count > 3) {
+							chunk.polygonCount++;
+						}
+						break;
+					}
+					case 'o':
+					case 'g':
+						chunk.groupStarts.push_back(chunk.indices.size());
+						break;
+					default:
+						break;
+					}
+				}
+
+				chunk.lineCount++;
+				line_begin = line_end + 1;
+			}
+		}
+
+		// 四边形 (0, 1, 2, 3) 解析时切成 (0, 1, 2), (0, 2, 3)；对角线 0-2 不比 1-3 短时改为 (0, 1, 3), (1, 2, 3)
+		void _SplitQuads(const std::vector<Chunk>& chunks) {
+			auto squared_distance = [&](int a, int b) {
+				float dx = vertices[3 * b + 0] - vertices[3 * a + 0];
+				float dy = vertices[3 * b + 1] - vertices[3 * a + 1];
+				float dz = vertices[3 * b + 2] - vertices[3 * a + 2];
+				return dx * dx + dy * dy + dz * dz;
+			};
+
+			Utils::ThreadPool::GetInstance().ParallelFor(chunks.size(), [&](size_t begin, size_t end, size_t) {
+				for (size_t c = begin; c < end; c++) {
+					for (size_t quad_start : chunks[c].quadStarts) {
+						int* quad = indices.data() + chunks[c].indexOffset + quad_start;
+						int i0 = quad[0], i1 = quad[1], i2 = quad[2], i3 = quad[5];
+						if (!(squared_distance(i0, i2) < squared_distance(i1, i3))) {
+							int split[6] = { i0, i1, i3, i1, i2, i3 };
+							std::copy(split, split + 6, quad);
+						}
+					}
+				}
+			}, 1);
+		}
+
+		void _Concatenate(std::vector<Chunk>& chunks) {
+			size_t chunk_count = chunks.size();
+			std::vector<size_t> vertex_offsets(chunk_count + 1, 0);
+			std::vector<size_t> index_offsets(chunk_count + 1, 0);
+			for (size_t c = 0; c < chunk_count; c++) {
+				vertex_offsets[c + 1] = vertex_offsets[c] + chunks[c].vertices.size();
+				index_offsets[c + 1] = index_offsets[c] + chunks[c].indices.size();
+				chunks[c].indexOffset = index_offsets[c];
+			}
+
+			if (chunk_count == 1) {
+				vertices = std::move(chunks[0].vertices);
+				indices = std::move(chunks[0].indices);
+			}
+			else {
+				vertices.resize(vertex_offsets[chunk_count]);
+				indices.resize(index_offsets[chunk_count]);
+			}
+
+			Utils::ThreadPool::GetInstance().ParallelFor(chunk_count, [&](size_t begin, size_t end, size_t) {
+				for (size_t c = begin; c < end; c++) {
+					Chunk& chunk = chunks[c];
+					int* out = indices.data() + index_offsets[c];
+					if (chunk_count > 1) {
+						std::copy(chunk.vertices.begin(), chunk.vertices.end(), vertices.begin() + vertex_offsets[c]);
+						std::copy(chunk.indices.begin(), chunk.indices.end(), out);
+					}
+
+					int vertex_base = static_cast<int>(vertex_offsets[c] / 3);
+					for (size_t i : chunk.relativeIndices) {
+						out[i] += vertex_base;
+					}
+
+					chunk.vertices = std::vector<float>();
+					chunk.indices = std::vector<int>();
+				}
+			}, 1);
+
+			// 每个"o"/"g"在全局索引中的位置切分solid，空的组去掉
+			solidIndicesRange.clear();
+			size_t solid_begin = 0;
+			auto close_solid = [&](size_t solid_end) {
+				if (solid_end > solid_begin) {
+					solidIndicesRange.emplace_back(static_cast<int>(solid_begin), static_cast<int>(solid_end));
+				}
+				solid_begin = solid_end;
+			};
+			for (size_t c = 0; c < chunk_count; c++) {
+				for (size_t group_start : chunks[c].groupStarts) {
+					close_solid(index_offsets[c] + group_start);
+				}
+			}
+			close_solid(indices.size());
+		}
+	};
+}
@@ -9,8 +9,7 @@
 
 #include "shader_s.h"
 
-#include "ObjInfo.hpp"
-#include "ObjMarkNum.hpp"
+#include "HalfEdgeMesh.hpp"
 
 #include "SetCameraPosEvent.hpp"
 #include "Dispatcher.hpp"
@@ -24,78 +23,63 @@ namespace MyRenderEngine {
 	class ObjGuiRenderer: public IRenderable {
 	public:
 
-		struct YellowInfo {
-			int halfEdgesCount;
-			int edgeMarkNum;
+		const Topology::HalfEdgeMesh& mesh;
 
-			int stMarkNum;
-			int edMarkNum;
-		};
-
-		std::vector<YellowInfo> yellowInfos;
-		std::vector<YellowInfo> greenInfos;
-		std::vector<YellowInfo> redInfos;
+		// 各类边在mesh中的下标
+		std::vector<int> yellowEdges;
+		std::vector<int> greenEdges;
+		std::vector<int> redEdges;
 
 		// TODO: need to improve design here
 		glm::mat4 modelMatrix{ 1.0f };
 
 
 		void SetUp() {
-			yellowInfos.clear();
-			greenInfos.clear();
-			redInfos.clear();
-
-			auto& objMarkNum = ObjMarkNum::GetInstance();
-
-			for (auto e_pair : objMarkNum.edgesMap) {
-
-				auto e = e_pair.second;
-
-				std::vector<YellowInfo>* infos_ptr = nullptr;
-
-				if (e->halfEdges.size() == 2) { // green
-					infos_ptr = &greenInfos;
+			yellowEdges.clear();
+			greenEdges.clear();
+			redEdges.clear();
+
+			for (uint32_t e : mesh.EdgeOrder()) {
+				int half_edge_count = mesh.EdgeHalfEdgeCount(e);
+				if (half_edge_count == 2) { // green
+					greenEdges.push_back(static_cast<int>(e));
 				}
-				else if (e->halfEdges.size() == 1) { // red
-					infos_ptr = &redInfos;
+				else if (half_edge_count == 1) { // red
+					redEdges.push_back(static_cast<int>(e));
 				}
 				else { //yellow
-					infos_ptr = &yellowInfos;
-				}
-
-				if (infos_ptr) {
-					infos_ptr->push_back({ static_cast<int>(e->halfEdges.size()), objMarkNum.GetId(e), objMarkNum.GetId(e->st), objMarkNum.GetId(e->ed) });
+					yellowEdges.push_back(static_cast<int>(e));
 				}
 			}
 		}
 
 		void RenderGui(const RenderInfo& renderInfo) {
 
-			auto tree_node_render = [&](const std::string& name, const std::vector<YellowInfo>& infos) {
+			auto tree_node_render = [&](const std::string& name, const std::vector<int>& edges) {
 					
 				const std::string edge_type_name = name + " Edges";
 				if (ImGui::TreeNode(edge_type_name.c_str())) {
 
 					int id = 0;
-					for (int i = 0; i < infos.size(); i++) {
+					for (int i = 0; i < edges.size(); i++) {
 						ImGui::PushID(id);
 						if (ImGui::TreeNode("", "%s: %d", name.c_str(), i)) {
-							ImGui::Text("half edges count: %d", infos[id].halfEdgesCount);
-							ImGui::Text("edge MarkNum: %d", infos[id].edgeMarkNum);
-							ImGui::Text("st MarkNum: %d", infos[id].stMarkNum);
-							ImGui::Text("ed MarkNum: %d", infos[id].edMarkNum);
+							int edge = edges[id];
+							int st = mesh.EdgeStart(edge);
+							int ed = mesh.EdgeEnd(edge);
 
-							if (ImGui::Button("Go")) {
-								// λõ¼
+							ImGui::Text("half edges count: %d", mesh.EdgeHalfEdgeCount(edge));
+							ImGui::Text("edge MarkNum: %d", edge);
+							ImGui::Text("st MarkNum: %d", st);
+							ImGui::Text("ed MarkNum: %d", ed);
 
-								auto& objMarkNum = ObjMarkNum::GetInstance();
-								Topology::Vertex* st_vertex_ptr = static_cast<Topology::Vertex*>(objMarkNum.GetEntityPtr({ TopoType::Vertex, infos[id].stMarkNum }));
-								Topology::Vertex* ed_vertex_ptr = static_cast<Topology::Vertex*>(objMarkNum.GetEntityPtr({ TopoType::Vertex, infos[id].edMarkNum }));
+							if (ImGui::Button("Go")) {
+								// 设置相机位置的事件
 
-								Coordinate pos = (st_vertex_ptr->pointCoord + ed_vertex_ptr->pointCoord) / 2.0f;
+								Topology::Coordinate pos = (mesh.Point(st) + mesh.Point(ed)) / 2.0f;
 								glm::vec3 pos_in_glm{ pos.x(), pos.y(), pos.z() };
 
-								// modelrenderInfo.scaleFactorı任
+								// 考虑model矩阵和renderInfo.scaleFactor的变换
 								pos_in_glm = glm::vec3(glm::vec4(pos_in_glm, 1.0f) * modelMatrix * renderInfo.scaleFactor);
 
 								EventSystem::SetCameraPosEvent e{pos_in_glm };
@@ -117,9 +101,9 @@ namespace MyRenderEngine {
 
 			ImGui::Begin("OBJ Edges Info");
 
-			tree_node_render("Red", redInfos);
-			tree_node_render("Yellow", yellowInfos);
-			tree_node_render("Green", greenInfos);
+			tree_node_render("Red", redEdges);
+			tree_node_render("Yellow", yellowEdges);
+			tree_node_render("Green", greenEdges);
 
 			ImGui::End();
 		}
@@ -132,6 +116,8 @@ namespace MyRenderEngine {
 
 		}
 
+		ObjGuiRenderer(const Topology::HalfEdgeMesh& mesh) : mesh(mesh) {}
+
 	};
 
 }
\ No newline at end of file
@@ -14,27 +14,50 @@
 #include <cassert>
 
 #include "Topology.hpp"
+#include "ObjFast.hpp"
 #include "tiny_obj_loader.h"
 
 #include <spdlog/spdlog.h>
 
 /*
-	ObjϢ
-    ;еϢִ֧ļмص֯õݽṹУȾʹ
-    ȾϢҪٶȡ
+	Obj信息类
+    用途：包含理论上所有的信息，支持从文件中加载到组织好的数据结构中，方便后续渲染等使用
+    渲染用信息需要从这个类中再度提取
 */
 
 namespace Info {
 
     struct ObjInfo {
-        std::vector<tinyobj::real_t> vertices;
+        std::vector<float> vertices;
         std::vector<int> indices;
 
         std::vector<std::pair<int, int>> solidIndicesRange;
 
+        // 只读取三角形的分块并行解析（见ObjFast.hpp）
         void LoadFromObj(const std::string& obj_path) {
             SPDLOG_INFO("Loading OBJ from: {}", obj_path);
 
+            ObjFastParser parser;
+            parser.Parse(obj_path);
+
+            vertices = std::move(parser.vertices);
+            indices = std::move(parser.indices);
+            solidIndicesRange = std::move(parser.solidIndicesRange);
+
+            if (parser.polygonCount > 0) {
+                SPDLOG_WARN("OBJ: {} faces with more than 4 vertices were triangulated as fans.", parser.polygonCount);
+            }
+            if (parser.degenerateCount > 0) {
+                SPDLOG_WARN("OBJ: {} faces with less than 3 vertices were skipped.", parser.degenerateCount);
+            }
+
+            SPDLOG_INFO("Loading OBJ done. vertices: {}, triangles: {}, solids: {}", vertices.size() / 3, indices.size() / 3, solidIndicesRange.size());
+        }
+
+        // 原来基于tinyobj的加载，用于性能测试中对比
+        void LoadFromObjTinyObj(const std::string& obj_path) {
+            SPDLOG_INFO("Loading OBJ from: {}", obj_path);
+
             tinyobj::ObjReader reader;
 
             if (!reader.ParseFromFile(obj_path)) {
@@ -51,28 +74,25 @@ namespace Info {
             auto& attrib = reader.GetAttrib();
             auto& shapes = reader.GetShapes();
 
-            vertices = attrib.vertices; // 
+            vertices.assign(attrib.vertices.begin(), attrib.vertices.end()); // 复制
+            indices.clear();
+            solidIndicesRange.clear();
 
-            // ÿsolid
+            // 遍历每个solid
             int last_end = 0;
             for (size_t s = 0; s < shapes.size(); s++) {
                 size_t index_offset = 0;
 
-                // solidеÿface
+                // 遍历此solid中的每个face
                 for (size_t f = 0; f < shapes[s].mesh.num_face_vertices.size(); f++) {
                     size_t fv = size_t(shapes[s].mesh.num_face_vertices[f]);
                     assert(fv == 3);
 
-                    // faceеÿ
+                    // 遍历此face中的每个顶点
                     for (size_t v = 0; v < fv; v++) {
-                        // ȡö
+                        // 取得顶点索引类
                         tinyobj::index_t idx = shapes[s].mesh.indices[index_offset + v];
 
-                        // ȡöӦĶ
-                        //tinyobj::real_t vx = attrib.vertices[3 * size_t(idx.vertex_index) + 0];
-                        //tinyobj::real_t vy = attrib.vertices[3 * size_t(idx.vertex_index) + 1];
-                        //tinyobj::real_t vz = attrib.vertices[3 * size_t(idx.vertex_index) + 2];
-
                         indices.emplace_back(idx.vertex_index);
                     }
 
@@ -9,8 +9,7 @@
 
 #include "shader_s.h"
 
-#include "ObjInfo.hpp"
-#include "ObjMarkNum.hpp"
+#include "HalfEdgeMesh.hpp"
 
 
 namespace MyRenderEngine {
@@ -18,18 +17,20 @@ namespace MyRenderEngine {
 class ObjLineRenderer : public IRenderable {
 public:
 
+	const Topology::HalfEdgeMesh& mesh;
+
 	std::vector<float> yellow_lines;
 	std::vector<float> green_lines;
 	std::vector<float> red_lines;
 
-	unsigned int yellowVAO;
-	unsigned int yellowVBO;
+	unsigned int yellowVAO = 0;
+	unsigned int yellowVBO = 0;
 
-	unsigned int greenVAO;
-	unsigned int greenVBO;
+	unsigned int greenVAO = 0;
+	unsigned int greenVBO = 0;
 
-	unsigned int redVAO;
-	unsigned int redVBO;
+	unsigned int redVAO = 0;
+	unsigned int redVBO = 0;
 
 	Shader* shader;
 
@@ -50,41 +51,25 @@ public:
 		green_lines.clear();
 		red_lines.clear();
 
-		auto& objMarkNum = ObjMarkNum::GetInstance();
-
-		// Ӷ굽3vectorУÿvectorа3ʼ㣬3Ŷ
-		for (auto e_pair : objMarkNum.edgesMap) {
-			auto e = e_pair.second;
-
-			auto st_coord = e->st->pointCoord;
-			auto ed_coord = e->ed->pointCoord;
-			if (e->halfEdges.size() == 2) { // green
-				green_lines.emplace_back(st_coord.x());
-				green_lines.emplace_back(st_coord.y());
-				green_lines.emplace_back(st_coord.z());
-
-				green_lines.emplace_back(ed_coord.x());
-				green_lines.emplace_back(ed_coord.y());
-				green_lines.emplace_back(ed_coord.z());
+		// 添加顶点坐标到3个vector中，每个vector中按照3个开始点，3个结束点这样交替存放顶点
+		// 边按（较小的顶点，较大的顶点）的顺序遍历
+		for (uint32_t e : mesh.EdgeOrder()) {
+			std::vector<float>* lines = nullptr;
+			int half_edge_count = mesh.EdgeHalfEdgeCount(e);
+			if (half_edge_count == 2) { // green
+				lines = &green_lines;
 			}
-			else if (e->halfEdges.size() == 1) { // red
-				red_lines.emplace_back(st_coord.x());
-				red_lines.emplace_back(st_coord.y());
-				red_lines.emplace_back(st_coord.z());
-
-				red_lines.emplace_back(ed_coord.x());
-				red_lines.emplace_back(ed_coord.y());
-				red_lines.emplace_back(ed_coord.z());
+			else if (half_edge_count == 1) { // red
+				lines = &red_lines;
 			}
 			else { //yellow
-				yellow_lines.emplace_back(st_coord.x());
-				yellow_lines.emplace_back(st_coord.y());
-				yellow_lines.emplace_back(st_coord.z());
-
-				yellow_lines.emplace_back(ed_coord.x());
-				yellow_lines.emplace_back(ed_coord.y());
-				yellow_lines.emplace_back(ed_coord.z());
+				lines = &yellow_lines;
 			}
+
+			auto st_coord = mesh.Point(mesh.EdgeStart(e));
+			auto ed_coord = mesh.Point(mesh.EdgeEnd(e));
+			lines->insert(lines->end(), st_coord.coords, st_coord.coords + 3);
+			lines->insert(lines->end(), ed_coord.coords, ed_coord.coords + 3);
 		}
 
 		auto set_vao = [&](unsigned int& VAO, unsigned int& VBO, std::vector<float>& lines) {
@@ -142,8 +127,7 @@ public:
 		glBindVertexArray(0);
 	}
 
-	ObjLineRenderer(Shader* shader) : shader(shader) {
-		SetUp();
+	ObjLineRenderer(const Topology::HalfEdgeMesh& mesh, Shader* shader) : mesh(mesh), shader(shader) {
 	}
 
 	~ObjLineRenderer() {
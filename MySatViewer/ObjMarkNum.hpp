@@ -1,43 +1,57 @@
 #pragma once
 
+#include <array>
+
 #include "Topology.hpp"
+#include "EdgeHashMap.hpp"
 #include "ObjInfo.hpp"
 
 using namespace Topology;
 
 /*
-	ȫּ
+	全局计数类
 */
 
 
 class ObjMarkNum {
 public:
-	std::map<TopoType, int> capacities;// Ӧ
-	std::map<Entity*, std::pair<TopoType, int>> markNumMap; // ָӦ
-	std::map<std::pair<TopoType, int>, Entity*> markNumInverseMap; // mapķmap
+	// 由类型与计数访问指针：按类型分开的稠密数组，下标即计数，数组长度即对应类型的最大容量计数
+	// （由指针访问类型与计数直接读Entity::type和Entity::id）
+	std::array<std::vector<Entity*>, TOPO_TYPE_COUNT> entityLists;
 
-	std::vector<std::shared_ptr<Solid>> solids; // ڷʵ
+	std::vector<std::shared_ptr<Solid>> solids; // 用于访问所有实体
 
-	// ôҪάݽṹ
-	std::map<TopoType, std::list<int>> deletedIdListsMap; // ɾԪʱҪʹõmap
-	std::map<std::pair<int, int>, std::shared_ptr<Edge>> edgesMap; // (vertex id, vertex idԣ) -> edgeע⣺ԣ
+	// 有特殊用处需要维护的数据结构
+	std::map<TopoType, std::list<int>> deletedIdListsMap; // 删除元素时需要使用的map
+	EdgeHashMap<std::shared_ptr<Edge>> edgesMap; // (vertex id, vertex id) -> edge，与两个顶点的顺序无关，按边的创建顺序遍历
 
 	ObjMarkNum(const ObjMarkNum&) = delete;
 	ObjMarkNum& operator=(const ObjMarkNum&) = delete;
 
-	// 
+	// 单例
 	static ObjMarkNum& GetInstance() {
 		static ObjMarkNum marknum_instance;
 		return marknum_instance;
 	}
 
-	// ObjInfoذݽṹ
+	// 由ObjInfo加载半边数据结构
 	void LoadFromObjInfo(Info::ObjInfo& obj_info) {
 
 		Clear();
 
-		// 
-		std::vector<std::shared_ptr<Topology::Vertex>> vertex_ptrs; // vertices: б㵼б
+		// 按三角形数预留：每个三角形3条半边、1个环、1个面，闭合网格的边数约为三角形数的1.5倍
+		size_t triangle_count = obj_info.indices.size() / 3;
+		entityLists[static_cast<int>(TopoType::Vertex)].reserve(obj_info.vertices.size() / 3);
+		entityLists[static_cast<int>(TopoType::HalfEdge)].reserve(triangle_count * 3);
+		entityLists[static_cast<int>(TopoType::Edge)].reserve(triangle_count * 3 / 2 + 1);
+		entityLists[static_cast<int>(TopoType::Loop)].reserve(triangle_count);
+		entityLists[static_cast<int>(TopoType::Face)].reserve(triangle_count);
+		entityLists[static_cast<int>(TopoType::Solid)].reserve(obj_info.solidIndicesRange.size());
+		edgesMap.Reserve(triangle_count * 3 / 2 + 1);
+
+		// 顶点
+		std::vector<std::shared_ptr<Topology::Vertex>> vertex_ptrs; // vertices: 顶点列表（顶点导出不能依赖于这个列表）
+		vertex_ptrs.reserve(obj_info.vertices.size() / 3);
 
 		for (int i = 0, j = 0; i < obj_info.vertices.size(); i += 3, j += 1) {
 			auto vertex_ptr = std::make_shared<Topology::Vertex>();
@@ -49,32 +63,24 @@ public:
 
 		auto make_edge = [&](int i, int j) -> std::shared_ptr<Edge> {
 
-			// ע⣺ֻmapkeyҪ֤ģ湹edgeʱõԭʼ˳Ҫʹñkey
-			int search_i = i;
-			int search_j = j;
+			// 一次探测完成查找与插入，键与i、j的顺序无关
+			auto [edge_slot, inserted] = edgesMap.TryEmplace(i, j);
 
-			if (search_i > search_j) {
-				std::swap(search_i, search_j);
-			}
-
-			// ڣ±
-			if (auto it = edgesMap.find({ search_i,search_j }); it == edgesMap.end()) {
+			// 不存在：创建新边
+			if (inserted) {
 				std::shared_ptr<Edge> edge_ptr = std::make_shared<Edge>();
 				UpdateMarkNumMap(edge_ptr);
 
-				// ʼߵϢʱҪŲ棩
-				// ˴ʹԭʼ
+				// 初始化边的信息（到时候可能要挪到函数里面）
+				// 此处必须使用原始顶点索引
 				edge_ptr->st = vertex_ptrs[i];
 				edge_ptr->ed = vertex_ptrs[j];
 
-				edgesMap[{search_i, search_j}] = edge_ptr;
-
-				return edge_ptr;
-			}
-			// ڣ
-			else {
-				return it->second;
+				edge_slot = edge_ptr;
 			}
+
+			// 存在：返回
+			return edge_slot;
 			};
 
 		auto make_halfedge = [&](int i, int j) -> std::shared_ptr<HalfEdge> {
@@ -82,21 +88,21 @@ public:
 			std::shared_ptr<HalfEdge> halfedge_ptr = std::make_shared<HalfEdge>();
 			UpdateMarkNumMap(halfedge_ptr);
 
-			// halfedgeedge
+			// 更新halfedge的edge
 			halfedge_ptr->edge = edge_ptr;
 
-			// sense
-			if (markNumMap[edge_ptr->st.get()].second == i && markNumMap[edge_ptr->ed.get()].second == j) {
+			// 更新sense
+			if (edge_ptr->st->id == i && edge_ptr->ed->id == j) {
 				halfedge_ptr->sense = false;
 			}
 			else {
 				halfedge_ptr->sense = true;
 			}
 
-			// ӴhalfedgeedgehalfedgeListУͬʱhalfedgeListѾеhalfedgeڹϵ
+			// 添加此halfedge到edge的halfedgeList中，同时更新halfedgeList中已经有的halfedge的相邻关系
 			edge_ptr->halfEdges.emplace_back(halfedge_ptr);
 
-			// halfedge˳򴮳һ
+			// 按照halfedge添加顺序串成一个环
 			edge_ptr->UpdateHalfEdgesPartner();
 
 			return halfedge_ptr;
@@ -157,14 +163,14 @@ public:
 			return solid;
 			};
 
-		// ÿsolid
+		// 对于每个solid
 		int s = 0;
 		for (auto solid_range : obj_info.solidIndicesRange) {
 			int range_begin = solid_range.first;
 			int range_end = solid_range.second;
 
 			std::set<std::shared_ptr<Face>> faces;
-			// ӦsolidĶ㷶Χ: ÿ3һ
+			// 对应solid的顶点范围: 每3个点的索引构成一个三角形
 			for (int i = range_begin; i < range_end; i += 3) {
 				int j = i + 1;
 				int k = i + 2;
@@ -198,57 +204,48 @@ public:
 
 	std::shared_ptr<Edge> FindEdgeBetweenVertices(const std::shared_ptr<Topology::Vertex>& v1, const std::shared_ptr<Topology::Vertex>& v2) {
 
-		int v1_id = -1, v2_id = -1;
-		if (auto it = markNumMap.find(v1.get()); it != markNumMap.end()) {
-			v1_id = it->second.second;
-		}
-		else {
-			//SPDLOG_ERROR("v1 is not exist in markNumMap.");
-			return nullptr;
-		}
-
-		if (auto it = markNumMap.find(v2.get()); it != markNumMap.end()) {
-			v2_id = it->second.second;
-		}
-		else {
-			//SPDLOG_ERROR("v2 is not exist in markNumMap.");
+		int v1_id = GetId(v1);
+		int v2_id = GetId(v2);
+		if (v1_id == -1 || v2_id == -1) {
 			return nullptr;
 		}
 
-		if (auto v1_v2_edge_it = edgesMap.find({ v1_id, v2_id }); v1_v2_edge_it != edgesMap.end()) {
-			return v1_v2_edge_it->second;
-		}
-
-		if (auto v2_v1_edge_it = edgesMap.find({ v2_id, v1_id }); v2_v1_edge_it != edgesMap.end()) {
-			return v2_v1_edge_it->second;
+		if (const std::shared_ptr<Edge>* edge = edgesMap.Find(v1_id, v2_id)) {
+			return *edge;
 		}
 
 		return nullptr;
 	}
 
 	void Clear() {
-		capacities.clear();
-		markNumMap.clear();
-		markNumInverseMap.clear();
+		for (auto& entity_list : entityLists) {
+			entity_list.clear();
+		}
 		solids.clear();
 		deletedIdListsMap.clear();
 
-		edgesMap.clear();
+		edgesMap.Clear();
+
+	}
 
+	// 对应类型的最大容量计数
+	int Capacity(TopoType type) const {
+		return static_cast<int>(entityLists[static_cast<int>(type)].size());
 	}
 
-	int GetId(const std::shared_ptr<Entity>& p) {
-		if (auto it = markNumMap.find(p.get()); it != markNumMap.end()) {
-			return it->second.second;
+	// 不是由本类创建（或已经Clear）的实体返回-1
+	int GetId(const std::shared_ptr<Entity>& p) const {
+		if (p && GetEntityPtr({ p->type, p->id }) == p.get()) {
+			return p->id;
 		}
 
 		return -1;
 	}
 
-	TopoType GetType(const std::shared_ptr<Entity>& p) {
+	TopoType GetType(const std::shared_ptr<Entity>& p) const {
 
-		if (auto it = markNumMap.find(p.get()); it != markNumMap.end()) {
-			return it->second.first;
+		if (p && GetEntityPtr({ p->type, p->id }) == p.get()) {
+			return p->type;
 		}
 
 		return TopoType::NoExist;
@@ -284,10 +281,10 @@ public:
 	}
 
 
-	Entity* GetEntityPtr(const std::pair<TopoType, int>& p) {
-		
-		if (auto it = markNumInverseMap.find(p); it != markNumInverseMap.end()) {
-			return it->second;
+	Entity* GetEntityPtr(const std::pair<TopoType, int>& p) const {
+		const std::vector<Entity*>& entity_list = entityLists[static_cast<int>(p.first)];
+		if (p.second >= 0 && p.second < entity_list.size()) {
+			return entity_list[p.second];
 		}
 
 		return nullptr;
@@ -297,16 +294,17 @@ private:
 
 	ObjMarkNum() {}
 
-	// ָ͸UpdateMarkNumMap
-	// ߼
+	// 由指针类型更新UpdateMarkNumMap
+	// 更新逻辑
 	template<typename T>
 	void UpdateMarkNumMap(const std::shared_ptr<T>& ptr) {
 		TopoType topotype_name = GetTypeFromTemplate(ptr);
 
-		auto marknum_pair = std::make_pair(topotype_name, (capacities[topotype_name])++);
+		std::vector<Entity*>& entity_list = entityLists[static_cast<int>(topotype_name)];
 
-		markNumMap[ptr.get()] = marknum_pair;
-		markNumInverseMap[marknum_pair] = ptr.get();
+		ptr->type = topotype_name;
+		ptr->id = static_cast<int>(entity_list.size());
+		entity_list.emplace_back(ptr.get());
 	}
 
 };
\ No newline at end of file
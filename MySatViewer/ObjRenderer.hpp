@@ -7,6 +7,8 @@
 
 #include "ObjInfo.hpp"
 #include "TopologyInfo.hpp"
+#include "CompactVertex.hpp"
+#include "GeometryKernels.hpp"
 
 
 namespace MyRenderEngine {
@@ -17,74 +19,91 @@ namespace MyRenderEngine {
 
 		unsigned int VAO;
 		unsigned int VBO;
+		unsigned int EBO; // 仅索引模式使用
 
-		std::vector<float> newVerticesWithNormal;
-		int verticesCount;
+		int verticesCount; // 非索引模式的顶点数 / 索引模式的索引数
+
+		bool indexed; // 是否直接上传objInfo中的顶点和索引（法向在片段着色器中由屏幕空间导数求出）
+		bool compactVertices; // 是否使用紧凑顶点格式（见CompactVertex.hpp）
+		Utils::QuantizationBox quantizationBox;
 
 		Shader* shader;
 		Shader* transparentShader;
 
 		glm::mat4 modelMatrix{ 1.0f };
 
-		void Setup() {
-			newVerticesWithNormal.clear();
+		void Setup(bool compact_vertices = false, bool indexed_vertices = false) {
+			compactVertices = compact_vertices;
+			indexed = indexed_vertices;
 			verticesCount = 0;
-			VAO = VBO = 0;
-
-			for (int i = 0; i < objInfo.indices.size(); i += 3) {
-				int j = i + 1;
-				int k = i + 2;
-
-				int index_i = objInfo.indices[i];
-				int index_j = objInfo.indices[j];
-				int index_k = objInfo.indices[k];
-
-				auto p1 = objInfo.GetPoint(index_i);
-				auto p2 = objInfo.GetPoint(index_j);
-				auto p3 = objInfo.GetPoint(index_k);
-
-				auto v12 = p2 - p1;
-				auto v13 = p3 - p1;
-				auto normal = v12.Cross(v13);
-
-				newVerticesWithNormal.emplace_back(p1.x());
-				newVerticesWithNormal.emplace_back(p1.y());
-				newVerticesWithNormal.emplace_back(p1.z());
-				newVerticesWithNormal.emplace_back(normal.x());
-				newVerticesWithNormal.emplace_back(normal.y());
-				newVerticesWithNormal.emplace_back(normal.z());
-
-				newVerticesWithNormal.emplace_back(p2.x());
-				newVerticesWithNormal.emplace_back(p2.y());
-				newVerticesWithNormal.emplace_back(p2.z());
-				newVerticesWithNormal.emplace_back(normal.x());
-				newVerticesWithNormal.emplace_back(normal.y());
-				newVerticesWithNormal.emplace_back(normal.z());
-
-				newVerticesWithNormal.emplace_back(p3.x());
-				newVerticesWithNormal.emplace_back(p3.y());
-				newVerticesWithNormal.emplace_back(p3.z());
-				newVerticesWithNormal.emplace_back(normal.x());
-				newVerticesWithNormal.emplace_back(normal.y());
-				newVerticesWithNormal.emplace_back(normal.z());
-
-				verticesCount += 3;
-			}
+			VAO = VBO = EBO = 0;
 
 			glGenVertexArrays(1, &VAO);
 			glGenBuffers(1, &VBO);
 
 			glBindVertexArray(VAO);
 			glBindBuffer(GL_ARRAY_BUFFER, VBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(float) * newVerticesWithNormal.size(), newVerticesWithNormal.data(), GL_STATIC_DRAW);
 
-			glEnableVertexAttribArray(0);
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-			glEnableVertexAttribArray(1);
-			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+			if (indexed) {
+				// 索引模式：顶点和索引原样上传，attribute 1（法向）不启用，不在CPU端保留副本
+				size_t vertex_count = objInfo.vertices.size() / 3;
+
+				if (compactVertices) {
+					quantizationBox = Utils::ComputeQuantizationBox(objInfo.vertices.data(), vertex_count, 3);
+					auto compact = Utils::EncodeCompactPositions(objInfo.vertices.data(), vertex_count, quantizationBox);
+					glBufferData(GL_ARRAY_BUFFER, sizeof(Utils::CompactPosition) * compact.size(), compact.data(), GL_STATIC_DRAW);
+
+					glEnableVertexAttribArray(0);
+					glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Utils::CompactPosition), (void*)0);
+				}
+				else {
+					glBufferData(GL_ARRAY_BUFFER, sizeof(float) * objInfo.vertices.size(), objInfo.vertices.data(), GL_STATIC_DRAW);
+
+					glEnableVertexAttribArray(0);
+					glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+				}
+
+				// ObjInfo中的索引都已检查过非负，按unsigned int上传
+				glGenBuffers(1, &EBO);
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+				glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * objInfo.indices.size(), objInfo.indices.data(), GL_STATIC_DRAW);
+
+				verticesCount = static_cast<int>(objInfo.indices.size());
+			}
+			else {
+				// 每个三角形展开为3个顶点（坐标3个float + 法向3个float），法向和包围盒由GeometryKernels计算
+				// 展开后的数组只在上传期间存在
+				size_t num_tris = objInfo.indices.size() / 3;
+				std::vector<float> vertices_with_normal(num_tris * 18);
+
+				GeometryKernels::Bounds bounds = GeometryKernels::ParallelFillTriangles(vertices_with_normal.data(), num_tris, [&](size_t t, int j) {
+					return objInfo.vertices.data() + 3 * objInfo.indices[3 * t + j];
+				});
+				verticesCount = static_cast<int>(num_tris) * 3;
+
+				if (compactVertices) {
+					quantizationBox = Utils::QuantizationBoxFromBounds(bounds.min, bounds.max);
+					auto compact = Utils::EncodeCompactVertices(vertices_with_normal.data(), verticesCount, quantizationBox);
+					glBufferData(GL_ARRAY_BUFFER, sizeof(Utils::CompactVertex) * compact.size(), compact.data(), GL_STATIC_DRAW);
+
+					glEnableVertexAttribArray(0);
+					glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Utils::CompactVertex), (void*)offsetof(Utils::CompactVertex, position));
+					glEnableVertexAttribArray(1);
+					glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(Utils::CompactVertex), (void*)offsetof(Utils::CompactVertex, normal));
+				}
+				else {
+					glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertices_with_normal.size(), vertices_with_normal.data(), GL_STATIC_DRAW);
+
+					glEnableVertexAttribArray(0);
+					glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+					glEnableVertexAttribArray(1);
+					glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+				}
+			}
 
+			glBindVertexArray(0); // 注意：EBO的绑定记录在VAO中，要先解绑VAO
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
-			glBindVertexArray(0);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 		}
 
 		void Render(
@@ -106,17 +125,29 @@ namespace MyRenderEngine {
 				s->setMatrix4("view", renderInfo.viewMatrix);
 				s->setMatrix4("model", glm::scale(modelMatrix, glm::vec3(renderInfo.scaleFactor)));
 				s->setVec3("viewPos", renderInfo.cameraPos);
+				s->setBool("flatNormalFromDerivatives", indexed);
+				s->setBool("compactVertices", compactVertices);
+				s->setVec3("positionMin", quantizationBox.min);
+				s->setVec3("positionExtent", quantizationBox.extent);
 
 				glBindVertexArray(VAO);
-				//glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(objInfo.indices.size()), GL_UNSIGNED_INT, 0);
-				glDrawArrays(GL_TRIANGLES, 0, verticesCount);
+				if (indexed) {
+					glDrawElements(GL_TRIANGLES, verticesCount, GL_UNSIGNED_INT, 0);
+				}
+				else {
+					glDrawArrays(GL_TRIANGLES, 0, verticesCount);
+				}
 				glBindVertexArray(0);
 
 			}
 		}
 
-		ObjRenderer(Info::ObjInfo& objInfo, Shader* shader, Shader* transparentShader) : objInfo(objInfo), shader(shader), transparentShader(transparentShader), VAO(0), VBO(0), verticesCount(0) {}
-		~ObjRenderer() {}
+		ObjRenderer(Info::ObjInfo& objInfo, Shader* shader, Shader* transparentShader) : objInfo(objInfo), shader(shader), transparentShader(transparentShader), VAO(0), VBO(0), EBO(0), verticesCount(0), indexed(false), compactVertices(false) {}
+		~ObjRenderer() {
+			glDeleteVertexArrays(1, &VAO);
+			glDeleteBuffers(1, &VBO);
+			glDeleteBuffers(1, &EBO);
+		}
 	};
 
 }
\ No newline at end of file
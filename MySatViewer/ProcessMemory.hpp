@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <cstdio>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+/*
+	进程内存统计
+	用途：加载大文件时报告内存占用（峰值是整个进程的历史最大值，不会因为释放内存而下降）
+*/
+
+namespace Utils {
+
+	// 进程的峰值常驻内存（字节）
+	size_t PeakRssBytes() {
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+			return static_cast<size_t>(counters.PeakWorkingSetSize);
+		}
+		return 0;
+#else
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) == 0) {
+			return static_cast<size_t>(usage.ru_maxrss) * 1024; // Linux下单位为KB
+		}
+		return 0;
+#endif
+	}
+
+	// 进程当前的常驻内存（字节）
+	size_t CurrentRssBytes() {
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+			return static_cast<size_t>(counters.WorkingSetSize);
+		}
+		return 0;
+#else
+		size_t pages_total = 0, pages_resident = 0;
+		FILE* f = std::fopen("/proc/self/statm", "r");
+		if (f == nullptr) {
+			return 0;
+		}
+		if (std::fscanf(f, "%zu %zu", &pages_total, &pages_resident) != 2) {
+			pages_resident = 0;
+		}
+		std::fclose(f);
+		return pages_resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+	}
+}
@@ -21,6 +21,7 @@
 #include "json.hpp"
 
 #include "TopologyInfo.hpp"
+#include "JsonFields.hpp"
 
 namespace Info {
 
@@ -42,33 +43,37 @@ namespace Info {
 
 		void _LoadRayJson(const json& data){
 
-			auto ray_infos = data["ray_infos"];
+			const json& ray_infos = Utils::GetJsonRecords(data, "ray_infos");
 
 			things.rayInfos.reserve(ray_infos.size());
 
-
+			Utils::FieldFailures failures;
 			for (auto&& element : ray_infos) {
-				try {
-					auto start_point_element = element.at("st");
-					glm::vec3 start_point{ start_point_element[0],  start_point_element[1], start_point_element[2]};
-
-					auto direction_element = element.at("d");
-					glm::vec3 direction{ direction_element[0], direction_element[1], direction_element[2] };
-
-					float r = element.at("r");
-
-					int id = element.at("id");
-					int from_cell_id = element.at("from");
-					int to_meshbox_id = element.at("to");
-					int result = element.at("res");
-
+				glm::vec3 start_point;
+				glm::vec3 direction;
+				float r = 0.0f;
+				int id = 0;
+				int from_cell_id = 0;
+				int to_meshbox_id = 0;
+				int result = 0;
+
+				bool ok = true;
+				ok &= Utils::GetJsonVec3Array(element, "st", start_point, failures);
+				ok &= Utils::GetJsonVec3Array(element, "d", direction, failures);
+				ok &= Utils::GetJsonNumber(element, "r", r, failures);
+				ok &= Utils::GetJsonNumber(element, "id", id, failures);
+				ok &= Utils::GetJsonNumber(element, "from", from_cell_id, failures);
+				ok &= Utils::GetJsonNumber(element, "to", to_meshbox_id, failures);
+				ok &= Utils::GetJsonNumber(element, "res", result, failures);
+
+				if (ok) {
 					things.rayInfos.push_back({ start_point , direction , r, id, from_cell_id, to_meshbox_id, result });
 				}
-				catch (json::out_of_range& e) {
-					SPDLOG_INFO("Ray load failed");
+				else {
+					failures.failedRecords++;
 				}
-
 			}
+			failures.Log("Rays", ray_infos.size());
 
 		}
 
@@ -50,7 +50,7 @@ namespace MyRenderEngine {
 				glm::vec3 ed = one_ray_info.start_point + one_ray_info.direction * one_ray_info.r;
 
 				
-				// ָֻ룬ãΪò޸õĶ
+				// 这里只能用指针，不能用引用，因为引用不能修改所引用的对象
 				auto target_lines_ptr = &green_lines;
 
 				if (one_ray_info.result == 0) {
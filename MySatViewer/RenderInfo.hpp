@@ -7,18 +7,20 @@
 namespace MyRenderEngine {
 
 	/*
-		ȾѭIRenderableȾϢ
+		用来在渲染循环中向各个IRenderable传递渲染用信息
 	*/
 	struct RenderInfo {
 		glm::mat4 projectionMatrix;
 		glm::mat4 viewMatrix;
 		glm::vec3 cameraPos;
 		float scaleFactor;
+		int viewportHeight; // 帧缓冲的高度（像素），用于把屏幕空间的误差换算到模型空间
 
 		bool showModel;
-		bool transparentModel; // ͸ҪͨжϵĸɫȻȾTargetҪǰֶָ
+		bool transparentModel; // 可透明物体需要通过这个变量判断调用哪个着色器，当然渲染到的Target还是需要提前手动指定的
 
 		RenderInfo() :
+			viewportHeight(1),
 			showModel(false),
 			transparentModel(false)
 		{
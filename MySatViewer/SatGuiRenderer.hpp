@@ -24,18 +24,40 @@ namespace MyRenderEngine {
 	public:
 		Info::SatInfo& satInfo;
 
-		// TODO
 		void RenderVertexInfos() {
+			if (ImGui::TreeNode("Vertices")) {
+				int id = 0;
+
+				// 按markNum的顺序列出
+				for (int i : satInfo.brepInfo.vertexOrder) {
+					Info::VertexInfo& vertex_info = satInfo.brepInfo.vertexInfos[i];
+
+					ImGui::PushID(id++);
+
+					if (ImGui::TreeNode("", "Vertex: %d", vertex_info.markNum)) {
+						ImGui::Text("Body ID: %d", vertex_info.bodyId);
+						ImGui::Text("Pos: (%f, %f, %f)", vertex_info.pos.x, vertex_info.pos.y, vertex_info.pos.z);
+						RenderGoButton(vertex_info.pos);
+
+						ImGui::TreePop();
+					}
+
+					ImGui::PopID();
+				}
 
+				ImGui::TreePop();
+			}
 		}
 
 		void RenderEdgeInfos() {
 			if (ImGui::TreeNode("Edges")) {
 				int id = 0;
 
-				for (Info::EdgeInfo& edge_info : satInfo.brepInfo.edgeInfos) {
+				// 按markNum的顺序列出
+				for (int i : satInfo.brepInfo.edgeOrder) {
+					Info::EdgeInfo& edge_info = satInfo.brepInfo.edgeInfos[i];
 
-					// Էαɫ
+					// 对非流形编特殊着色
 					bool color_flag = false;
 					ImU32 treenode_color;
 					if (edge_info.nonmanifoldCount == 1) {
@@ -57,9 +79,12 @@ namespace MyRenderEngine {
 						ImGui::Text("Nonmanifold Count: %d", edge_info.nonmanifoldCount);
 						ImGui::Text("Body ID: %d", edge_info.bodyId);
 						ImGui::Text("Edge Mid Pos: (%f, %f, %f)", edge_info.pos.x, edge_info.pos.y, edge_info.pos.z);
+						RenderEdgeVertex("Start Vertex", edge_info.stMarkNum);
+						RenderEdgeVertex("End Vertex", edge_info.edMarkNum);
+						RenderEdgeGeometry(edge_info.geometryIndex);
 
 						if (ImGui::Button("Go")) {
-							// λõ¼
+							// 设置相机位置的事件
 
 							EventSystem::SetCameraPosEvent e{ edge_info.pos };
 							EventSystem::Dispatcher::GetInstance().Dispatch(e);
@@ -80,17 +105,206 @@ namespace MyRenderEngine {
 			}
 		}
 
-		// TODO
+		// 边的端点：通过markNum索引直接找到顶点
+		void RenderEdgeVertex(const char* label, int mark_num) {
+			const Info::VertexInfo* vertex_info = satInfo.brepInfo.vertexIndex.Find(satInfo.brepInfo.vertexInfos, mark_num);
+			if (vertex_info == nullptr) {
+				ImGui::Text("%s: %d (not loaded)", label, mark_num);
+				return;
+			}
+			ImGui::Text("%s: %d (%f, %f, %f)", label, mark_num, vertex_info->pos.x, vertex_info->pos.y, vertex_info->pos.z);
+		}
+
+		// 边的几何直接从satInfo的边几何表中读取。只在节点展开时调用，延迟解码的参数在这里第一次用到时读取
+		void RenderEdgeGeometry(int row) {
+			const Info::EdgeGeometryTable& geometries = satInfo.brepInfo.edgeGeometries;
+			if (row < 0) {
+				ImGui::Text("Curve Type: (load failed)");
+				return;
+			}
+
+			ImGui::Text("Curve Type: %s", geometries.CurveTypeName(row).c_str());
+			ImGui::Text("Sampled Points: %d", static_cast<int>(geometries.PointCount(row)));
+
+			if (!satInfo.DecodeEdgeGeometry(row)) {
+				ImGui::Text("Property: (load failed)");
+				return;
+			}
+
+			switch (geometries.curveTypes[row]) {
+			case Info::CurveType::STRAIGHT: {
+				const Info::StraightCurveParams& straight = geometries.Straight(row);
+				ImGui::Text("Root Point: (%f, %f, %f)", straight.rootPoint.x, straight.rootPoint.y, straight.rootPoint.z);
+				ImGui::Text("Direction: (%f, %f, %f)", straight.direction.x, straight.direction.y, straight.direction.z);
+				break;
+			}
+			case Info::CurveType::ELLIPSE: {
+				const Info::EllipseCurveParams& ellipse = geometries.Ellipse(row);
+				ImGui::Text("Centre: (%f, %f, %f)", ellipse.centre.x, ellipse.centre.y, ellipse.centre.z);
+				ImGui::Text("Normal: (%f, %f, %f)", ellipse.normal.x, ellipse.normal.y, ellipse.normal.z);
+				ImGui::Text("Major Axis: (%f, %f, %f)", ellipse.majorAxis.x, ellipse.majorAxis.y, ellipse.majorAxis.z);
+				ImGui::Text("Major / Minor Length: %f / %f", ellipse.majorAxisLength, ellipse.minorAxisLength);
+				break;
+			}
+			case Info::CurveType::INTCURVE:
+				ImGui::Text("Control Points: %d", static_cast<int>(geometries.IntcurveCtrlptCount(row)));
+				break;
+			default:
+				break;
+			}
+		}
+
 		void RenderHalfEdgeInfos() {
+			if (ImGui::TreeNode("HalfEdges")) {
+				int id = 0;
+
+				for (int i : satInfo.brepInfo.halfEdgeOrder) {
+					Info::HalfEdgeInfo& half_edge_info = satInfo.brepInfo.halfEdgeInfos[i];
+
+					ImGui::PushID(id++);
+
+					if (ImGui::TreeNode("", "HalfEdge: %d", half_edge_info.markNum)) {
+						// 读取失败的占位记录只有markNum
+						const Info::HalfEdgeGeometry* geometry = half_edge_info.halfEdgeGeometry.get();
+						if (geometry == nullptr) {
+							ImGui::Text("(load failed)");
+						}
+						else {
+							ImGui::Text("Body ID: %d", half_edge_info.bodyId);
+							ImGui::Text("Sense: %s", half_edge_info.sense ? "reversed" : "forward");
+							ImGui::Text("Edge: %d", half_edge_info.edgeMarkNum);
+							ImGui::Text("Partner: %d", half_edge_info.partnerMarkNum);
+							ImGui::Text("Pre / Next: %d / %d", half_edge_info.preMarkNum, half_edge_info.nextMarkNum);
+							ImGui::Text("Loop: %d", half_edge_info.loopMarkNum);
+							RenderHalfEdgeGeometry(*geometry);
+							RenderGoButton(half_edge_info.pos);
+						}
+
+						ImGui::TreePop();
+					}
+
+					ImGui::PopID();
+				}
 
+				ImGui::TreePop();
+			}
+		}
+
+		void RenderHalfEdgeGeometry(const Info::HalfEdgeGeometry& geometry) {
+			ImGui::Text("Curve Type: %s", geometry.curveType.empty() ? "(none)" : geometry.curveType.c_str());
+			if (geometry.curveType == "pcurve") {
+				const auto& pcurve = static_cast<const Info::PcurveHalfEdgeGeometry&>(geometry);
+				ImGui::Text("Degree: %d", pcurve.curveDegree);
+				ImGui::Text("Control Points: %d, Knots: %d", static_cast<int>(pcurve.ctrlpts.size()), static_cast<int>(pcurve.knots.size()));
+			}
 		}
 
-		// TODO
 		void RenderLoopInfos() {
+			if (ImGui::TreeNode("Loops")) {
+				int id = 0;
+
+				for (int i : satInfo.brepInfo.loopOrder) {
+					Info::LoopInfo& loop_info = satInfo.brepInfo.loopInfos[i];
+
+					ImGui::PushID(id++);
+
+					if (ImGui::TreeNode("", "Loop: %d", loop_info.markNum)) {
+						ImGui::Text("Body ID: %d", loop_info.bodyId);
+						ImGui::Text("Face: %d", loop_info.faceMarkNum);
+						RenderMarkNumList("HalfEdges", loop_info.halfEdgesMarkNums);
+						RenderGoButton(loop_info.pos);
+
+						ImGui::TreePop();
+					}
+
+					ImGui::PopID();
+				}
+
+				ImGui::TreePop();
+			}
 		}
 
-		// TODO
 		void RenderFaceInfos() {
+			if (ImGui::TreeNode("Faces")) {
+				int id = 0;
+
+				for (int i : satInfo.brepInfo.faceOrder) {
+					Info::FaceInfo& face_info = satInfo.brepInfo.faceInfos[i];
+
+					ImGui::PushID(id++);
+
+					if (ImGui::TreeNode("", "Face: %d", face_info.markNum)) {
+						const Info::FaceGeometry* geometry = face_info.faceGeometry.get();
+						if (geometry == nullptr) {
+							ImGui::Text("(load failed)");
+						}
+						else {
+							ImGui::Text("Body ID: %d", face_info.bodyId);
+							ImGui::Text("Loop: %d", face_info.stLoopMarkNum);
+							RenderFaceGeometry(*geometry);
+							RenderGoButton(face_info.pos);
+						}
+
+						ImGui::TreePop();
+					}
+
+					ImGui::PopID();
+				}
+
+				ImGui::TreePop();
+			}
+		}
+
+		// 面的几何没有虚函数，按faceType转换为具体的类型（与SatInfo中创建时的类型名一致）
+		void RenderFaceGeometry(const Info::FaceGeometry& geometry) {
+			ImGui::Text("Face Type: %s", geometry.faceType.empty() ? "(none)" : geometry.faceType.c_str());
+			if (geometry.faceType == "plane") {
+				const auto& plane = static_cast<const Info::PlaneFaceGeometry&>(geometry);
+				ImGui::Text("Root Point: (%f, %f, %f)", plane.rootPoint.x, plane.rootPoint.y, plane.rootPoint.z);
+				ImGui::Text("Normal: (%f, %f, %f)", plane.normal.x, plane.normal.y, plane.normal.z);
+			}
+			else if (geometry.faceType == "sphere") {
+				const auto& sphere = static_cast<const Info::SphereFaceGeometry&>(geometry);
+				ImGui::Text("Centre: (%f, %f, %f)", sphere.centre.x, sphere.centre.y, sphere.centre.z);
+				ImGui::Text("Radius: %f", sphere.radius);
+			}
+			else if (geometry.faceType == "torus") {
+				const auto& torus = static_cast<const Info::TorusFaceGeometry&>(geometry);
+				ImGui::Text("Centre: (%f, %f, %f)", torus.centre.x, torus.centre.y, torus.centre.z);
+				ImGui::Text("Normal: (%f, %f, %f)", torus.normal.x, torus.normal.y, torus.normal.z);
+				ImGui::Text("Major / Minor Radius: %f / %f", torus.majorRadius, torus.minorRadius);
+			}
+			else if (geometry.faceType == "cone") {
+				const auto& cone = static_cast<const Info::ConeFaceGeometry&>(geometry);
+				ImGui::Text("Root Point: (%f, %f, %f)", cone.rootPoint.x, cone.rootPoint.y, cone.rootPoint.z);
+				ImGui::Text("Major Axis: (%f, %f, %f)", cone.majorAxis.x, cone.majorAxis.y, cone.majorAxis.z);
+				ImGui::Text("Direction: (%f, %f, %f)", cone.direction.x, cone.direction.y, cone.direction.z);
+				ImGui::Text("Ratio: %f, Angle: %f", cone.ratio, cone.angle);
+			}
+			else if (geometry.faceType == "spline") {
+				const auto& spline = static_cast<const Info::SplineFaceGeometry&>(geometry);
+				ImGui::Text("Degree U / V: %d / %d", spline.degreeU, spline.degreeV);
+				ImGui::Text("Control Points: %d x %d (%d)", spline.numU, spline.numV, static_cast<int>(spline.ctrlpts.size()));
+				ImGui::Text("Knots U / V: %d / %d, Weights: %d", static_cast<int>(spline.uknots.size()), static_cast<int>(spline.vknots.size()), static_cast<int>(spline.weights.size()));
+			}
+		}
+
+		// markNum列表，节点展开时才逐个列出
+		void RenderMarkNumList(const char* label, const std::vector<int>& mark_nums) {
+			if (ImGui::TreeNode(label, "%s: %d", label, static_cast<int>(mark_nums.size()))) {
+				for (int mark_num : mark_nums) {
+					ImGui::Text("%d", mark_num);
+				}
+				ImGui::TreePop();
+			}
+		}
+
+		void RenderGoButton(const glm::vec3& pos) {
+			if (ImGui::Button("Go")) {
+				// 设置相机位置的事件
+				EventSystem::SetCameraPosEvent e{ pos };
+				EventSystem::Dispatcher::GetInstance().Dispatch(e);
+			}
 		}
 
 
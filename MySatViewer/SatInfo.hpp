@@ -13,23 +13,56 @@
 
 #include <stdexcept>
 #include <cassert>
+#include <cstring>
+#include <cstdint>
+#include <cctype>
+#include <chrono>
+#include <charconv>
+#include <filesystem>
 
 #include "stl_reader.h"
 #include "json.hpp"
 
 #include "TopologyInfo.hpp"
+#include "GeometryJsonSax.hpp"
+#include "GeometryJsonFast.hpp"
+#include "GeometryCache.hpp"
+#include "MarkNumIndex.hpp"
+#include "JsonFields.hpp"
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+#include "GeometryKernels.hpp"
+#include "ProcessMemory.hpp"
+#include "Utils.hpp"
 
 #include <spdlog/spdlog.h>
 
 
 namespace Info {
 
+	// stl中一段连续的绘制范围，单位与stlVerticesCount相同（非索引模式为顶点，索引模式为索引）
+	struct StlRange {
+		std::string name;
+		int first = 0;
+		int count = 0;
+		bool visible = true; // 渲染时是否绘制
+		bool highlighted = false; // 渲染时是否高亮
+		int markNum = -1; // 面的范围：对应的面markNum（-1表示该part没有面信息）
+		int parent = -1; // solid的范围：所属part在stlParts中的下标；面的范围：所属solid在stlSolids中的下标
+	};
+
+	// stl加载选项
+	struct StlLoadOptions {
+		bool indexed = false; // 是否使用索引模式
+		double weldTolerance = Topology::GLOBAL_TOLERANCE; // 顶点焊接容差：各分量之差都不超过该值的顶点视为同一个点（默认与拓扑的容差一致），0表示只合并完全相同的坐标
+	};
+
 	struct SatInfo {
 
 		using json = nlohmann::json;
 
 
-		// ͳϢ
+		// 统计信息
 		struct BasicStat {
 			int marknum_body;
 			int marknum_coedge;
@@ -42,82 +75,1298 @@ namespace Info {
 			int marknum_wire;
 		} stats;
 
-		// stlϢȾsatģ͵ı
+		// stl信息：用于渲染sat模型的表面
 		struct StlSOA {
-			std::vector<float> stlVertices; // ע⣺ÿ˵6floatϢ3normal 3ʵʲҪ6ÿ3ĵ㣨Ҳÿ3*6=18ֵһ
-			int stlVerticesCount; // ¼ǲغstlжֵӦstlVertices.size() / 6
-			std::vector<int> stlTriangleToFaceMarkNums; // ÿζӦmarkNumӦεΧ0 to stlVerticesCount/3 -1 ;ɽɴɫָ
+			Utils::UninitVector<float> stlVertices; // 注意：对每个点来说都含有6个float的信息（坐标3个，normal 3个），因此实际采样点数量需要除以6。每3个连续的点（也即这个数组中每3*6=18个值）是一个三角形
+			int stlVerticesCount; // 记录的是不考虑重合情况下stl中所有顶点数（数值应当等于stlVertices.size() / 6）
+			std::vector<int> stlTriangleToFaceMarkNums; // 每个三角形对应的面的markNum。输入索引应当是三角形的索引（索引范围：0 to stlVerticesCount/3 -1 ）。用途：可借由此用颜色区分各个面
+
+			// 索引模式：indexed为true时stlVertices为空，改用去重后的顶点和三角形索引渲染（法向在片段着色器中由导数求出）
+			bool indexed = false;
+			std::vector<float> stlUniqueCoords; // 去重后的顶点坐标，每3个float为一个顶点
+			std::vector<unsigned int> stlTriangleIndices; // 每3个索引为一个三角形，此时stlVerticesCount等于stlTriangleIndices.size()
+
+			std::vector<StlRange> stlParts; // 每个stl文件对应的绘制范围（同时加载多个part文件时有多个）
+			std::vector<StlRange> stlSolids; // 每个solid的绘制范围（ASCII stl中的 solid ... endsolid，二进制stl整个文件是一个solid）
+			std::vector<StlRange> stlFaces; // 每个面的绘制范围。加载了面信息的part中三角形在各solid内按面markNum排过序，每个面是连续的一段；没有面信息的solid整体作为一个范围
 		}stl;
 
-		// ߽ʾϢGUIʾsatģиб
+		// 边界表示信息，用于在GUI中显示sat模型中各个对象列表
+		// 各记录按读取的顺序保存；按markNum查找用xxxIndex，按markNum顺序遍历用xxxOrder（见MarkNumIndex.hpp）
 		struct BrepInfo {
-			std::vector<VertexInfo> vertexInfos; // Ϣ
-			std::vector<EdgeInfo> edgeInfos; // Ϣ
-			std::vector<HalfEdgeInfo> halfEdgeInfos; // Ϣ
-			std::vector<LoopInfo> loopInfos; // Ϣ
+			std::vector<VertexInfo> vertexInfos; // 顶点信息
+			std::vector<EdgeInfo> edgeInfos; // 边信息
+			EdgeGeometryTable edgeGeometries; // 边的几何，行号见EdgeInfo::geometryIndex
+			std::vector<HalfEdgeInfo> halfEdgeInfos; // 半边信息
+			std::vector<LoopInfo> loopInfos; // 环信息
 			std::vector<FaceInfo> faceInfos;
+
+			MarkNumIndex vertexIndex;
+			MarkNumIndex edgeIndex;
+			MarkNumIndex halfEdgeIndex;
+			MarkNumIndex loopIndex;
+			MarkNumIndex faceIndex;
+
+			std::vector<int> vertexOrder; // 按markNum排序的下标
+			std::vector<int> edgeOrder;
+			std::vector<int> halfEdgeOrder;
+			std::vector<int> loopOrder;
+			std::vector<int> faceOrder;
 		}brepInfo;
 
-		glm::vec3 newCameraPos; // ɺĬλ
+		glm::vec3 newCameraPos; // 加载完成后，用来更新默认相机位置
+
+		StlLoadOptions stlLoadOptions; // 最近一次LoadStl使用的选项
 
+		bool useGeometryCache = true; // LoadGeometryJson是否读写旁边的二进制缓存（见GeometryCache.hpp）
+		bool useFastGeometryJsonParser = true; // LoadGeometryJson是否先尝试专用解析器，false时直接用nlohmann的SAX解析
+		bool lazyEdgeProperties = false; // LoadGeometryJson解析时是否先不读取边的property，用到时再由DecodeEdgeGeometry读取（只有专用解析器支持）
 
-		void LoadStl(const std::string& stl_path, const std::string& stl_triangle_marknum_file_path = "") {
+		std::string geometryJsonPath; // 最近一次LoadGeometryJson的文件，延迟解码时从中读取边的记录
+
+		// stl_triangle_marknum_file_path为空时，自动查找stl旁边同名的 .facemap / .faceinfo 文件
+		void LoadStl(const std::string& stl_path, const std::string& stl_triangle_marknum_file_path = "", const StlLoadOptions& options = StlLoadOptions()) {
+			LoadStls({ stl_path }, options, { stl_triangle_marknum_file_path });
+		}
+
+		// 同时加载多个stl（一个模型导出的多个part文件）：各文件在线程池上并发解析，之后按顺序拼接进同一份顶点数据，
+		// stl.stlParts 中记录每个文件对应的绘制范围
+		// face_file_paths[i] 为第i个文件的三角形-面对应文件，缺省或为空时自动查找（见_FindFaceFile）
+		void LoadStls(const std::vector<std::string>& stl_paths, const StlLoadOptions& options = StlLoadOptions(), const std::vector<std::string>& face_file_paths = {}) {
 
 			newCameraPos = glm::vec3{ 100.0f };
-			stl_reader::StlMesh <float, unsigned int> mesh(stl_path);
+
+			stlLoadOptions = options;
 
 			stl.stlVertices.clear();
 			stl.stlVerticesCount = 0;
+			stl.indexed = options.indexed;
+			stl.stlUniqueCoords.clear();
+			stl.stlTriangleIndices.clear();
+			stl.stlTriangleToFaceMarkNums.clear();
+			stl.stlParts.clear();
+			stl.stlSolids.clear();
+			stl.stlFaces.clear();
+
+			std::vector<StlSOA> parts(stl_paths.size());
+			std::vector<glm::vec3> parts_min_pos(stl_paths.size(), newCameraPos);
+
+			// 每个文件一个任务；文件内部的并行在工作线程上会退化为串行，只有一个文件时则由文件内部并行
+			Utils::ThreadPool::GetInstance().ParallelFor(stl_paths.size(), [&](size_t begin, size_t end, size_t chunk_index) {
+				for (size_t i = begin; i < end; i++) {
+					std::string face_file_path = i < face_file_paths.size() ? face_file_paths[i] : "";
+					if (face_file_path.empty()) {
+						face_file_path = _FindFaceFile(stl_paths[i]);
+					}
+
+					// 有面信息时记下焊接后每个原三角形的新下标，面信息按文件中的三角形给出
+					std::vector<unsigned int> triangle_map;
+					_LoadStlPart(stl_paths[i], parts[i], parts_min_pos[i], face_file_path.empty() ? nullptr : &triangle_map);
+
+					if (!face_file_path.empty()) {
+						_LoadStlPartFaces(face_file_path, parts[i], triangle_map);
+					}
+				}
+			}, 1);
+
+			_PackStlParts(stl_paths, parts);
+
+			for (auto& min_pos : parts_min_pos) {
+				newCameraPos = glm::min(newCameraPos, min_pos);
+			}
+
+			newCameraPos += glm::vec3{ 20.0f }; // 偏移
+
+			if (stl_paths.size() > 1) {
+				SPDLOG_INFO("Loaded {} STL parts: {} vertices in total.", stl_paths.size(), stl.stlVerticesCount);
+			}
+		}
+
+		// 加载单个stl文件到part中，min_pos为该文件的坐标最小值
+		// triangle_map不为空时，返回文件中每个三角形在part中的下标（被stl_reader去掉的退化三角形为UINT_MAX）；没有去掉三角形的加载方式把它留空
+		void _LoadStlPart(const std::string& stl_path, StlSOA& part, glm::vec3& min_pos, std::vector<unsigned int>* triangle_map = nullptr) {
+			if (stlLoadOptions.indexed) {
+				_LoadStlIndexed(stl_path, part, min_pos, triangle_map);
+			}
+			else {
+				// 二进制STL走内存映射的快速路径；ASCII（或者文件大小不合法的二进制文件）仍然交给stl_reader
+				bool loaded = false;
+				if (!stl_reader::StlFileHasASCIIFormat(stl_path.c_str())) {
+					loaded = _LoadStlBinaryMapped(stl_path, part, min_pos);
+				}
+
+				if (!loaded) {
+					_LoadStlByStlReader(stl_path, part, min_pos, triangle_map);
+				}
+			}
+		}
+
+		// 把各part按顺序拼接到stl中。索引模式下后面part的索引要加上前面所有part的顶点数
+		void _PackStlParts(const std::vector<std::string>& stl_paths, std::vector<StlSOA>& parts) {
+			if (parts.size() == 1) {
+				std::swap(stl.stlVertices, parts[0].stlVertices);
+				std::swap(stl.stlUniqueCoords, parts[0].stlUniqueCoords);
+				std::swap(stl.stlTriangleIndices, parts[0].stlTriangleIndices);
+			}
+
+			std::vector<size_t> vertices_offsets(parts.size() + 1, 0);
+			std::vector<size_t> coords_offsets(parts.size() + 1, 0);
+			std::vector<size_t> indices_offsets(parts.size() + 1, 0);
+
+			bool has_faces = false;
+			for (auto& part : parts) {
+				has_faces |= !part.stlTriangleToFaceMarkNums.empty();
+			}
+
+			for (size_t i = 0; i < parts.size(); i++) {
+				StlRange range;
+				range.name = std::filesystem::path(stl_paths[i]).filename().string();
+				range.first = stl.stlVerticesCount;
+				range.count = parts[i].stlVerticesCount;
+				stl.stlParts.push_back(range);
+
+				// solid和面的范围平移到拼接后的位置；没有面信息时每个solid整体作为一个范围，保证stlFaces覆盖所有三角形
+				int solids_base = static_cast<int>(stl.stlSolids.size());
+				for (StlRange solid : parts[i].stlSolids) {
+					if (parts.size() > 1) {
+						solid.name = range.name + ": " + solid.name;
+					}
+					solid.first += stl.stlVerticesCount;
+					solid.parent = static_cast<int>(i);
+					stl.stlSolids.push_back(solid);
+				}
+
+				if (parts[i].stlFaces.empty()) {
+					for (size_t j = 0; j < parts[i].stlSolids.size(); j++) {
+						StlRange face = parts[i].stlSolids[j];
+						face.name = "(no face info)";
+						face.parent = static_cast<int>(j);
+						parts[i].stlFaces.push_back(face);
+					}
+				}
+				for (StlRange face : parts[i].stlFaces) {
+					face.first += stl.stlVerticesCount;
+					face.parent += solids_base;
+					stl.stlFaces.push_back(face);
+				}
+
+				if (has_faces) {
+					if (parts[i].stlTriangleToFaceMarkNums.empty()) {
+						stl.stlTriangleToFaceMarkNums.insert(stl.stlTriangleToFaceMarkNums.end(), parts[i].stlVerticesCount / 3, -1);
+					}
+					else {
+						stl.stlTriangleToFaceMarkNums.insert(stl.stlTriangleToFaceMarkNums.end(), parts[i].stlTriangleToFaceMarkNums.begin(), parts[i].stlTriangleToFaceMarkNums.end());
+					}
+				}
+
+				stl.stlVerticesCount += parts[i].stlVerticesCount;
+
+				vertices_offsets[i + 1] = vertices_offsets[i] + parts[i].stlVertices.size();
+				coords_offsets[i + 1] = coords_offsets[i] + parts[i].stlUniqueCoords.size();
+				indices_offsets[i + 1] = indices_offsets[i] + parts[i].stlTriangleIndices.size();
+			}
+
+			if (parts.size() == 1) {
+				return;
+			}
+
+			stl.stlVertices.resize(vertices_offsets.back());
+			stl.stlUniqueCoords.resize(coords_offsets.back());
+			stl.stlTriangleIndices.resize(indices_offsets.back());
+
+			Utils::ThreadPool::GetInstance().ParallelFor(parts.size(), [&](size_t begin, size_t end, size_t chunk_index) {
+				for (size_t i = begin; i < end; i++) {
+					std::copy(parts[i].stlVertices.begin(), parts[i].stlVertices.end(), stl.stlVertices.begin() + vertices_offsets[i]);
+					std::copy(parts[i].stlUniqueCoords.begin(), parts[i].stlUniqueCoords.end(), stl.stlUniqueCoords.begin() + coords_offsets[i]);
+
+					unsigned int base_vertex = static_cast<unsigned int>(coords_offsets[i] / 3);
+					for (size_t j = 0; j < parts[i].stlTriangleIndices.size(); j++) {
+						stl.stlTriangleIndices[indices_offsets[i] + j] = parts[i].stlTriangleIndices[j] + base_vertex;
+					}
+				}
+			}, 1);
+		}
+
+		// 三角形-面对应文件
+		// .facemap（二进制，小端）：
+		//   uint32 magic 'FMAP'，uint32 version(=2)，uint32 三角形数量，uint32 段数，
+		//   uint64 生成它的.faceinfo的大小，int64 .faceinfo的修改时间（由.faceinfo生成时用于判断是否过期，否则都为0）
+		//   之后每段8字节：int32 面markNum，uint32 三角形数量（连续属于同一个面的三角形合并为一段）
+		// .faceinfo（文本）：每行一个三角形对应的面markNum，以 end 开头的行结束
+		static constexpr uint32_t FACE_MAP_MAGIC = 0x50414D46; // "FMAP"
+		static constexpr uint32_t FACE_MAP_VERSION = 2;
+
+		struct FaceMapHeader {
+			uint32_t magic = FACE_MAP_MAGIC;
+			uint32_t version = FACE_MAP_VERSION;
+			uint32_t triangleCount = 0;
+			uint32_t runCount = 0;
+			uint64_t sourceSize = 0;
+			int64_t sourceTime = 0;
+		};
+
+		// 文件的大小与修改时间，不存在时返回false
+		static bool _FileStamp(const std::filesystem::path& path, uint64_t& size, int64_t& time) {
+			std::error_code ec;
+			size = std::filesystem::file_size(path, ec);
+			if (ec) {
+				return false;
+			}
+			time = static_cast<int64_t>(std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+			return !ec;
+		}
+
+		// .facemap是否由当前的.faceinfo生成
+		static bool _FaceMapIsCurrent(const std::filesystem::path& face_map_path, const std::filesystem::path& face_info_path) {
+			uint64_t size = 0;
+			int64_t time = 0;
+			if (!_FileStamp(face_info_path, size, time)) {
+				return false;
+			}
+
+			FaceMapHeader header;
+			std::ifstream in(face_map_path, std::ios::binary);
+			if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+				return false;
+			}
+			return header.magic == FACE_MAP_MAGIC && header.version == FACE_MAP_VERSION && header.sourceSize == size && header.sourceTime == time;
+		}
+
+		// 查找stl旁边同名的面对应文件，找不到时返回空
+		// 优先使用二进制格式；.faceinfo也存在而.facemap不是由它生成的（例如.faceinfo重新生成过）时，使用.faceinfo
+		static std::string _FindFaceFile(const std::string& stl_path) {
+			std::filesystem::path face_map_path = std::filesystem::path(stl_path).replace_extension(".facemap");
+			std::filesystem::path face_info_path = std::filesystem::path(stl_path).replace_extension(".faceinfo");
+			bool has_face_map = std::filesystem::exists(face_map_path);
+			bool has_face_info = std::filesystem::exists(face_info_path);
+
+			if (has_face_map && (!has_face_info || _FaceMapIsCurrent(face_map_path, face_info_path))) {
+				return face_map_path.string();
+			}
+			if (has_face_info) {
+				if (has_face_map) {
+					SPDLOG_INFO("Face map file {} is out of date, using {}", face_map_path.string(), face_info_path.string());
+				}
+				return face_info_path.string();
+			}
+			return "";
+		}
+
+		// 读取每个三角形对应的面markNum，文件不存在或格式错误时返回false
+		static bool _ReadFaceFile(const std::string& path, std::vector<int>& triangle_marknums) {
+			triangle_marknums.clear();
+
+			Utils::MappedFile file;
+			if (!file.Open(path)) {
+				return false;
+			}
+
+			FaceMapHeader header;
+			header.magic = 0;
+			if (file.Size() >= sizeof(header)) {
+				std::memcpy(&header, file.Data(), sizeof(header));
+			}
+
+			if (header.magic == FACE_MAP_MAGIC) {
+				if (header.version != FACE_MAP_VERSION || file.Size() != sizeof(header) + 8ull * header.runCount) {
+					SPDLOG_WARN("Invalid face map file: {}", path);
+					return false;
+				}
+
+				// 先读出所有段并检查三角形总数，文件截断或损坏时不会按错误的数量分配内存
+				std::vector<int32_t> runs(2ull * header.runCount);
+				std::memcpy(runs.data(), file.Data() + sizeof(header), sizeof(int32_t) * runs.size());
+
+				uint64_t total = 0;
+				for (size_t i = 0; i < runs.size(); i += 2) {
+					total += static_cast<uint32_t>(runs[i + 1]);
+				}
+				if (total != header.triangleCount) {
+					SPDLOG_WARN("Invalid face map file: {}", path);
+					return false;
+				}
+
+				triangle_marknums.reserve(header.triangleCount);
+				for (size_t i = 0; i < runs.size(); i += 2) {
+					triangle_marknums.insert(triangle_marknums.end(), static_cast<uint32_t>(runs[i + 1]), runs[i]);
+				}
+				return true;
+			}
+
+			// 文本格式
+			const char* p = file.Data();
+			const char* end = p + file.Size();
+			while (p < end) {
+				while (p < end && std::isspace(static_cast<unsigned char>(*p))) {
+					p++;
+				}
+				if (p == end || *p == 'e') {
+					break;
+				}
+
+				int marknum = 0;
+				auto res = std::from_chars(p, end, marknum);
+				if (res.ec != std::errc()) {
+					SPDLOG_WARN("Invalid face info file: {}", path);
+					triangle_marknums.clear();
+					return false;
+				}
+				triangle_marknums.push_back(marknum);
+				p = res.ptr;
+			}
+			return true;
+		}
+
+		// 写出二进制的 .facemap 文件，头部记录source_path（生成它的.faceinfo）的大小与修改时间
+		static bool _WriteFaceMapFile(const std::string& path, const std::string& source_path, const std::vector<int>& triangle_marknums) {
+			std::vector<int32_t> runs;
+			for (size_t i = 0; i < triangle_marknums.size(); i++) {
+				if (runs.empty() || runs[runs.size() - 2] != triangle_marknums[i]) {
+					runs.push_back(triangle_marknums[i]);
+					runs.push_back(0);
+				}
+				runs.back()++;
+			}
+
+			std::ofstream out(path, std::ios::binary);
+			if (!out.is_open()) {
+				return false;
+			}
+
+			FaceMapHeader header;
+			header.triangleCount = static_cast<uint32_t>(triangle_marknums.size());
+			header.runCount = static_cast<uint32_t>(runs.size() / 2);
+			_FileStamp(source_path, header.sourceSize, header.sourceTime);
+
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			out.write(reinterpret_cast<const char*>(runs.data()), sizeof(int32_t) * runs.size());
+			return out.good();
+		}
 
-			for (size_t i_solid = 0; i_solid < mesh.num_solids(); i_solid++) {
-				for (size_t j_tri = mesh.solid_tris_begin(i_solid); j_tri < mesh.solid_tris_end(i_solid); j_tri++) {
+		// 加载part的面信息，并把part中的三角形按面markNum重新排序（同一个面内保持原来的顺序），之后每个面占连续的一段
+		// triangle_map见_LoadStlPart，为空时part中的三角形与文件中的一一对应
+		void _LoadStlPartFaces(const std::string& face_file_path, StlSOA& part, const std::vector<unsigned int>& triangle_map) {
+			std::vector<int> triangle_marknums;
+			if (!_ReadFaceFile(face_file_path, triangle_marknums)) {
+				SPDLOG_WARN("Cannot load face file: {}", face_file_path);
+				return;
+			}
 
-					glm::vec3 triangle_points[3];
+			size_t num_tris = part.stlVerticesCount / 3;
+			size_t file_tris = triangle_map.empty() ? num_tris : triangle_map.size();
+			if (triangle_marknums.size() != file_tris) {
+				SPDLOG_WARN("Face file {} has {} triangles but the STL has {}, ignored.", face_file_path, triangle_marknums.size(), file_tris);
+				return;
+			}
 
-					for (int j = 0; j < 3; j++) {
-						triangle_points[j].x = mesh.tri_corner_coords(j_tri, j)[0];
-						triangle_points[j].y = mesh.tri_corner_coords(j_tri, j)[1];
-						triangle_points[j].z = mesh.tri_corner_coords(j_tri, j)[2];
+			// 读取的是文本格式时，在旁边写出（或更新过期的）二进制格式，下次直接读取
+			std::filesystem::path face_map_path = std::filesystem::path(face_file_path).replace_extension(".facemap");
+			if (std::filesystem::path(face_file_path).extension() == ".faceinfo" && !_FaceMapIsCurrent(face_map_path, face_file_path)) {
+				if (_WriteFaceMapFile(face_map_path.string(), face_file_path, triangle_marknums)) {
+					SPDLOG_INFO("Wrote face map file: {}", face_map_path.string());
+				}
+				else {
+					SPDLOG_WARN("Cannot write face map file: {}", face_map_path.string());
+				}
+			}
+
+			// 焊接顶点时stl_reader去掉了退化三角形：面信息（以及上面写出的二进制格式）按文件中的三角形给出，这里换成part中的下标
+			if (file_tris != num_tris) {
+				std::vector<int> kept_marknums(num_tris);
+				for (size_t j_tri = 0; j_tri < file_tris; j_tri++) {
+					if (triangle_map[j_tri] < num_tris) {
+						kept_marknums[triangle_map[j_tri]] = triangle_marknums[j_tri];
 					}
+				}
+				triangle_marknums = std::move(kept_marknums);
+				SPDLOG_INFO("Face file {}: {} degenerated triangles removed by welding.", face_file_path, file_tris - num_tris);
+			}
 
-					glm::vec3 u = triangle_points[2] - triangle_points[0];
-					glm::vec3 v = triangle_points[1] - triangle_points[0];
+			// 每个三角形所属的solid（solid的范围是首尾相接的）
+			std::vector<int> triangle_solids(num_tris, 0);
+			for (size_t j = 0; j < part.stlSolids.size(); j++) {
+				size_t begin = part.stlSolids[j].first / 3;
+				size_t end = begin + part.stlSolids[j].count / 3;
+				std::fill(triangle_solids.begin() + begin, triangle_solids.begin() + end, static_cast<int>(j));
+			}
 
-					glm::vec3 normalized_normal = glm::normalize(glm::cross(v, u));
+			// 每个三角形所属面的编号：同一个 (solid, 面markNum) 连续的一段三角形只查找一次map，面按第一次出现的顺序编号
+			std::map<std::pair<int, int>, uint32_t> face_ids;
+			std::vector<uint32_t> triangle_faces(num_tris);
+			bool sorted = true;
+			for (size_t j_tri = 0; j_tri < num_tris;) {
+				std::pair<int, int> key{ triangle_solids[j_tri], triangle_marknums[j_tri] };
+				uint32_t face_id = face_ids.emplace(key, static_cast<uint32_t>(face_ids.size())).first->second;
+
+				size_t run_end = j_tri + 1;
+				while (run_end < num_tris && triangle_solids[run_end] == key.first && triangle_marknums[run_end] == key.second) {
+					run_end++;
+				}
+				if (run_end < num_tris && triangle_solids[run_end] == key.first && triangle_marknums[run_end] < key.second) {
+					sorted = false;
+				}
 
-					for (int j = 0; j < 3; j++) {
-						stl.stlVertices.emplace_back(triangle_points[j].x);
-						stl.stlVertices.emplace_back(triangle_points[j].y);
-						stl.stlVertices.emplace_back(triangle_points[j].z);
+				std::fill(triangle_faces.begin() + j_tri, triangle_faces.begin() + run_end, face_id);
+				j_tri = run_end;
+			}
 
-						stl.stlVertices.emplace_back(normalized_normal.x);
-						stl.stlVertices.emplace_back(normalized_normal.y);
-						stl.stlVertices.emplace_back(normalized_normal.z);
+			// 按 (solid, 面markNum) 的顺序重新编号，这样排序后solid仍然是连续的
+			std::vector<uint32_t> face_ranks(face_ids.size());
+			uint32_t rank = 0;
+			for (auto& face : face_ids) {
+				face_ranks[face.second] = rank++;
+
+				StlRange range;
+				range.name = "Face " + std::to_string(face.first.second);
+				range.markNum = face.first.second;
+				range.parent = face.first.first;
+				part.stlFaces.push_back(range);
+			}
 
-						newCameraPos.x = std::min(newCameraPos.x, triangle_points[j].x);
-						newCameraPos.y = std::min(newCameraPos.y, triangle_points[j].y);
-						newCameraPos.z = std::min(newCameraPos.z, triangle_points[j].z);
+			// 计数排序：各个面的三角形起始位置
+			std::vector<size_t> face_offsets(face_ids.size() + 1, 0);
+			for (size_t j_tri = 0; j_tri < num_tris; j_tri++) {
+				triangle_faces[j_tri] = face_ranks[triangle_faces[j_tri]];
+				face_offsets[triangle_faces[j_tri] + 1]++;
+			}
+			for (size_t f = 0; f < part.stlFaces.size(); f++) {
+				face_offsets[f + 1] += face_offsets[f];
+				part.stlFaces[f].first = static_cast<int>(face_offsets[f] * 3);
+				part.stlFaces[f].count = static_cast<int>((face_offsets[f + 1] - face_offsets[f]) * 3);
+			}
+
+			std::vector<uint32_t> new_triangle_order(num_tris); // 新位置 -> 原来的三角形下标
+			for (size_t j_tri = 0; j_tri < num_tris; j_tri++) {
+				new_triangle_order[face_offsets[triangle_faces[j_tri]]++] = static_cast<uint32_t>(j_tri);
+			}
+
+			part.stlTriangleToFaceMarkNums.resize(num_tris);
+			for (size_t j_tri = 0; j_tri < num_tris; j_tri++) {
+				part.stlTriangleToFaceMarkNums[j_tri] = triangle_marknums[new_triangle_order[j_tri]];
+			}
 
-						stl.stlVerticesCount++;
+			if (sorted) {
+				return; // 已经按面排好序
+			}
+
+			// 按新的顺序搬运三角形数据：非索引模式每个三角形18个float，索引模式每个三角形3个索引
+			auto permute = [&](auto& data, size_t stride) {
+				auto old_data = data;
+				Utils::ThreadPool::GetInstance().ParallelFor(num_tris, [&](size_t begin, size_t end, size_t chunk_index) {
+					for (size_t j_tri = begin; j_tri < end; j_tri++) {
+						std::copy_n(old_data.begin() + stride * new_triangle_order[j_tri], stride, data.begin() + stride * j_tri);
 					}
+				});
+			};
+
+			if (part.stlTriangleIndices.size() == num_tris * 3) {
+				permute(part.stlTriangleIndices, 3);
+			}
+			if (part.stlVertices.size() == num_tris * 18) {
+				permute(part.stlVertices, 18);
+			}
+		}
+
+		// 根据solid的三角形边界（各solid的起始三角形下标，最后是结束下标，与stl_reader的solids数组相同）设置part的solid范围
+		// 没有solid信息时整个part作为一个solid
+		template <typename T>
+		static void _SetStlPartSolids(StlSOA& part, const T* solid_boundaries, size_t boundaries_count) {
+			part.stlSolids.clear();
+
+			std::vector<size_t> boundaries(solid_boundaries, solid_boundaries + boundaries_count);
+			size_t num_tris = part.stlVerticesCount / 3;
+			if (boundaries.empty() || boundaries.front() != 0) {
+				boundaries.insert(boundaries.begin(), 0);
+			}
+			if (boundaries.back() != num_tris) {
+				boundaries.push_back(num_tris);
+			}
+
+			for (size_t j = 0; j + 1 < boundaries.size(); j++) {
+				StlRange range;
+				range.name = "Solid " + std::to_string(j);
+				range.first = static_cast<int>(boundaries[j] * 3);
+				range.count = static_cast<int>((boundaries[j + 1] - boundaries[j]) * 3);
+				part.stlSolids.push_back(range);
+			}
+		}
+
+		// 二进制STL：文件头80字节 + 三角形数量4字节，之后每个三角形50字节（normal 3个float，3个顶点9个float，2字节属性）
+		// 直接在映射的内存上逐条读取记录，并写入预先分配好大小的stlVertices中，整个过程只扫描文件一遍
+		bool _LoadStlBinaryMapped(const std::string& stl_path, StlSOA& part, glm::vec3& part_min_pos) {
+			const size_t header_size = 84;
+			const size_t record_size = 50;
+
+			Utils::MappedFile file;
+			if (!file.Open(stl_path) || file.Size() < header_size) {
+				return false;
+			}
+
+			uint32_t num_tris = 0;
+			std::memcpy(&num_tris, file.Data() + 80, sizeof(uint32_t));
+
+			if (file.Size() < header_size + record_size * num_tris) {
+				SPDLOG_WARN("Binary STL {} is truncated ({} triangles declared, {} bytes), fallback to stl_reader.", stl_path, num_tris, file.Size());
+				return false;
+			}
+
+			part.stlVertices.resize(static_cast<size_t>(num_tris) * 18);
+
+			const char* records = file.Data() + header_size;
+			float* out = part.stlVertices.data();
+
+			// 每个三角形的输出位置是固定的（第i个三角形写到 18*i 处），因此可以按三角形下标切块并行：
+			// 由GeometryKernels直接读取记录中的坐标，一次算出法向和包围盒
+			GeometryKernels::Bounds bounds = GeometryKernels::ParallelFillTriangles(out, num_tris, [&](size_t j_tri, int j) {
+				// 跳过记录中的法向3个float；记录不保证4字节对齐，内核用memcpy读取
+				return records + record_size * j_tri + 3 * sizeof(float) * (j + 1);
+			});
+			part_min_pos = glm::min(part_min_pos, bounds.min);
+
+			part.stlVerticesCount = static_cast<int>(num_tris) * 3;
+			_SetStlPartSolids<uint32_t>(part, nullptr, 0);
+
+			SPDLOG_INFO("Binary STL {} mapped: {} triangles.", stl_path, num_tris);
+
+			return true;
+		}
+
+		void _LoadStlByStlReader(const std::string& stl_path, StlSOA& part, glm::vec3& part_min_pos, std::vector<unsigned int>* triangle_map) {
+			stl_reader::StlMesh <float, unsigned int> mesh(stl_path, stlLoadOptions.weldTolerance, triangle_map);
+
+			// solid的三角形范围是首尾相接的，覆盖了 [0, num_tris)，因此这里直接按三角形下标展开
+			part.stlVertices.resize(mesh.num_tris() * 18);
+			float* out = part.stlVertices.data();
+
+			GeometryKernels::Bounds bounds = GeometryKernels::ParallelFillTriangles(out, mesh.num_tris(), [&](size_t j_tri, int j) {
+				return mesh.tri_corner_coords(j_tri, j);
+			});
+			part_min_pos = glm::min(part_min_pos, bounds.min);
+
+			part.stlVerticesCount = static_cast<int>(mesh.num_tris()) * 3;
+			_SetStlPartSolids(part, mesh.raw_solids(), mesh.num_solids() > 0 ? mesh.num_solids() + 1 : 0);
+		}
+
+		// 索引模式：直接保留stl_reader去重得到的顶点坐标和三角形索引，不再逐角点展开
+		void _LoadStlIndexed(const std::string& stl_path, StlSOA& part, glm::vec3& part_min_pos, std::vector<unsigned int>* triangle_map) {
+			std::vector<float> normals;
+			std::vector<unsigned int> solids;
+
+			stl_reader::ReadStlFile(stl_path.c_str(), part.stlUniqueCoords, normals, part.stlTriangleIndices, solids, stlLoadOptions.weldTolerance, triangle_map);
+
+			GeometryKernels::Bounds bounds = GeometryKernels::ParallelPointBounds(part.stlUniqueCoords.data(), part.stlUniqueCoords.size() / 3, 3);
+			part_min_pos = glm::min(part_min_pos, bounds.min);
+
+			part.stlVerticesCount = static_cast<int>(part.stlTriangleIndices.size());
+			_SetStlPartSolids(part, solids.data(), solids.size());
+
+			SPDLOG_INFO("Indexed STL {}: {} unique vertices, {} triangles.", stl_path, part.stlUniqueCoords.size() / 3, part.stlTriangleIndices.size() / 3);
+		}
+
+		// 映射文件后用专用解析器（见GeometryJsonFast.hpp）解析，不支持的内容改用SAX流式解析（见GeometryJsonSax.hpp），都不建立DOM
+		// 解析成功后写出二进制缓存，下次有可用的缓存时直接读取缓存
+		// selected_bodies不为空时只保留这些body的记录：解析时其余body的记录整条跳过，读缓存时也不拷贝。缓存总是包含全部body，因此这种情况下不写缓存
+		// lazyEdgeProperties为true时边的参数延迟解码，这种情况下也不写缓存（缓存中的参数都是读取好的，仍然可以直接读取）
+		void LoadGeometryJson(const std::string& json_path, const std::set<int>& selected_bodies = {}) {
+
+			geometryJsonPath = json_path;
+
+			if (useGeometryCache && _LoadGeometryCache(json_path, selected_bodies)) {
+				return;
+			}
+
+			Utils::MappedFile file;
+			if (!file.Open(json_path)) {
+				throw std::runtime_error("Cannot open geometry json: " + json_path);
+			}
+
+			auto start = std::chrono::steady_clock::now();
+
+			// 先用专用解析器，遇到它不处理的结构时整个文件改用nlohmann的SAX解析
+			GeometryJsonFastParser fast_parser;
+			GeometryJsonSaxHandler sax_handler;
+			fast_parser.selectedBodies = selected_bodies;
+			fast_parser.lazyEdgeProperty = lazyEdgeProperties;
+			sax_handler.selectedBodies = selected_bodies;
+			GeometryJsonSaxHandler* result = &fast_parser;
+			const char* parser_name = "fast";
+			if (!useFastGeometryJsonParser || !fast_parser.Parse(file.Data(), file.Data() + file.Size())) {
+				if (useFastGeometryJsonParser) {
+					SPDLOG_INFO("Geometry json {}: unexpected content at byte {}, falling back to nlohmann parser.", json_path, fast_parser.errorOffset);
+					fast_parser = GeometryJsonFastParser(); // 释放已经解析的部分
+					fast_parser.selectedBodies = selected_bodies;
+				}
+				if (!json::sax_parse(file.Data(), file.Data() + file.Size(), &sax_handler)) {
+					throw std::runtime_error("Parse geometry json " + json_path + " failed: " + sax_handler.errorMessage);
 				}
+				result = &sax_handler;
+				parser_name = "nlohmann";
+			}
+			GeometryJsonSaxHandler& handler = *result;
+
+			_LoadBasicStat(handler.basicStatistics);
+
+			brepInfo.vertexInfos = std::move(handler.vertexInfos);
+			brepInfo.edgeInfos = std::move(handler.edgeInfos);
+			brepInfo.edgeGeometries = std::move(handler.edgeGeometries);
+			brepInfo.halfEdgeInfos = std::move(handler.halfEdgeInfos);
+			brepInfo.loopInfos = std::move(handler.loopInfos);
+			brepInfo.faceInfos = std::move(handler.faceInfos);
+
+			if (selected_bodies.empty()) {
+				// 与原来一致：数组长度至少为统计信息中的数量（读取失败的记录保留默认值的占位）
+				_PadInfos(brepInfo.vertexInfos, stats.marknum_vertex);
+				_PadInfos(brepInfo.edgeInfos, stats.marknum_edge);
+				_PadInfos(brepInfo.halfEdgeInfos, stats.marknum_coedge);
+				_PadInfos(brepInfo.loopInfos, stats.marknum_loop);
+				_PadInfos(brepInfo.faceInfos, stats.marknum_face);
+			}
+			else {
+				// 统计信息中的数量是全部body的，不再补占位；读取失败的占位也去掉
+				_FilterBodies(selected_bodies);
 			}
 
-			newCameraPos += glm::vec3{ 20.0f }; // ƫ
+			_IndexInfos();
+			_LinkTopology();
+
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			double mb = file.Size() / (1024.0 * 1024.0);
+			SPDLOG_INFO("Geometry json {} loaded ({} parser, {} threads): {:.1f} MB in {:.3f} s ({:.1f} MB/s), peak RSS {:.1f} MB.",
+				json_path, parser_name, Utils::ThreadPool::GetInstance().ThreadCount(), mb, seconds, mb / std::max(seconds, 1e-9),
+				Utils::PeakRssBytes() / (1024.0 * 1024.0));
+			SPDLOG_INFO("{} vertices ({} failed), {} edges ({} failed, geometry {:.1f} MB), {} half edges ({} failed), {} loops ({} failed), {} faces ({} failed).",
+				brepInfo.vertexInfos.size(), handler.vertexFailures.failedRecords, brepInfo.edgeInfos.size(), handler.edgeFailures.failedRecords,
+				brepInfo.edgeGeometries.MemoryBytes() / (1024.0 * 1024.0),
+				brepInfo.halfEdgeInfos.size(), handler.halfEdgeFailures.failedRecords, brepInfo.loopInfos.size(), handler.loopFailures.failedRecords,
+				brepInfo.faceInfos.size(), handler.faceFailures.failedRecords);
+			handler.vertexFailures.Log("Vertices", brepInfo.vertexInfos.size());
+			handler.edgeFailures.Log("Edges", brepInfo.edgeInfos.size());
+			handler.halfEdgeFailures.Log("HalfEdges", brepInfo.halfEdgeInfos.size());
+			handler.loopFailures.Log("Loops", brepInfo.loopInfos.size());
+			handler.faceFailures.Log("Faces", brepInfo.faceInfos.size());
+			if (!selected_bodies.empty()) {
+				SPDLOG_INFO("Selected {} bodies, {} records of other bodies skipped.", selected_bodies.size(), handler.skippedRecordCount);
+			}
+			bool lazy = !brepInfo.edgeGeometries.recordOffsets.empty();
+			if (lazy) {
+				SPDLOG_INFO("Edge properties are decoded on demand.");
+			}
 
-			// TODO: ÿǶӦĸ
-			if (stl_triangle_marknum_file_path != "") {
-				try {
-					// TODO
+			if (useGeometryCache && selected_bodies.empty() && !lazy) {
+				std::string cache_path = GeometryCachePath(json_path);
+				if (_WriteGeometryCache(cache_path, file.Size(), FileMtime(json_path), HashBytes(file.Data(), file.Size()))) {
+					SPDLOG_INFO("Geometry cache written: {}", cache_path);
 				}
-				catch (std::exception& e) {
-					stl.stlTriangleToFaceMarkNums.clear();
+				else {
+					SPDLOG_WARN("Cannot write geometry cache: {}", cache_path);
 				}
 			}
 		}
 
-		// TODO: selected_body룿ǿܺҪĻֻȾ
-		void LoadGeometryJson(const std::string& json_path, int selected_body = -1) {
+		// 延迟解码：保证边几何第row行的参数已经读取（从geometryJsonPath中重新解析这条边的记录），读取失败时返回false
+		bool DecodeEdgeGeometry(int row) {
+			EdgeGeometryTable& geometries = brepInfo.edgeGeometries;
+			if (row < 0 || geometries.ParamsFailed(row)) {
+				return false;
+			}
+			if (!geometries.ParamsPending(row)) {
+				return true;
+			}
+
+			std::string record(geometries.recordSizes[row], '\0');
+			std::ifstream in(geometryJsonPath, std::ios::binary);
+			in.seekg(static_cast<std::streamoff>(geometries.recordOffsets[row]));
+			in.read(record.data(), record.size());
+
+			// 文件在加载之后被修改时，记录的范围已经不对，曲线类型或者采样点数不一致时也认为失败
+			GeometryJsonFastParser parser;
+			bool ok = in && parser.ParseEdgeRecord(record.data(), record.data() + record.size())
+				&& parser.edgeGeometries.curveTypes[0] == geometries.curveTypes[row]
+				&& parser.edgeGeometries.PointCount(0) == geometries.PointCount(row);
+			if (!ok) {
+				SPDLOG_WARN("Decode edge geometry {} from {} failed.", row, geometryJsonPath);
+				geometries.paramIndices[row] = EdgeGeometryTable::PARAMS_FAILED;
+				return false;
+			}
+
+			geometries.SetParams(row, parser.edgeGeometries);
+			return true;
+		}
+
+		// 从缓存加载统计信息和各拓扑记录（selected_bodies不为空时只拷贝这些body的记录）。缓存不存在或者与json不匹配时返回false
+		bool _LoadGeometryCache(const std::string& json_path, const std::set<int>& selected_bodies = {}) {
+			auto start = std::chrono::steady_clock::now();
+
+			Utils::MappedFile cache_file;
+			const GeometryCacheHeader* header = nullptr;
+			bool mtime_changed = false;
+			if (!OpenGeometryCache(json_path, cache_file, header, mtime_changed)) {
+				return false;
+			}
+
+			const char* base = cache_file.Data();
+			const GeometryCacheSectionInfo* sections = header->sections;
+
+			auto section_data = [&](GeometryCacheSection section) {
+				return base + sections[section].offset;
+			};
+			auto in_section = [&](GeometryCacheSection section, uint64_t begin, uint64_t count) {
+				return begin <= sections[section].count && count <= sections[section].count - begin;
+			};
+			auto broken = [&]() {
+				SPDLOG_WARN("Geometry cache of {} is broken, ignored.", json_path);
+				return false;
+			};
+
+			// 字符串表
+			if (sections[GEOMETRY_CACHE_STRING_OFFSETS].count == 0) {
+				return broken();
+			}
+			const uint32_t* string_offsets = reinterpret_cast<const uint32_t*>(section_data(GEOMETRY_CACHE_STRING_OFFSETS));
+			const char* string_chars = section_data(GEOMETRY_CACHE_STRING_CHARS);
+			std::vector<std::string> strings;
+			for (uint64_t i = 0; i + 1 < sections[GEOMETRY_CACHE_STRING_OFFSETS].count; i++) {
+				uint32_t begin = string_offsets[i];
+				uint32_t end = string_offsets[i + 1];
+				if (begin > end || end > sections[GEOMETRY_CACHE_STRING_CHARS].count) {
+					return broken();
+				}
+				strings.emplace_back(string_chars + begin, string_chars + end);
+			}
+			auto string_ok = [&](int32_t index) {
+				return index < static_cast<int64_t>(strings.size());
+			};
+
+			const GeometryCacheVertex* vertices = reinterpret_cast<const GeometryCacheVertex*>(section_data(GEOMETRY_CACHE_VERTICES));
+			const GeometryCacheEdge* edges = reinterpret_cast<const GeometryCacheEdge*>(section_data(GEOMETRY_CACHE_EDGES));
+			const GeometryCacheHalfEdge* half_edges = reinterpret_cast<const GeometryCacheHalfEdge*>(section_data(GEOMETRY_CACHE_HALF_EDGES));
+			const GeometryCacheLoop* loops = reinterpret_cast<const GeometryCacheLoop*>(section_data(GEOMETRY_CACHE_LOOPS));
+			const GeometryCacheFace* faces = reinterpret_cast<const GeometryCacheFace*>(section_data(GEOMETRY_CACHE_FACES));
+			const glm::vec3* points = reinterpret_cast<const glm::vec3*>(section_data(GEOMETRY_CACHE_POINTS));
+			const glm::vec2* uv_points = reinterpret_cast<const glm::vec2*>(section_data(GEOMETRY_CACHE_UV_POINTS));
+			const int32_t* ints = reinterpret_cast<const int32_t*>(section_data(GEOMETRY_CACHE_INTS));
+			const double* doubles = reinterpret_cast<const double*>(section_data(GEOMETRY_CACHE_DOUBLES));
+
+			// 先检查所有引用都在范围内，之后填充时不再检查
+			for (uint64_t i = 0; i < sections[GEOMETRY_CACHE_EDGES].count; i++) {
+				const GeometryCacheEdge& e = edges[i];
+				if (!string_ok(e.curveType) || !in_section(GEOMETRY_CACHE_POINTS, e.pointBegin, e.pointCount) || !in_section(GEOMETRY_CACHE_POINTS, e.ctrlptBegin, e.ctrlptCount)) {
+					return broken();
+				}
+			}
+			for (uint64_t i = 0; i < sections[GEOMETRY_CACHE_HALF_EDGES].count; i++) {
+				const GeometryCacheHalfEdge& h = half_edges[i];
+				if (!string_ok(h.curveType) || !in_section(GEOMETRY_CACHE_UV_POINTS, h.ctrlptBegin, h.ctrlptCount) || !in_section(GEOMETRY_CACHE_DOUBLES, h.knotBegin, h.knotCount)) {
+					return broken();
+				}
+			}
+			for (uint64_t i = 0; i < sections[GEOMETRY_CACHE_LOOPS].count; i++) {
+				if (!in_section(GEOMETRY_CACHE_INTS, loops[i].halfEdgeBegin, loops[i].halfEdgeCount)) {
+					return broken();
+				}
+			}
+			for (uint64_t i = 0; i < sections[GEOMETRY_CACHE_FACES].count; i++) {
+				const GeometryCacheFace& f = faces[i];
+				if (!string_ok(f.faceType) || !in_section(GEOMETRY_CACHE_POINTS, f.ctrlptBegin, f.ctrlptCount) || !in_section(GEOMETRY_CACHE_DOUBLES, f.knotUBegin, f.knotUCount)
+					|| !in_section(GEOMETRY_CACHE_DOUBLES, f.knotVBegin, f.knotVCount) || !in_section(GEOMETRY_CACHE_DOUBLES, f.weightBegin, f.weightCount)) {
+					return broken();
+				}
+			}
+
+			int* stat_fields[9] = { &stats.marknum_body, &stats.marknum_coedge, &stats.marknum_edge, &stats.marknum_face, &stats.marknum_loop,
+				&stats.marknum_lump, &stats.marknum_shell, &stats.marknum_vertex, &stats.marknum_wire };
+			for (int i = 0; i < 9; i++) {
+				*stat_fields[i] = header->basicStat[i];
+			}
+
+			// 选中的记录在缓存中的下标，没有筛选时为全部记录
+			auto selected_rows = [&](const auto* records, GeometryCacheSection section) {
+				std::vector<uint32_t> rows;
+				rows.reserve(sections[section].count);
+				for (uint64_t i = 0; i < sections[section].count; i++) {
+					if (selected_bodies.empty() || selected_bodies.count(records[i].bodyId) > 0) {
+						rows.push_back(static_cast<uint32_t>(i));
+					}
+				}
+				return rows;
+			};
+
+			std::vector<uint32_t> vertex_rows = selected_rows(vertices, GEOMETRY_CACHE_VERTICES);
+			brepInfo.vertexInfos.clear();
+			brepInfo.vertexInfos.resize(vertex_rows.size());
+			for (size_t i = 0; i < brepInfo.vertexInfos.size(); i++) {
+				const GeometryCacheVertex& v = vertices[vertex_rows[i]];
+				VertexInfo& info = brepInfo.vertexInfos[i];
+				info.markNum = v.markNum;
+				info.bodyId = v.bodyId;
+				info.pos = glm::vec3{ v.pos[0], v.pos[1], v.pos[2] };
+			}
+
+			// 边的几何按边的顺序逐行加入，每行只是几段连续内存的拷贝
+			std::vector<uint32_t> edge_rows = selected_rows(edges, GEOMETRY_CACHE_EDGES);
+			size_t edge_point_count = 0;
+			for (uint32_t row : edge_rows) {
+				edge_point_count += edges[row].pointCount;
+			}
+
+			brepInfo.edgeInfos.clear();
+			brepInfo.edgeInfos.resize(edge_rows.size());
+			EdgeGeometryTable& geometries = brepInfo.edgeGeometries;
+			geometries.Clear();
+			geometries.curveTypes.reserve(brepInfo.edgeInfos.size());
+			geometries.paramIndices.reserve(brepInfo.edgeInfos.size());
+			geometries.pointOffsets.reserve(brepInfo.edgeInfos.size() + 1);
+			geometries.sampledPoints.reserve(edge_point_count);
+
+			for (size_t i = 0; i < brepInfo.edgeInfos.size(); i++) {
+				const GeometryCacheEdge& e = edges[edge_rows[i]];
+				EdgeInfo& info = brepInfo.edgeInfos[i];
+
+				info.markNum = e.markNum;
+				info.bodyId = e.bodyId;
+				info.nonmanifoldCount = e.nonmanifoldCount;
+				info.stMarkNum = e.stMarkNum;
+				info.edMarkNum = e.edMarkNum;
+				info.pos = glm::vec3{ e.pos[0], e.pos[1], e.pos[2] };
+
+				if (e.curveType < 0) {
+					continue; // 读取失败的记录
+				}
+
+				const std::string& curve_type_name = strings[e.curveType];
+				CurveType curve_type = CurveTypeFromName(curve_type_name);
+				const float* g = e.geometry;
+
+				int param_index;
+				if (curve_type == CurveType::STRAIGHT) {
+					StraightCurveParams params;
+					params.rootPoint = glm::vec3{ g[0], g[1], g[2] };
+					params.direction = glm::vec3{ g[3], g[4], g[5] };
+					geometries.straights.push_back(params);
+					param_index = static_cast<int>(geometries.straights.size()) - 1;
+				}
+				else if (curve_type == CurveType::INTCURVE) {
+					geometries.intcurveCtrlpts.insert(geometries.intcurveCtrlpts.end(), points + e.ctrlptBegin, points + e.ctrlptBegin + e.ctrlptCount);
+					param_index = geometries.AddIntcurveCtrlpts();
+				}
+				else if (curve_type == CurveType::ELLIPSE) {
+					EllipseCurveParams params;
+					params.centre = glm::vec3{ g[0], g[1], g[2] };
+					params.normal = glm::vec3{ g[3], g[4], g[5] };
+					params.majorAxis = glm::vec3{ g[6], g[7], g[8] };
+					params.majorAxisLength = e.majorAxisLength;
+					params.minorAxisLength = e.minorAxisLength;
+					geometries.ellipses.push_back(params);
+					param_index = static_cast<int>(geometries.ellipses.size()) - 1;
+				}
+				else {
+					param_index = geometries.AddOtherCurveType(curve_type_name);
+				}
+
+				geometries.sampledPoints.insert(geometries.sampledPoints.end(), points + e.pointBegin, points + e.pointBegin + e.pointCount);
+				info.geometryIndex = geometries.AddRow(curve_type, param_index);
+			}
+
+			// 其余记录的点、节点等各自是独立的一段拷贝，可以并行
+			auto& pool = Utils::ThreadPool::GetInstance();
+
+			std::vector<uint32_t> half_edge_rows = selected_rows(half_edges, GEOMETRY_CACHE_HALF_EDGES);
+			brepInfo.halfEdgeInfos.clear();
+			brepInfo.halfEdgeInfos.resize(half_edge_rows.size());
+			pool.ParallelFor(brepInfo.halfEdgeInfos.size(), [&](size_t begin, size_t end, size_t chunk_index) {
+				for (size_t i = begin; i < end; i++) {
+					const GeometryCacheHalfEdge& h = half_edges[half_edge_rows[i]];
+					HalfEdgeInfo& info = brepInfo.halfEdgeInfos[i];
+
+					info.markNum = h.markNum;
+					info.bodyId = h.bodyId;
+					info.edgeMarkNum = h.edgeMarkNum;
+					info.loopMarkNum = h.loopMarkNum;
+					info.sense = h.sense != 0;
+					info.partnerMarkNum = -1;
+					info.preMarkNum = -1;
+					info.nextMarkNum = -1;
+
+					if (h.curveType < 0) {
+						continue;
+					}
+
+					const std::string& curve_type = strings[h.curveType];
+					std::unique_ptr<HalfEdgeGeometry> geometry_ptr;
+					if (curve_type == "pcurve") {
+						auto pcurve = std::make_unique<PcurveHalfEdgeGeometry>();
+						pcurve->curveDegree = h.curveDegree;
+						pcurve->ctrlpts.assign(uv_points + h.ctrlptBegin, uv_points + h.ctrlptBegin + h.ctrlptCount);
+						pcurve->knots.assign(doubles + h.knotBegin, doubles + h.knotBegin + h.knotCount);
+						geometry_ptr = std::move(pcurve);
+					}
+					else {
+						geometry_ptr = std::make_unique<HalfEdgeGeometry>();
+					}
+
+					geometry_ptr->curveType = curve_type;
+					info.halfEdgeGeometry = std::move(geometry_ptr);
+				}
+			}, 1024);
+
+			std::vector<uint32_t> loop_rows = selected_rows(loops, GEOMETRY_CACHE_LOOPS);
+			brepInfo.loopInfos.clear();
+			brepInfo.loopInfos.resize(loop_rows.size());
+			for (size_t i = 0; i < brepInfo.loopInfos.size(); i++) {
+				const GeometryCacheLoop& l = loops[loop_rows[i]];
+				LoopInfo& info = brepInfo.loopInfos[i];
+				info.markNum = l.markNum;
+				info.bodyId = l.bodyId;
+				info.faceMarkNum = l.faceMarkNum;
+				info.halfEdgesMarkNums.assign(ints + l.halfEdgeBegin, ints + l.halfEdgeBegin + l.halfEdgeCount);
+			}
+
+			std::vector<uint32_t> face_rows = selected_rows(faces, GEOMETRY_CACHE_FACES);
+			brepInfo.faceInfos.clear();
+			brepInfo.faceInfos.resize(face_rows.size());
+			pool.ParallelFor(brepInfo.faceInfos.size(), [&](size_t begin, size_t end, size_t chunk_index) {
+				for (size_t i = begin; i < end; i++) {
+					const GeometryCacheFace& f = faces[face_rows[i]];
+					FaceInfo& info = brepInfo.faceInfos[i];
+
+					info.markNum = f.markNum;
+					info.bodyId = f.bodyId;
+					info.stLoopMarkNum = f.stLoopMarkNum;
+
+					if (f.faceType < 0) {
+						continue;
+					}
+
+					const std::string& face_type = strings[f.faceType];
+					const float* v = f.vectors;
+
+					std::unique_ptr<FaceGeometry> geometry_ptr;
+					if (face_type == "plane") {
+						auto plane = std::make_unique<PlaneFaceGeometry>();
+						plane->rootPoint = glm::vec3{ v[0], v[1], v[2] };
+						plane->normal = glm::vec3{ v[3], v[4], v[5] };
+						geometry_ptr = std::move(plane);
+					}
+					else if (face_type == "sphere") {
+						auto sphere = std::make_unique<SphereFaceGeometry>();
+						sphere->centre = glm::vec3{ v[0], v[1], v[2] };
+						sphere->radius = f.values[0];
+						geometry_ptr = std::move(sphere);
+					}
+					else if (face_type == "torus") {
+						auto torus = std::make_unique<TorusFaceGeometry>();
+						torus->centre = glm::vec3{ v[0], v[1], v[2] };
+						torus->normal = glm::vec3{ v[3], v[4], v[5] };
+						torus->minorRadius = f.values[0];
+						torus->majorRadius = f.values[1];
+						geometry_ptr = std::move(torus);
+					}
+					else if (face_type == "cone") {
+						auto cone = std::make_unique<ConeFaceGeometry>();
+						cone->rootPoint = glm::vec3{ v[0], v[1], v[2] };
+						cone->majorAxis = glm::vec3{ v[3], v[4], v[5] };
+						cone->direction = glm::vec3{ v[6], v[7], v[8] };
+						cone->ratio = f.values[0];
+						cone->cos = f.values[1];
+						cone->sin = f.values[2];
+						cone->angle = f.values[3];
+						geometry_ptr = std::move(cone);
+					}
+					else if (face_type == "spline") {
+						auto spline = std::make_unique<SplineFaceGeometry>();
+						spline->degreeU = f.ints[0];
+						spline->degreeV = f.ints[1];
+						spline->numU = f.ints[2];
+						spline->numV = f.ints[3];
+						spline->numKnotsU = f.ints[4];
+						spline->numKnotsV = f.ints[5];
+						spline->numWeightU = f.ints[6];
+						spline->numWeightV = f.ints[7];
+						spline->ctrlpts.assign(points + f.ctrlptBegin, points + f.ctrlptBegin + f.ctrlptCount);
+						spline->uknots.assign(doubles + f.knotUBegin, doubles + f.knotUBegin + f.knotUCount);
+						spline->vknots.assign(doubles + f.knotVBegin, doubles + f.knotVBegin + f.knotVCount);
+						spline->weights.assign(doubles + f.weightBegin, doubles + f.weightBegin + f.weightCount);
+						geometry_ptr = std::move(spline);
+					}
+					else {
+						geometry_ptr = std::make_unique<FaceGeometry>();
+					}
+
+					geometry_ptr->faceType = face_type;
+					info.faceGeometry = std::move(geometry_ptr);
+				}
+			}, 1024);
+
+			_IndexInfos();
+			_LinkTopology();
+
+			size_t cache_size = cache_file.Size();
+			cache_file.Close();
+
+			// 内容相同但修改时间变了：更新缓存中记录的修改时间，下次不必再计算哈希
+			if (mtime_changed) {
+				std::fstream f(GeometryCachePath(json_path), std::ios::binary | std::ios::in | std::ios::out);
+				int64_t mtime = FileMtime(json_path);
+				f.seekp(offsetof(GeometryCacheHeader, sourceMtime));
+				f.write(reinterpret_cast<const char*>(&mtime), sizeof(mtime));
+			}
+
+			double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			SPDLOG_INFO("Geometry cache of {} loaded in {:.1f} ms ({:.1f} MB): {} vertices, {} edges, {} half edges, {} loops, {} faces.",
+				json_path, ms, cache_size / (1024.0 * 1024.0), brepInfo.vertexInfos.size(), brepInfo.edgeInfos.size(),
+				brepInfo.halfEdgeInfos.size(), brepInfo.loopInfos.size(), brepInfo.faceInfos.size());
+			return true;
+		}
+
+		// 写出缓存：记录先按段在内存中排好（点、节点等汇总到共享的数组），写到临时文件，完成后再替换，避免留下写了一半的缓存
+		bool _WriteGeometryCache(const std::string& cache_path, uint64_t source_size, int64_t source_mtime, uint64_t source_hash) {
+			static_assert(sizeof(glm::vec3) == 3 * sizeof(float) && sizeof(glm::vec2) == 2 * sizeof(float), "glm vectors must be tightly packed");
+
+			std::vector<GeometryCacheVertex> vertices;
+			std::vector<GeometryCacheEdge> edges;
+			std::vector<GeometryCacheHalfEdge> half_edges;
+			std::vector<GeometryCacheLoop> loops;
+			std::vector<GeometryCacheFace> faces;
+			std::vector<glm::vec3> points;
+			std::vector<glm::vec2> uv_points;
+			std::vector<int32_t> ints;
+			std::vector<double> doubles;
+
+			std::vector<uint32_t> string_offsets{ 0 };
+			std::string string_chars;
+			std::map<std::string, int32_t> string_indices;
+			auto string_index = [&](const std::string& str) {
+				auto it = string_indices.find(str);
+				if (it == string_indices.end()) {
+					it = string_indices.emplace(str, static_cast<int32_t>(string_indices.size())).first;
+					string_chars += str;
+					string_offsets.push_back(static_cast<uint32_t>(string_chars.size()));
+				}
+				return it->second;
+			};
+
+			auto append_points = [&](const std::vector<glm::vec3>& src, uint64_t& begin, uint32_t& count) {
+				begin = points.size();
+				count = static_cast<uint32_t>(src.size());
+				points.insert(points.end(), src.begin(), src.end());
+			};
+			auto append_doubles = [&](const std::vector<double>& src, uint64_t& begin, uint32_t& count) {
+				begin = doubles.size();
+				count = static_cast<uint32_t>(src.size());
+				doubles.insert(doubles.end(), src.begin(), src.end());
+			};
+			auto copy_vec3 = [](float* dst, const glm::vec3& v) {
+				std::memcpy(dst, &v, sizeof(glm::vec3));
+			};
+
+			for (auto& info : brepInfo.vertexInfos) {
+				GeometryCacheVertex v{};
+				v.markNum = info.markNum;
+				v.bodyId = info.bodyId;
+				copy_vec3(v.pos, info.pos);
+				vertices.push_back(v);
+			}
+
+			for (auto& info : brepInfo.edgeInfos) {
+				GeometryCacheEdge e{};
+				e.markNum = info.markNum;
+				e.bodyId = info.bodyId;
+				e.nonmanifoldCount = info.nonmanifoldCount;
+				e.stMarkNum = info.stMarkNum;
+				e.edMarkNum = info.edMarkNum;
+				copy_vec3(e.pos, info.pos);
+				e.curveType = -1;
+
+				const EdgeGeometryTable& geometries = brepInfo.edgeGeometries;
+				int row = info.geometryIndex;
+				if (row >= 0) {
+					e.curveType = string_index(geometries.CurveTypeName(row));
+
+					CurveType curve_type = geometries.curveTypes[row];
+					if (curve_type == CurveType::STRAIGHT) {
+						copy_vec3(e.geometry + 0, geometries.Straight(row).rootPoint);
+						copy_vec3(e.geometry + 3, geometries.Straight(row).direction);
+					}
+					else if (curve_type == CurveType::INTCURVE) {
+						e.ctrlptBegin = points.size();
+						e.ctrlptCount = static_cast<uint32_t>(geometries.IntcurveCtrlptCount(row));
+						points.insert(points.end(), geometries.IntcurveCtrlpts(row), geometries.IntcurveCtrlpts(row) + e.ctrlptCount);
+					}
+					else if (curve_type == CurveType::ELLIPSE) {
+						const EllipseCurveParams& ellipse = geometries.Ellipse(row);
+						copy_vec3(e.geometry + 0, ellipse.centre);
+						copy_vec3(e.geometry + 3, ellipse.normal);
+						copy_vec3(e.geometry + 6, ellipse.majorAxis);
+						e.majorAxisLength = ellipse.majorAxisLength;
+						e.minorAxisLength = ellipse.minorAxisLength;
+					}
+
+					e.pointBegin = points.size();
+					e.pointCount = static_cast<uint32_t>(geometries.PointCount(row));
+					points.insert(points.end(), geometries.Points(row), geometries.Points(row) + e.pointCount);
+				}
+
+				edges.push_back(e);
+			}
+
+			for (auto& info : brepInfo.halfEdgeInfos) {
+				GeometryCacheHalfEdge h{};
+				h.markNum = info.markNum;
+				h.bodyId = info.bodyId;
+				h.edgeMarkNum = info.edgeMarkNum;
+				h.loopMarkNum = info.loopMarkNum;
+				h.sense = info.sense ? 1 : 0;
+				h.curveType = -1;
+
+				HalfEdgeGeometry* geometry = info.halfEdgeGeometry.get();
+				if (geometry != nullptr) {
+					h.curveType = string_index(geometry->curveType);
+
+					if (geometry->curveType == "pcurve") {
+						auto* pcurve = static_cast<PcurveHalfEdgeGeometry*>(geometry);
+						h.curveDegree = pcurve->curveDegree;
+						h.ctrlptBegin = uv_points.size();
+						h.ctrlptCount = static_cast<uint32_t>(pcurve->ctrlpts.size());
+						uv_points.insert(uv_points.end(), pcurve->ctrlpts.begin(), pcurve->ctrlpts.end());
+						append_doubles(pcurve->knots, h.knotBegin, h.knotCount);
+					}
+				}
+
+				half_edges.push_back(h);
+			}
+
+			for (auto& info : brepInfo.loopInfos) {
+				GeometryCacheLoop l{};
+				l.markNum = info.markNum;
+				l.bodyId = info.bodyId;
+				l.faceMarkNum = info.faceMarkNum;
+				l.halfEdgeBegin = ints.size();
+				l.halfEdgeCount = static_cast<uint32_t>(info.halfEdgesMarkNums.size());
+				ints.insert(ints.end(), info.halfEdgesMarkNums.begin(), info.halfEdgesMarkNums.end());
+				loops.push_back(l);
+			}
+
+			for (auto& info : brepInfo.faceInfos) {
+				GeometryCacheFace f{};
+				f.markNum = info.markNum;
+				f.bodyId = info.bodyId;
+				f.stLoopMarkNum = info.stLoopMarkNum;
+				f.faceType = -1;
+
+				FaceGeometry* geometry = info.faceGeometry.get();
+				if (geometry != nullptr) {
+					f.faceType = string_index(geometry->faceType);
+
+					if (geometry->faceType == "plane") {
+						auto* plane = static_cast<PlaneFaceGeometry*>(geometry);
+						copy_vec3(f.vectors + 0, plane->rootPoint);
+						copy_vec3(f.vectors + 3, plane->normal);
+					}
+					else if (geometry->faceType == "sphere") {
+						auto* sphere = static_cast<SphereFaceGeometry*>(geometry);
+						copy_vec3(f.vectors + 0, sphere->centre);
+						f.values[0] = sphere->radius;
+					}
+					else if (geometry->faceType == "torus") {
+						auto* torus = static_cast<TorusFaceGeometry*>(geometry);
+						copy_vec3(f.vectors + 0, torus->centre);
+						copy_vec3(f.vectors + 3, torus->normal);
+						f.values[0] = torus->minorRadius;
+						f.values[1] = torus->majorRadius;
+					}
+					else if (geometry->faceType == "cone") {
+						auto* cone = static_cast<ConeFaceGeometry*>(geometry);
+						copy_vec3(f.vectors + 0, cone->rootPoint);
+						copy_vec3(f.vectors + 3, cone->majorAxis);
+						copy_vec3(f.vectors + 6, cone->direction);
+						f.values[0] = cone->ratio;
+						f.values[1] = cone->cos;
+						f.values[2] = cone->sin;
+						f.values[3] = cone->angle;
+					}
+					else if (geometry->faceType == "spline") {
+						auto* spline = static_cast<SplineFaceGeometry*>(geometry);
+						int32_t spline_ints[8] = { spline->degreeU, spline->degreeV, spline->numU, spline->numV,
+							spline->numKnotsU, spline->numKnotsV, spline->numWeightU, spline->numWeightV };
+						std::copy(spline_ints, spline_ints + 8, f.ints);
+						append_points(spline->ctrlpts, f.ctrlptBegin, f.ctrlptCount);
+						append_doubles(spline->uknots, f.knotUBegin, f.knotUCount);
+						append_doubles(spline->vknots, f.knotVBegin, f.knotVCount);
+						append_doubles(spline->weights, f.weightBegin, f.weightCount);
+					}
+				}
+
+				faces.push_back(f);
+			}
+
+			std::string tmp_path = cache_path + ".tmp";
+			std::ofstream out(tmp_path, std::ios::binary);
+			if (!out.is_open()) {
+				return false;
+			}
+
+			GeometryCacheHeader header{};
+			header.magic = GEOMETRY_CACHE_MAGIC;
+			header.version = GEOMETRY_CACHE_VERSION;
+			header.sourceSize = source_size;
+			header.sourceMtime = source_mtime;
+			header.sourceHash = source_hash;
+
+			const int stat_values[9] = { stats.marknum_body, stats.marknum_coedge, stats.marknum_edge, stats.marknum_face, stats.marknum_loop,
+				stats.marknum_lump, stats.marknum_shell, stats.marknum_vertex, stats.marknum_wire };
+			std::copy(stat_values, stat_values + 9, header.basicStat);
+
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header)); // 占位，最后重写
+			size_t offset = sizeof(GeometryCacheHeader);
+
+			auto write_section = [&](GeometryCacheSection section, const void* data, size_t count) {
+				size_t aligned = AlignCacheOffset(offset);
+				const char zeros[8] = {};
+				out.write(zeros, aligned - offset);
+				offset = aligned;
+
+				header.sections[section].offset = offset;
+				header.sections[section].count = count;
+
+				size_t bytes = count * GEOMETRY_CACHE_ELEMENT_SIZES[section];
+				out.write(static_cast<const char*>(data), bytes);
+				offset += bytes;
+			};
+
+			write_section(GEOMETRY_CACHE_VERTICES, vertices.data(), vertices.size());
+			write_section(GEOMETRY_CACHE_EDGES, edges.data(), edges.size());
+			write_section(GEOMETRY_CACHE_HALF_EDGES, half_edges.data(), half_edges.size());
+			write_section(GEOMETRY_CACHE_LOOPS, loops.data(), loops.size());
+			write_section(GEOMETRY_CACHE_FACES, faces.data(), faces.size());
+			write_section(GEOMETRY_CACHE_POINTS, points.data(), points.size());
+			write_section(GEOMETRY_CACHE_UV_POINTS, uv_points.data(), uv_points.size());
+			write_section(GEOMETRY_CACHE_INTS, ints.data(), ints.size());
+			write_section(GEOMETRY_CACHE_DOUBLES, doubles.data(), doubles.size());
+			write_section(GEOMETRY_CACHE_STRING_OFFSETS, string_offsets.data(), string_offsets.size());
+			write_section(GEOMETRY_CACHE_STRING_CHARS, string_chars.data(), string_chars.size());
+
+			header.fileSize = AlignCacheOffset(offset);
+			const char zeros[8] = {};
+			out.write(zeros, header.fileSize - offset);
+
+			out.seekp(0);
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			out.close();
+			if (!out) {
+				std::error_code ec;
+				std::filesystem::remove(tmp_path, ec);
+				return false;
+			}
+
+			std::error_code ec;
+			std::filesystem::remove(cache_path, ec); // Windows下rename不会覆盖已有文件
+			std::filesystem::rename(tmp_path, cache_path, ec);
+			return !ec;
+		}
+
+		// 原来的加载方式：整个文件解析为nlohmann的DOM后逐个子树读取。峰值内存是文件大小的数倍，仅用于性能对比
+		// selected_bodies不为空时，读完后再去掉其余body的记录
+		void LoadGeometryJsonDom(const std::string& json_path, const std::set<int>& selected_bodies = {}) {
 
 			std::ifstream f(json_path);
 			json data = json::parse(f);
@@ -130,196 +1379,506 @@ namespace Info {
 			_LoadLoopInfos(data);
 			_LoadFaceInfos(data);
 
-			_SortInfos(brepInfo.vertexInfos);
-			_SortInfos(brepInfo.edgeInfos);
-			_SortInfos(brepInfo.halfEdgeInfos);
-			_SortInfos(brepInfo.loopInfos);
-			_SortInfos(brepInfo.faceInfos);
+			if (!selected_bodies.empty()) {
+				_FilterBodies(selected_bodies);
+			}
+
+			_IndexInfos();
+			_LinkTopology();
 		}
 
 
+		// DOM中的统计信息：转成与SAX解析相同的形式，缺少的字段同样记为0
 		void _LoadBasicStat(const json& data) {
+			std::map<std::string, int> basic_statistics;
+			auto it = data.find("basic_statistics");
+			if (it != data.end() && it->is_object()) {
+				for (auto& [key, value] : it->items()) {
+					if (value.is_number()) {
+						basic_statistics[key] = value.get<int>();
+					}
+				}
+			}
+			_LoadBasicStat(basic_statistics);
+		}
 
-			auto root_basic_statistics = data["basic_statistics"];
-
-			stats.marknum_body = root_basic_statistics["marknum_body"];
-			stats.marknum_coedge = root_basic_statistics["marknum_coedge"];
-			stats.marknum_edge = root_basic_statistics["marknum_edge"];
-			stats.marknum_face = root_basic_statistics["marknum_face"];
-			stats.marknum_loop = root_basic_statistics["marknum_loop"];
-			stats.marknum_lump = root_basic_statistics["marknum_lump"];
-			stats.marknum_shell = root_basic_statistics["marknum_shell"];
-			stats.marknum_vertex = root_basic_statistics["marknum_vertex"];
-			stats.marknum_wire = root_basic_statistics["marknum_wire"];
+		// SAX解析得到的统计信息：缺少的字段记为0（较早导出的文件没有basic_statistics）
+		void _LoadBasicStat(const std::map<std::string, int>& basic_statistics) {
+			if (basic_statistics.empty()) {
+				SPDLOG_WARN("basic_statistics is missing, all counts are set to 0");
+			}
 
+			auto get = [&](const char* name) {
+				auto it = basic_statistics.find(name);
+				if (it == basic_statistics.end()) {
+					if (!basic_statistics.empty()) {
+						SPDLOG_WARN("basic_statistics.{} is missing", name);
+					}
+					return 0;
+				}
+				return it->second;
+			};
+
+			stats.marknum_body = get("marknum_body");
+			stats.marknum_coedge = get("marknum_coedge");
+			stats.marknum_edge = get("marknum_edge");
+			stats.marknum_face = get("marknum_face");
+			stats.marknum_loop = get("marknum_loop");
+			stats.marknum_lump = get("marknum_lump");
+			stats.marknum_shell = get("marknum_shell");
+			stats.marknum_vertex = get("marknum_vertex");
+			stats.marknum_wire = get("marknum_wire");
 		}
 
 		void _LoadVertexInfos(const json& data) {
 
-			auto root_vertices = data["root_vertices"];
+			const json& root_vertices = Utils::GetJsonRecords(data, "root_vertices");
 
-			brepInfo.vertexInfos.resize(stats.marknum_vertex);
+			brepInfo.vertexInfos.resize(std::max<size_t>(stats.marknum_vertex, root_vertices.size()));
 
+			Utils::FieldFailures failures;
 			int ii = 0;
 			for (auto&& element : root_vertices) {
-				try {
-					int body_id = element.at("body");
-					int marknum = element.at("marknum");
+				VertexInfo& info = brepInfo.vertexInfos[ii++];
 
-					auto point = element.at("point");
-					float x = point.at("x");
-					float y = point.at("y");
-					float z = point.at("z");
+				bool ok = true;
+				ok &= Utils::GetJsonNumber(element, "body", info.bodyId, failures);
+				ok &= Utils::GetJsonNumber(element, "marknum", info.markNum, failures);
 
-					brepInfo.vertexInfos[ii].pos = glm::vec3{ x,y,z };
-					brepInfo.vertexInfos[ii].bodyId = body_id;
-					brepInfo.vertexInfos[ii].markNum = marknum;
+				const json* point = Utils::GetJsonChild(element, "point", json::value_t::object, failures);
+				ok &= point != nullptr && Utils::GetJsonVec3(*point, "x", "y", "z", info.pos, failures);
 
-					ii++;
+				if (!ok) {
+					info = VertexInfo();
+					failures.failedRecords++;
 				}
-				catch (json::out_of_range& e) {
-					SPDLOG_INFO("Vertex {} load failed", ii++);	
-				}
-
 			}
+			failures.Log("Vertices", root_vertices.size());
 
 		}
 
 		void _LoadEdgeInfos(const json& data) {
-			auto root_edges = data["root_edges"];
-			brepInfo.edgeInfos.resize(stats.marknum_edge);
+			const json& root_edges = Utils::GetJsonRecords(data, "root_edges");
+			brepInfo.edgeInfos.resize(std::max<size_t>(stats.marknum_edge, root_edges.size()));
+			brepInfo.edgeGeometries.Clear();
+
+			Utils::FieldFailures failures;
 			int ii = 0;
 			for (auto&& element : root_edges) {
-				try {
-					int body_id = element.at("body");
-					int marknum = element.at("marknum");
-					int st_marknum = element.at("st_marknum");
-					int ed_marknum = element.at("ed_marknum");
-					int nonmanifold_count = element.at("nonmanifold_count");
-
-					brepInfo.edgeInfos[ii].bodyId = body_id;
-					brepInfo.edgeInfos[ii].markNum = marknum;
+				EdgeInfo& info = brepInfo.edgeInfos[ii++];
+
+				bool ok = true;
+				ok &= Utils::GetJsonNumber(element, "body", info.bodyId, failures);
+				ok &= Utils::GetJsonNumber(element, "marknum", info.markNum, failures);
+				ok &= Utils::GetJsonNumber(element, "st_marknum", info.stMarkNum, failures);
+				ok &= Utils::GetJsonNumber(element, "ed_marknum", info.edMarkNum, failures);
+				ok &= Utils::GetJsonNumber(element, "nonmanifold_count", info.nonmanifoldCount, failures);
+
+				std::string curve_type_name = Utils::GetJsonStringOr(element, "curve_type");
+				CurveType curve_type = CurveTypeFromName(curve_type_name);
+				EdgeGeometryTable& geometries = brepInfo.edgeGeometries;
+				StraightCurveParams straight;
+				EllipseCurveParams ellipse;
+
+				if (curve_type == CurveType::STRAIGHT) {
+					StraightCurveParams& params = straight;
+					const json* property = Utils::GetJsonChild(element, "property", json::value_t::object, failures);
+					ok &= property != nullptr
+						&& Utils::GetJsonVec3(*property, "root_point_x", "root_point_y", "root_point_z", params.rootPoint, failures)
+						&& Utils::GetJsonVec3(*property, "direction_x", "direction_y", "direction_z", params.direction, failures);
+				}
+				else if (curve_type == CurveType::INTCURVE) {
+					const json* property = Utils::GetJsonChild(element, "property", json::value_t::object, failures);
+					const json* ctrlpts = property != nullptr ? Utils::GetJsonChild(*property, "ctrlpts", json::value_t::array, failures) : nullptr;
+					ok &= ctrlpts != nullptr;
+
+					if (ctrlpts != nullptr) {
+						for (auto&& ctrlpt : *ctrlpts) {
+							glm::vec3 pos;
+							ok &= Utils::GetJsonVec3(ctrlpt, "x", "y", "z", pos, failures);
+							geometries.intcurveCtrlpts.push_back(pos);
+						}
+					}
+				}
+				else if (curve_type == CurveType::ELLIPSE) {
+					EllipseCurveParams& params = ellipse;
+					const json* property = Utils::GetJsonChild(element, "property", json::value_t::object, failures);
+					ok &= property != nullptr
+						&& Utils::GetJsonVec3(*property, "centre_x", "centre_y", "centre_z", params.centre, failures)
+						&& Utils::GetJsonVec3(*property, "normal_x", "normal_y", "normal_z", params.normal, failures)
+						&& Utils::GetJsonVec3(*property, "major_axis_x", "major_axis_y", "major_axis_z", params.majorAxis, failures)
+						&& Utils::GetJsonNumber(*property, "major_length", params.majorAxisLength, failures)
+						&& Utils::GetJsonNumber(*property, "minor_length", params.minorAxisLength, failures);
+
+					// 与原来 float major_length = property.at("major_length") 一致，长度先转成float
+					params.majorAxisLength = static_cast<float>(params.majorAxisLength);
+					params.minorAxisLength = static_cast<float>(params.minorAxisLength);
+				}
 
-					brepInfo.edgeInfos[ii].stMarkNum = st_marknum;
-					brepInfo.edgeInfos[ii].edMarkNum = ed_marknum;
-					brepInfo.edgeInfos[ii].nonmanifoldCount = nonmanifold_count;
+				const json* sampled_points = Utils::GetJsonChild(element, "sampled_points", json::value_t::array, failures);
+				ok &= sampled_points != nullptr;
+				if (sampled_points != nullptr) {
+					for (auto&& point : *sampled_points) {
+						glm::vec3 pos;
+						ok &= Utils::GetJsonVec3(point, "x", "y", "z", pos, failures);
+						geometries.sampledPoints.push_back(pos);
+					}
+				}
 
-					// TODO: halfEdgesMarkNums
+				if (!ok) {
+					geometries.DiscardPending();
+					info = EdgeInfo();
+					failures.failedRecords++;
+					continue;
+				}
 
-					// at: Ԫزڻ׳쳣
-					// value(key, default_value): ԪزĬֵ
+				// 整条记录都读取成功之后才加入参数表
+				int param_index;
+				switch (curve_type) {
+				case CurveType::STRAIGHT:
+					geometries.straights.push_back(straight);
+					param_index = static_cast<int>(geometries.straights.size()) - 1;
+					break;
+				case CurveType::ELLIPSE:
+					geometries.ellipses.push_back(ellipse);
+					param_index = static_cast<int>(geometries.ellipses.size()) - 1;
+					break;
+				case CurveType::INTCURVE:
+					param_index = geometries.AddIntcurveCtrlpts();
+					break;
+				default:
+					param_index = geometries.AddOtherCurveType(curve_type_name);
+					break;
+				}
 
-					std::string curve_type = element.value("curve_type", "");
-					
+				int row = geometries.AddRow(curve_type, param_index);
+				info.geometryIndex = row;
 
-					if (curve_type == "straight") {
-						auto property = element.at("property");
+				if (geometries.PointCount(row) > 0) {
+					glm::vec3 first_sampled_point = geometries.Points(row)[0];
+					glm::vec3 last_sampled_point = geometries.Points(row)[geometries.PointCount(row) - 1];
+					glm::vec3 mid_point = (first_sampled_point + last_sampled_point) / 2.0f;
 
-						float root_point_x = property.at("root_point_x");
-						float root_point_y = property.at("root_point_y");
-						float root_point_z = property.at("root_point_z");
+					info.pos = mid_point;
+				}
+			}
+			failures.Log("Edges", root_edges.size());
+		}
 
-						float direction_x = property.at("direction_x");
-						float direction_y = property.at("direction_y");
-						float direction_z = property.at("direction_z");
+		void _LoadHalfEdgeInfos(const json& data) {
+			const json& root_coedges = Utils::GetJsonRecords(data, "root_coedges");
+			brepInfo.halfEdgeInfos.resize(std::max<size_t>(stats.marknum_coedge, root_coedges.size()));
 
+			Utils::FieldFailures failures;
+			int ii = 0;
+			for (auto&& element : root_coedges) {
+				HalfEdgeInfo& info = brepInfo.halfEdgeInfos[ii++];
+
+				bool ok = true;
+				ok &= Utils::GetJsonNumber(element, "body", info.bodyId, failures);
+				ok &= Utils::GetJsonNumber(element, "marknum", info.markNum, failures);
+				ok &= Utils::GetJsonNumber(element, "edge_marknum", info.edgeMarkNum, failures);
+				ok &= Utils::GetJsonNumber(element, "loop_marknum", info.loopMarkNum, failures);
+
+				auto sense = element.find("sense");
+				if (sense != element.end() && sense->is_boolean()) {
+					info.sense = sense->get<bool>();
+				}
+				else {
+					int sense_value = 0;
+					ok &= Utils::GetJsonNumber(element, "sense", sense_value, failures);
+					info.sense = sense_value != 0;
+				}
 
-						auto geometry_ptr = std::make_unique<StraightEdgeGeometry>();
-						geometry_ptr->rootPoint = glm::vec3{ root_point_x ,root_point_y, root_point_z };
-						geometry_ptr->direction = glm::vec3{ direction_x ,direction_y,direction_z };
-						brepInfo.edgeInfos[ii].geometryPtr = std::move(geometry_ptr);
+				// 在_LinkTopology中补上
+				info.partnerMarkNum = -1;
+				info.preMarkNum = -1;
+				info.nextMarkNum = -1;
+
+				auto property = element.find("property");
+				bool has_property = property != element.end() && property->is_object();
+				std::string curve_name = has_property ? Utils::GetJsonStringOr(*property, "curve_name") : std::string();
+
+				if (curve_name == "pcurve") {
+					auto geometry_ptr = std::make_unique<PcurveHalfEdgeGeometry>();
+					ok &= Utils::GetJsonNumber(*property, "curve_degree", geometry_ptr->curveDegree, failures);
+
+					const json* ctrlpts = Utils::GetJsonChild(*property, "ctrlpts", json::value_t::array, failures);
+					ok &= ctrlpts != nullptr;
+					if (ctrlpts != nullptr) {
+						for (auto&& ctrlpt : *ctrlpts) {
+							glm::vec2 uv;
+							ok &= Utils::GetJsonNumber(ctrlpt, "u", uv.x, failures);
+							ok &= Utils::GetJsonNumber(ctrlpt, "v", uv.y, failures);
+							geometry_ptr->ctrlpts.push_back(uv);
+						}
 					}
-					else if (curve_type == "intcurve") {
-						auto property = element.at("property");
-						auto ctrlpts = property.at("ctrlpts");
 
-						auto geometry_ptr = std::make_unique<IntcurveEdgeGeometry>();
-						for (auto&& ctrlpt : ctrlpts)
-						{
-							float x = ctrlpt.at("x");
-							float y = ctrlpt.at("y");
-							float z = ctrlpt.at("z");
-
-							geometry_ptr->ctrlpts.emplace_back(x, y, z);
+					const json* knots = Utils::GetJsonChild(*property, "knots", json::value_t::array, failures);
+					ok &= knots != nullptr;
+					if (knots != nullptr) {
+						for (auto&& knot : *knots) {
+							ok &= knot.is_number();
+							geometry_ptr->knots.push_back(knot.is_number() ? knot.get<double>() : 0.0);
 						}
-
-						brepInfo.edgeInfos[ii].geometryPtr = std::move(geometry_ptr);
-
 					}
-					else if (curve_type == "ellipse") {
-						auto property = element.at("property");
+					info.halfEdgeGeometry = std::move(geometry_ptr);
+				}
+				else {
+					info.halfEdgeGeometry = std::make_unique<HalfEdgeGeometry>();
+				}
 
-						float centre_x = property.at("centre_x");
-						float centre_y = property.at("centre_y");
-						float centre_z = property.at("centre_z");
+				info.halfEdgeGeometry->curveType = curve_name;
 
-						float normal_x = property.at("normal_x");
-						float normal_y = property.at("normal_y");
-						float normal_z = property.at("normal_z");
+				if (!ok) {
+					info = HalfEdgeInfo();
+					failures.failedRecords++;
+				}
+			}
+			failures.Log("HalfEdges", root_coedges.size());
+		}
 
-						float major_axis_x = property.at("major_axis_x");
-						float major_axis_y = property.at("major_axis_y");
-						float major_axis_z = property.at("major_axis_z");
+		void _LoadLoopInfos(const json& data) {
+			const json& root_loops = Utils::GetJsonRecords(data, "root_loops");
+			brepInfo.loopInfos.resize(std::max<size_t>(stats.marknum_loop, root_loops.size()));
 
-						float major_length = property.at("major_length");
-						float minor_length = property.at("minor_length");
+			Utils::FieldFailures failures;
+			int ii = 0;
+			for (auto&& element : root_loops) {
+				LoopInfo& info = brepInfo.loopInfos[ii++];
+
+				bool ok = true;
+				ok &= Utils::GetJsonNumber(element, "body", info.bodyId, failures);
+				ok &= Utils::GetJsonNumber(element, "marknum", info.markNum, failures);
+				ok &= Utils::GetJsonNumber(element, "face_marknum", info.faceMarkNum, failures);
+
+				const json* coedge_list = Utils::GetJsonChild(element, "coedge_list", json::value_t::array, failures);
+				ok &= coedge_list != nullptr;
+				if (coedge_list != nullptr) {
+					for (auto&& coedge : *coedge_list) {
+						int coedge_marknum = 0;
+						ok &= Utils::GetJsonNumber(coedge, "coedge_marknum", coedge_marknum, failures);
+						info.halfEdgesMarkNums.push_back(coedge_marknum);
+					}
+				}
 
-						auto geometry_ptr = std::make_unique<EllipseEdgeGeometry>();
+				if (!ok) {
+					info = LoopInfo();
+					failures.failedRecords++;
+				}
+			}
+			failures.Log("Loops", root_loops.size());
+		}
 
-						geometry_ptr->centre = glm::vec3{ centre_x, centre_y, centre_z };
-						geometry_ptr->normal = glm::vec3{ normal_x, normal_y, normal_z };
-						geometry_ptr->majorAxis = glm::vec3{ major_axis_x, major_axis_y, major_axis_z };
-						geometry_ptr->majorAxisLength = major_length;
-						geometry_ptr->minorAxisLength = minor_length;
+		void _LoadFaceInfos(const json& data) {
+			const json& root_faces = Utils::GetJsonRecords(data, "root_faces");
+			brepInfo.faceInfos.resize(std::max<size_t>(stats.marknum_face, root_faces.size()));
 
-						brepInfo.edgeInfos[ii].geometryPtr = std::move(geometry_ptr);
+			Utils::FieldFailures failures;
+			int ii = 0;
+			for (auto&& element : root_faces) {
+				FaceInfo& info = brepInfo.faceInfos[ii++];
+
+				bool ok = true;
+				ok &= Utils::GetJsonNumber(element, "body", info.bodyId, failures);
+				ok &= Utils::GetJsonNumber(element, "marknum", info.markNum, failures);
+				ok &= Utils::GetJsonNumber(element, "loop_marknum", info.stLoopMarkNum, failures);
+
+				const json* geometry_info_ptr = Utils::GetJsonChild(element, "geometry_info", json::value_t::object, failures);
+				if (geometry_info_ptr == nullptr) {
+					info = FaceInfo();
+					failures.failedRecords++;
+					continue;
+				}
+				const json& geometry_info = *geometry_info_ptr;
+				std::string face_type = Utils::GetJsonStringOr(geometry_info, "face_type");
+
+				auto get_vec3 = [&](const char* x_key, const char* y_key, const char* z_key, glm::vec3& out) {
+					ok &= Utils::GetJsonVec3(geometry_info, x_key, y_key, z_key, out, failures);
+				};
+				auto get_number = [&](const char* key, auto& out) {
+					ok &= Utils::GetJsonNumber(geometry_info, key, out, failures);
+				};
+				auto get_numbers = [&](const char* key, std::vector<double>& out) {
+					const json* numbers = Utils::GetJsonChild(geometry_info, key, json::value_t::array, failures);
+					ok &= numbers != nullptr;
+					if (numbers != nullptr) {
+						for (auto&& number : *numbers) {
+							ok &= number.is_number();
+							out.push_back(number.is_number() ? number.get<double>() : 0.0);
+						}
 					}
-					else {
-						brepInfo.edgeInfos[ii].geometryPtr = std::make_unique<EdgeGeometry>();
+				};
+
+				if (face_type == "plane") {
+					auto geometry_ptr = std::make_unique<PlaneFaceGeometry>();
+					get_vec3("root_point_x", "root_point_y", "root_point_z", geometry_ptr->rootPoint);
+					get_vec3("normal_x", "normal_y", "normal_z", geometry_ptr->normal);
+					info.faceGeometry = std::move(geometry_ptr);
+				}
+				else if (face_type == "sphere") {
+					auto geometry_ptr = std::make_unique<SphereFaceGeometry>();
+					get_vec3("centre_x", "centre_y", "centre_z", geometry_ptr->centre);
+					get_number("radius", geometry_ptr->radius);
+					info.faceGeometry = std::move(geometry_ptr);
+				}
+				else if (face_type == "torus") {
+					auto geometry_ptr = std::make_unique<TorusFaceGeometry>();
+					get_vec3("centre_x", "centre_y", "centre_z", geometry_ptr->centre);
+					get_vec3("normal_x", "normal_y", "normal_z", geometry_ptr->normal);
+					get_number("minor_radius", geometry_ptr->minorRadius);
+					get_number("major_radius", geometry_ptr->majorRadius);
+					info.faceGeometry = std::move(geometry_ptr);
+				}
+				else if (face_type == "cone") {
+					auto geometry_ptr = std::make_unique<ConeFaceGeometry>();
+					get_vec3("root_point_x", "root_point_y", "root_point_z", geometry_ptr->rootPoint);
+					get_vec3("major_axis_x", "major_axis_y", "major_axis_z", geometry_ptr->majorAxis);
+					get_number("ratio", geometry_ptr->ratio);
+					get_vec3("direction_x", "direction_y", "direction_z", geometry_ptr->direction);
+					get_number("cos", geometry_ptr->cos);
+					get_number("sin", geometry_ptr->sin);
+					get_number("angle", geometry_ptr->angle);
+					info.faceGeometry = std::move(geometry_ptr);
+				}
+				else if (face_type == "spline") {
+					auto geometry_ptr = std::make_unique<SplineFaceGeometry>();
+					get_number("degree_u", geometry_ptr->degreeU);
+					get_number("degree_v", geometry_ptr->degreeV);
+					get_number("num_u", geometry_ptr->numU);
+					get_number("num_v", geometry_ptr->numV);
+					get_number("num_knots_u", geometry_ptr->numKnotsU);
+					get_number("num_knots_v", geometry_ptr->numKnotsV);
+					get_number("weight_num_u", geometry_ptr->numWeightU);
+					get_number("weight_num_v", geometry_ptr->numWeightV);
+
+					const json* ctrlpts = Utils::GetJsonChild(geometry_info, "control_points", json::value_t::array, failures);
+					ok &= ctrlpts != nullptr;
+					if (ctrlpts != nullptr) {
+						for (auto&& ctrlpt : *ctrlpts) {
+							glm::vec3 pos;
+							ok &= Utils::GetJsonVec3(ctrlpt, "x", "y", "z", pos, failures);
+							geometry_ptr->ctrlpts.push_back(pos);
+						}
 					}
+					get_numbers("knots_u", geometry_ptr->uknots);
+					get_numbers("knots_v", geometry_ptr->vknots);
+					get_numbers("weights", geometry_ptr->weights);
+					info.faceGeometry = std::move(geometry_ptr);
+				}
+				else {
+					info.faceGeometry = std::make_unique<FaceGeometry>();
+				}
 
-					brepInfo.edgeInfos[ii].geometryPtr->curveType = curve_type;
-					
-					auto sampled_points = element.at("sampled_points");
-					for (auto&& point : sampled_points) {
-						float x = point.at("x");
-						float y = point.at("y");
-						float z = point.at("z");
+				info.faceGeometry->faceType = face_type;
 
-						brepInfo.edgeInfos[ii].geometryPtr->sampledPoints.emplace_back(x, y, z);
-					}
+				if (!ok) {
+					info = FaceInfo();
+					failures.failedRecords++;
+				}
+			}
+			failures.Log("Faces", root_faces.size());
+		}
 
-					glm::vec3 first_sampled_point = brepInfo.edgeInfos[ii].geometryPtr->sampledPoints.front();
-					glm::vec3 last_sampled_point = brepInfo.edgeInfos[ii].geometryPtr->sampledPoints.back();
-					glm::vec3 mid_point = (first_sampled_point + last_sampled_point) / 2.0f;
+		// 建立markNum到下标的索引和按markNum排序的视图，记录本身保持读取的顺序
+		void _IndexInfos() {
+			brepInfo.vertexIndex.Build(brepInfo.vertexInfos, stats.marknum_vertex);
+			brepInfo.edgeIndex.Build(brepInfo.edgeInfos, stats.marknum_edge);
+			brepInfo.halfEdgeIndex.Build(brepInfo.halfEdgeInfos, stats.marknum_coedge);
+			brepInfo.loopIndex.Build(brepInfo.loopInfos, stats.marknum_loop);
+			brepInfo.faceIndex.Build(brepInfo.faceInfos, stats.marknum_face);
+
+			brepInfo.vertexOrder = MarkNumOrder(brepInfo.vertexInfos);
+			brepInfo.edgeOrder = MarkNumOrder(brepInfo.edgeInfos);
+			brepInfo.halfEdgeOrder = MarkNumOrder(brepInfo.halfEdgeInfos);
+			brepInfo.loopOrder = MarkNumOrder(brepInfo.loopInfos);
+			brepInfo.faceOrder = MarkNumOrder(brepInfo.faceInfos);
+		}
 
-					brepInfo.edgeInfos[ii].pos = mid_point;
+		// 文件中只给出了 半边->边、半边->环、环->半边列表、面->环 的引用，这里补上反向的引用和GUI中Go按钮使用的位置
+		// 需要在_IndexInfos之后调用；读取失败的占位记录（没有几何信息）不参与
+		void _LinkTopology() {
+			for (auto& edge_info : brepInfo.edgeInfos) {
+				edge_info.halfEdgesMarkNums.clear();
+			}
 
-					ii++;
+			// 边 -> 半边，半边的位置取所在边的中点
+			// 半边按markNum的顺序处理，这样每条边上的半边列表也按markNum排列
+			for (int i : brepInfo.halfEdgeOrder) {
+				HalfEdgeInfo& half_edge_info = brepInfo.halfEdgeInfos[i];
+				if (!half_edge_info.halfEdgeGeometry) {
+					continue;
 				}
-				catch (json::out_of_range& e) {
-					SPDLOG_INFO("Edge {} load failed", ii++);
+				EdgeInfo* edge_info = brepInfo.edgeIndex.Find(brepInfo.edgeInfos, half_edge_info.edgeMarkNum);
+				if (edge_info != nullptr) {
+					edge_info->halfEdgesMarkNums.push_back(half_edge_info.markNum);
+					half_edge_info.pos = edge_info->pos;
 				}
 			}
-		}
 
-		void _LoadHalfEdgeInfos(const json& data) {
-			// TODO
-		}
+			// partner：同一条边上的半边按markNum顺序首尾相连（流形边上就是两条半边互相指向）
+			for (auto& edge_info : brepInfo.edgeInfos) {
+				size_t n = edge_info.halfEdgesMarkNums.size();
+				if (n < 2) {
+					continue;
+				}
+				for (size_t k = 0; k < n; k++) {
+					brepInfo.halfEdgeIndex.Find(brepInfo.halfEdgeInfos, edge_info.halfEdgesMarkNums[k])->partnerMarkNum = edge_info.halfEdgesMarkNums[(k + 1) % n];
+				}
+			}
 
-		void _LoadLoopInfos(const json& data) {
-			// TODO
-		}
+			// 环中半边的前后关系，环的位置取各半边位置的平均（同一个半边出现在多个环中时，以markNum最大的环为准）
+			for (int i : brepInfo.loopOrder) {
+				LoopInfo& loop_info = brepInfo.loopInfos[i];
+				size_t n = loop_info.halfEdgesMarkNums.size();
+				glm::vec3 sum{ 0.0f };
+				int count = 0;
+				for (size_t k = 0; k < n; k++) {
+					HalfEdgeInfo* half_edge_info = brepInfo.halfEdgeIndex.Find(brepInfo.halfEdgeInfos, loop_info.halfEdgesMarkNums[k]);
+					if (half_edge_info == nullptr || !half_edge_info->halfEdgeGeometry) {
+						continue;
+					}
+					half_edge_info->preMarkNum = loop_info.halfEdgesMarkNums[(k + n - 1) % n];
+					half_edge_info->nextMarkNum = loop_info.halfEdgesMarkNums[(k + 1) % n];
+					sum += half_edge_info->pos;
+					count++;
+				}
+				if (count > 0) {
+					loop_info.pos = sum / static_cast<float>(count);
+				}
+			}
 
-		void _LoadFaceInfos(const json& data) {
-			// TODO
+			// 面的位置取外环的位置
+			for (auto& face_info : brepInfo.faceInfos) {
+				if (!face_info.faceGeometry) {
+					continue;
+				}
+				LoopInfo* loop_info = brepInfo.loopIndex.Find(brepInfo.loopInfos, face_info.stLoopMarkNum);
+				if (loop_info != nullptr) {
+					face_info.pos = loop_info->pos;
+				}
+			}
 		}
 
 		template<typename T>
-		void _SortInfos(std::vector<T>& infos) {
-			std::sort(infos.begin(), infos.end(), [](const T& a, const T& b) {
-				return a.markNum < b.markNum;
-			});
+		void _PadInfos(std::vector<T>& infos, int count) {
+			if (static_cast<int>(infos.size()) < count) {
+				infos.resize(count);
+			}
+		}
+
+		// 去掉不属于selected_bodies的记录（边的几何行不回收，只是不再被引用）
+		void _FilterBodies(const std::set<int>& selected_bodies) {
+			auto filter = [&](auto& infos) {
+				infos.erase(std::remove_if(infos.begin(), infos.end(), [&](const auto& info) {
+					return selected_bodies.count(info.bodyId) == 0;
+				}), infos.end());
+			};
+			filter(brepInfo.vertexInfos);
+			filter(brepInfo.edgeInfos);
+			filter(brepInfo.halfEdgeInfos);
+			filter(brepInfo.loopInfos);
+			filter(brepInfo.faceInfos);
 		}
 	};
 }
\ No newline at end of file
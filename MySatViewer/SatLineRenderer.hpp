@@ -1,5 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -10,15 +15,31 @@
 #include "shader_s.h"
 
 #include "SatInfo.hpp"
+#include "EdgeTessellation.hpp"
+#include "ThreadPool.hpp"
 
 namespace MyRenderEngine {
 
 	class SatLineRenderer : public IRenderable {
 	public:
-		std::vector<unsigned int> VAOs;
-		std::vector<unsigned int> VBOs;
-		std::vector<int> edgeSampledPointsCounts;
-		std::vector<glm::vec3> edgeColors;
+		// 所有边的折线在同一个VBO中，同一颜色的边合并为一次multi draw
+		// pixelTolerance大于0时，按屏幕空间的误差重新离散每条边（见EdgeTessellation.hpp）：
+		//	相机移动明显（超过到最近的边的距离的一定比例，这个距离不小于场景半径的一定比例）或者投影改变时，并行地重新计算每条边的分段数，有变化才重新生成并上传
+		//	分段数取2的幂，相机小范围移动时大部分边的分段数不变
+		// pixelTolerance为0时直接上传satInfo中边几何表的采样点数组
+		unsigned int VAO = 0;
+		unsigned int VBO = 0;
+
+		float pixelTolerance = 0.5f;
+
+		struct ColorGroup {
+			glm::vec3 color;
+			std::vector<int> lines; // 在curves中的下标
+			std::vector<GLint> firsts;
+			std::vector<GLsizei> counts;
+		};
+		std::vector<ColorGroup> colorGroups;
+
 		Shader* shader;
 
 		glm::mat4 modelMatrix{ 1.0f };
@@ -26,6 +47,10 @@ namespace MyRenderEngine {
 		void Render(
 			const RenderInfo& renderInfo
 		) override {
+			if (pixelTolerance > 0.0f) {
+				_UpdateTessellation(renderInfo);
+			}
+
 			shader->use();
 
 			shader->setMatrix4("projection", renderInfo.projectionMatrix);
@@ -34,94 +59,205 @@ namespace MyRenderEngine {
 
 			//shader.setVec3("viewPos", camera_pos);
 
-			// 
-			for (int h = 0; h < VAOs.size(); h++) {
-				int VAO = VAOs[h];
-				int VAO_size = edgeSampledPointsCounts[h];
-				glm::vec3 color = edgeColors[h];
-
-				shader->setVec3("subcolor", color);
-				glBindVertexArray(VAO);
-				glDrawArrays(GL_LINE_STRIP, 0, VAO_size);
+			glBindVertexArray(VAO);
+			for (const ColorGroup& group : colorGroups) {
+				shader->setVec3("subcolor", group.color);
+				glMultiDrawArrays(GL_LINE_STRIP, group.firsts.data(), group.counts.data(), static_cast<GLsizei>(group.counts.size()));
 			}
+			glBindVertexArray(0);
 		}
 
 		void LoadFromSatInfo(Info::SatInfo& satInfo) {
-			VAOs.clear();
-			VBOs.clear();
-
-			edgeSampledPointsCounts.clear();
-			edgeColors.clear();
+			_DeleteBuffers();
+			colorGroups.clear();
+			curves.clear();
+			segmentCounts.clear();
+			tessellated = false;
 
+			geometries = &satInfo.brepInfo.edgeGeometries;
 
+			std::vector<int> rows;
 			for (Info::EdgeInfo& edgeInfo : satInfo.brepInfo.edgeInfos) {
-				auto& geometryPtr = edgeInfo.geometryPtr;
+				int row = edgeInfo.geometryIndex;
+				if (row < 0 || geometries->PointCount(row) < 2) {
+					continue;
+				}
 
-				edgeSampledPointsCounts.emplace_back(geometryPtr->sampledPoints.size());
-				edgeColors.emplace_back(edgeInfo.GetColor());
+				glm::vec3 color = edgeInfo.GetColor();
+				auto it = std::find_if(colorGroups.begin(), colorGroups.end(), [&](const ColorGroup& group) { return group.color == color; });
+				if (it == colorGroups.end()) {
+					colorGroups.push_back(ColorGroup{ color });
+					it = colorGroups.end() - 1;
+				}
 
-				// ݱƽʹ뵽openGL
-				std::vector<float> sampledPointsDataAsArray;
+				it->lines.push_back(static_cast<int>(rows.size()));
+				it->firsts.push_back(static_cast<GLint>(geometries->pointOffsets[row]));
+				it->counts.push_back(static_cast<GLsizei>(geometries->PointCount(row)));
+				rows.push_back(row);
+			}
 
-				for (glm::vec3& point : geometryPtr->sampledPoints) {
-					sampledPointsDataAsArray.emplace_back(point.x);
-					sampledPointsDataAsArray.emplace_back(point.y);
-					sampledPointsDataAsArray.emplace_back(point.z);
+			glGenVertexArrays(1, &VAO);
+			glGenBuffers(1, &VBO);
+
+			glBindVertexArray(VAO);
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			if (pixelTolerance > 0.0f) {
+				// 顶点在第一次Render时按相机生成
+				curves.resize(rows.size());
+				Utils::ThreadPool::GetInstance().ParallelFor(rows.size(), [&](size_t begin, size_t end, size_t) {
+					for (size_t i = begin; i < end; i++) {
+						curves[i] = Info::MakeEdgeCurve(*geometries, rows[i]);
+					}
+				}, 1024);
+				segmentCounts.assign(curves.size(), 0);
+
+				// 所有边的包围球的包围盒，取其半对角线为场景半径
+				glm::vec3 min_pos{ std::numeric_limits<float>::max() };
+				glm::vec3 max_pos{ -std::numeric_limits<float>::max() };
+				for (const Info::EdgeCurve& curve : curves) {
+					min_pos = glm::min(min_pos, curve.boundsCentre - glm::vec3(curve.boundsRadius));
+					max_pos = glm::max(max_pos, curve.boundsCentre + glm::vec3(curve.boundsRadius));
 				}
+				sceneRadius = curves.empty() ? 0.0f : glm::length(max_pos - min_pos) * 0.5f;
+			}
+			else {
+				glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * geometries->sampledPoints.size(), geometries->sampledPoints.data(), GL_STATIC_DRAW);
+			}
 
-				unsigned VAO, VBO;
-				glGenVertexArrays(1, &VAO);
-				glGenBuffers(1, &VBO);
+			glEnableVertexAttribArray(0);
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			glBindVertexArray(0);
+		}
 
-				glBindVertexArray(VAO);
-				glBindBuffer(GL_ARRAY_BUFFER, VBO);
-				glBufferData(GL_ARRAY_BUFFER, sizeof(float) * sampledPointsDataAsArray.size(), sampledPointsDataAsArray.data(), GL_STATIC_DRAW);
+		SatLineRenderer(Shader* shader) :
+			shader(shader)
+		{
+		}
 
-				glEnableVertexAttribArray(0);
-				glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-				glBindBuffer(GL_ARRAY_BUFFER, 0);
-				glBindVertexArray(0);
+		~SatLineRenderer() {
+			_DeleteBuffers();
+		}
 
-				VAOs.emplace_back(VAO);
-				VBOs.emplace_back(VBO);
+	private:
+		static constexpr int MAX_SEGMENTS = 1024;
+		static constexpr size_t MIN_CHUNK_SIZE = 1024;
+		static constexpr float MIN_GATE_DISTANCE = 0.01f; // 判断相机是否移动明显时，到最近的边的距离至少取场景半径的这个比例
+
+		const Info::EdgeGeometryTable* geometries = nullptr;
+		std::vector<Info::EdgeCurve> curves;
+		std::vector<int> segmentCounts;
+		std::vector<GLint> vertexOffsets;
+		std::vector<glm::vec3> vertices;
+		float sceneRadius = 0.0f;
+
+		// 上一次计算分段数时的相机（模型空间）、距离为1处每单位长度的像素数、判断相机移动的距离（到最近的不包含相机的边包围球的距离，不小于场景半径的MIN_GATE_DISTANCE倍）
+		bool tessellated = false;
+		glm::vec3 lastCameraPos{ 0.0f };
+		float lastPixelScale = 0.0f;
+		float lastNearestDistance = 0.0f;
+
+		void _UpdateTessellation(const RenderInfo& renderInfo) {
+			if (curves.empty()) {
+				return;
 			}
 
+			// 模型矩阵只有均匀缩放，屏幕上的误差 = 模型空间的误差 * pixel_scale / 模型空间的距离，与缩放无关
+			glm::vec3 camera_pos = renderInfo.cameraPos / renderInfo.scaleFactor;
+			float pixel_scale = std::abs(renderInfo.projectionMatrix[1][1]) * 0.5f * static_cast<float>(renderInfo.viewportHeight);
+			if (tessellated
+				&& std::abs(pixel_scale - lastPixelScale) <= 0.01f * lastPixelScale
+				&& glm::length(camera_pos - lastCameraPos) <= 0.1f * lastNearestDistance) {
+				return;
+			}
 
-			//edgeSampledPointsCounts = satInfo.edgeSampledPointsCounts;
-			//edgeColors = satInfo.edgeColors;
-
-			//for (auto vertices : satInfo.edgeSampledPoints) {
-			//	unsigned VAO, VBO;
-			//	glGenVertexArrays(1, &VAO);
-			//	glGenBuffers(1, &VBO);
-
-			//	glBindVertexArray(VAO);
-			//	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-			//	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
-
-			//	glEnableVertexAttribArray(0);
-			//	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+			Utils::ThreadPool& pool = Utils::ThreadPool::GetInstance();
+			size_t chunk_count = pool.ChunkCount(curves.size(), MIN_CHUNK_SIZE);
+			std::vector<float> nearest_distances(chunk_count, std::numeric_limits<float>::max());
+			std::vector<char> changed(chunk_count, 0);
+
+			pool.ParallelFor(curves.size(), [&](size_t begin, size_t end, size_t chunk_index) {
+				for (size_t i = begin; i < end; i++) {
+					const Info::EdgeCurve& curve = curves[i];
+					float centre_distance = glm::length(camera_pos - curve.boundsCentre);
+					float distance = centre_distance - curve.boundsRadius;
+					if (distance > 0.0f) {
+						nearest_distances[chunk_index] = std::min(nearest_distances[chunk_index], distance);
+					}
+					else {
+						// 相机在包围球内（很长的曲线或者拉近时很常见）：改用到最近的采样点的距离，不计入最近距离
+						distance = std::numeric_limits<float>::max();
+						const glm::vec3* samples = geometries->sampledPoints.data() + curve.firstSample;
+						for (uint32_t k = 0; k < curve.sampleCount; k++) {
+							distance = std::min(distance, glm::length(camera_pos - samples[k]));
+						}
+					}
+					distance = std::max(distance, 1e-6f);
+
+					// 采样点上的插值只能恢复到采样点的精度，加密不超过每段4倍
+					int max_segments = curve.kind == Info::EdgeCurve::Kind::ELLIPSE ? MAX_SEGMENTS : std::min(MAX_SEGMENTS, 4 * static_cast<int>(curve.sampleCount - 1));
+					int segments = curve.SegmentCount(pixelTolerance * distance / pixel_scale, max_segments);
+					int rounded = 1;
+					while (rounded < segments) {
+						rounded <<= 1;
+					}
+					segments = std::min(rounded, max_segments);
+
+					if (segments != segmentCounts[i]) {
+						segmentCounts[i] = segments;
+						changed[chunk_index] = 1;
+					}
+				}
+			}, MIN_CHUNK_SIZE);
+
+			lastCameraPos = camera_pos;
+			lastPixelScale = pixel_scale;
+			// 相机在所有边的包围球内时没有最近距离，只用下限
+			float nearest_distance = *std::min_element(nearest_distances.begin(), nearest_distances.end());
+			float min_gate_distance = MIN_GATE_DISTANCE * sceneRadius;
+			lastNearestDistance = nearest_distance == std::numeric_limits<float>::max() ? min_gate_distance : std::max(nearest_distance, min_gate_distance);
+			if (tessellated && std::find(changed.begin(), changed.end(), 1) == changed.end()) {
+				return;
+			}
+			tessellated = true;
 
-			//	glBindBuffer(GL_ARRAY_BUFFER, 0);
-			//	glBindVertexArray(0);
+			vertexOffsets.resize(curves.size() + 1);
+			vertexOffsets[0] = 0;
+			for (size_t i = 0; i < curves.size(); i++) {
+				vertexOffsets[i + 1] = vertexOffsets[i] + segmentCounts[i] + 1;
+			}
+			vertices.resize(vertexOffsets.back());
+
+			pool.ParallelFor(curves.size(), [&](size_t begin, size_t end, size_t) {
+				for (size_t i = begin; i < end; i++) {
+					glm::vec3* out = vertices.data() + vertexOffsets[i];
+					float step = 1.0f / static_cast<float>(segmentCounts[i]);
+					for (int k = 0; k <= segmentCounts[i]; k++) {
+						out[k] = curves[i].Evaluate(geometries->sampledPoints, k * step);
+					}
+				}
+			}, MIN_CHUNK_SIZE);
 
-			//	VAOs.emplace_back(VAO);
-			//	VBOs.emplace_back(VBO);
-			//}
-		}
+			for (ColorGroup& group : colorGroups) {
+				for (size_t k = 0; k < group.lines.size(); k++) {
+					int line = group.lines[k];
+					group.firsts[k] = vertexOffsets[line];
+					group.counts[k] = static_cast<GLsizei>(segmentCounts[line] + 1);
+				}
+			}
 
-		SatLineRenderer(Shader* shader) :
-			shader(shader)
-		{
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * vertices.size(), vertices.data(), GL_DYNAMIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
 		}
 
-		~SatLineRenderer() {
-			for (int i = 0; i < VAOs.size(); i++) {
-				glDeleteVertexArrays(1, &VAOs[i]);
-				glDeleteBuffers(1, &VBOs[i]);
+		void _DeleteBuffers() {
+			if (VAO != 0) {
+				glDeleteVertexArrays(1, &VAO);
+				glDeleteBuffers(1, &VBO);
+				VAO = 0;
+				VBO = 0;
 			}
-			VAOs.clear();
-			VBOs.clear();
 		}
 	};
 
@@ -10,6 +10,7 @@
 #include "shader_s.h"
 
 #include "SatInfo.hpp"
+#include "CompactVertex.hpp"
 
 namespace MyRenderEngine {
 
@@ -17,7 +18,56 @@ namespace MyRenderEngine {
 	public:
 		unsigned int VAO;
 		unsigned int VBO;
+		unsigned int EBO; // 仅索引模式使用
 		int stlVerticesCount;
+		bool indexed;
+		bool compactVertices; // 是否使用紧凑顶点格式（见CompactVertex.hpp）
+		Utils::QuantizationBox quantizationBox;
+
+		// 一次multi draw要绘制的若干段，相邻的段会合并
+		struct DrawList {
+			std::vector<GLint> firsts;
+			std::vector<GLsizei> counts;
+			std::vector<const void*> offsets; // 索引模式：每段在EBO中的字节偏移
+
+			void Clear() {
+				firsts.clear();
+				counts.clear();
+				offsets.clear();
+			}
+
+			void Add(int first, int count) {
+				if (count == 0) {
+					return;
+				}
+
+				if (!firsts.empty() && firsts.back() + counts.back() == first) {
+					counts.back() += count;
+					return;
+				}
+
+				firsts.push_back(first);
+				counts.push_back(count);
+				offsets.push_back(reinterpret_cast<const void*>(sizeof(unsigned int) * first));
+			}
+
+			void Draw(bool indexed) const {
+				if (counts.empty()) {
+					return;
+				}
+
+				if (indexed) {
+					glMultiDrawElements(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(), static_cast<GLsizei>(counts.size()));
+				}
+				else {
+					glMultiDrawArrays(GL_TRIANGLES, firsts.data(), counts.data(), static_cast<GLsizei>(counts.size()));
+				}
+			}
+		};
+
+		Info::SatInfo::StlSOA* stl; // 指向satInfo中的stl信息：GUI中修改part/面的可见性和高亮，渲染时据此决定绘制哪些段
+		DrawList drawList;
+		DrawList highlightDrawList;
 
 		Shader* shader;
 		Shader* transparentShader;
@@ -43,39 +93,129 @@ namespace MyRenderEngine {
 				s->setMatrix4("view", renderInfo.viewMatrix);
 				s->setMatrix4("model", glm::scale(modelMatrix, glm::vec3(renderInfo.scaleFactor)));
 				s->setVec3("viewPos", renderInfo.cameraPos);
+				s->setBool("flatNormalFromDerivatives", indexed);
+				s->setBool("compactVertices", compactVertices);
+				s->setVec3("positionMin", quantizationBox.min);
+				s->setVec3("positionExtent", quantizationBox.extent);
+
+				_CollectVisibleRanges();
 
 				glBindVertexArray(VAO);
-				glDrawArrays(GL_TRIANGLES, 0, stlVerticesCount);
+
+				s->setBool("highlight", false);
+				drawList.Draw(indexed);
+
+				s->setBool("highlight", true);
+				highlightDrawList.Draw(indexed);
+
+				glBindVertexArray(0);
+			}
+		}
+
+		// 可见的段分为普通和高亮两组，各自合并为一次multi draw
+		// 按面的范围绘制：面、所属的solid、所属的part都可见时才绘制，其中任何一个高亮时高亮
+		// （part -> solid -> 面 是逐层嵌套的连续范围，stlFaces覆盖了所有三角形）
+		void _CollectVisibleRanges() {
+			drawList.Clear();
+			highlightDrawList.Clear();
+
+			if (stl->stlFaces.empty()) {
+				for (const Info::StlRange& part : stl->stlParts) {
+					if (part.visible) {
+						(part.highlighted ? highlightDrawList : drawList).Add(part.first, part.count);
+					}
+				}
+				return;
+			}
+
+			for (const Info::StlRange& face : stl->stlFaces) {
+				const Info::StlRange& solid = stl->stlSolids[face.parent];
+				const Info::StlRange& part = stl->stlParts[solid.parent];
+				if (face.visible && solid.visible && part.visible) {
+					bool highlighted = face.highlighted || solid.highlighted || part.highlighted;
+					(highlighted ? highlightDrawList : drawList).Add(face.first, face.count);
+				}
 			}
 		}
 
-		void LoadFromSatInfo(Info::SatInfo& satInfo) {
+		void LoadFromSatInfo(Info::SatInfo& satInfo, bool compact_vertices = false) {
 			stlVerticesCount = satInfo.stl.stlVerticesCount;
+			indexed = satInfo.stl.indexed;
+			compactVertices = compact_vertices;
+			stl = &satInfo.stl;
 
 			glGenVertexArrays(1, &VAO);
 			glGenBuffers(1, &VBO);
 
 			glBindVertexArray(VAO);
 			glBindBuffer(GL_ARRAY_BUFFER, VBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(float) * satInfo.stl.stlVertices.size(), satInfo.stl.stlVertices.data(), GL_STATIC_DRAW);
 
-			glEnableVertexAttribArray(0);
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-			glEnableVertexAttribArray(1);
-			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+			if (indexed) {
+				// 索引模式：只上传去重后的顶点坐标和索引，attribute 1（法向）不启用
+				size_t vertex_count = satInfo.stl.stlUniqueCoords.size() / 3;
+
+				if (compactVertices) {
+					quantizationBox = Utils::ComputeQuantizationBox(satInfo.stl.stlUniqueCoords.data(), vertex_count, 3);
+					auto compact = Utils::EncodeCompactPositions(satInfo.stl.stlUniqueCoords.data(), vertex_count, quantizationBox);
+					glBufferData(GL_ARRAY_BUFFER, sizeof(Utils::CompactPosition) * compact.size(), compact.data(), GL_STATIC_DRAW);
+
+					glEnableVertexAttribArray(0);
+					glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Utils::CompactPosition), (void*)0);
+				}
+				else {
+					glBufferData(GL_ARRAY_BUFFER, sizeof(float) * satInfo.stl.stlUniqueCoords.size(), satInfo.stl.stlUniqueCoords.data(), GL_STATIC_DRAW);
+
+					glEnableVertexAttribArray(0);
+					glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+				}
+
+				glGenBuffers(1, &EBO);
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+				glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * satInfo.stl.stlTriangleIndices.size(), satInfo.stl.stlTriangleIndices.data(), GL_STATIC_DRAW);
+			}
+			else if (compactVertices) {
+				size_t vertex_count = satInfo.stl.stlVertices.size() / 6;
+
+				quantizationBox = Utils::ComputeQuantizationBox(satInfo.stl.stlVertices.data(), vertex_count, 6);
+				auto compact = Utils::EncodeCompactVertices(satInfo.stl.stlVertices.data(), vertex_count, quantizationBox);
+				glBufferData(GL_ARRAY_BUFFER, sizeof(Utils::CompactVertex) * compact.size(), compact.data(), GL_STATIC_DRAW);
 
+				glEnableVertexAttribArray(0);
+				glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Utils::CompactVertex), (void*)offsetof(Utils::CompactVertex, position));
+				glEnableVertexAttribArray(1);
+				glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(Utils::CompactVertex), (void*)offsetof(Utils::CompactVertex, normal));
+			}
+			else {
+				glBufferData(GL_ARRAY_BUFFER, sizeof(float) * satInfo.stl.stlVertices.size(), satInfo.stl.stlVertices.data(), GL_STATIC_DRAW);
+
+				glEnableVertexAttribArray(0);
+				glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+				glEnableVertexAttribArray(1);
+				glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+			}
+
+			glBindVertexArray(0); // 注意：EBO的绑定记录在VAO中，要先解绑VAO
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
-			glBindVertexArray(0);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 		}
 
 		SatStlRenderer(Shader* shader, Shader* transparentShader) :
 			shader(shader),
 			transparentShader(transparentShader),
 			VAO(0),
-			VBO(0)
+			VBO(0),
+			EBO(0),
+			stlVerticesCount(0),
+			indexed(false),
+			compactVertices(false),
+			stl(nullptr)
 		{
 		}
 
-		~SatStlRenderer() {}
+		~SatStlRenderer() {
+			glDeleteVertexArrays(1, &VAO);
+			glDeleteBuffers(1, &VBO);
+			glDeleteBuffers(1, &EBO);
+		}
 	};
 }
\ No newline at end of file
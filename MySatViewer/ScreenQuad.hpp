@@ -19,7 +19,7 @@ namespace MyRenderEngine {
 
 		int verticesCount;
 
-		//glm::mat4 modelMatrix; // ʵûGetModelMatrixȲָ
+		//glm::mat4 modelMatrix; // 这版实现没有GetModelMatrix函数，所以先不用指定这个
 
 		void Render(
 			const RenderInfo& renderInfo
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "RenderInfo.hpp"
+#include "IRenderable.hpp"
+
+#include "SatInfo.hpp"
+
+#include "imgui.h"
+#include "imgui_impl_glfw.h"
+#include "imgui_impl_opengl3.h"
+
+namespace MyRenderEngine {
+
+	// stl的part/solid/面列表：控制每个part/solid/面是否显示、是否高亮（SatStlRenderer直接读取satInfo中的可见性和高亮）
+	class StlGuiRenderer : public IRenderable {
+	public:
+		Info::SatInfo& satInfo;
+
+		// 显示/单独显示/高亮一组绘制范围
+		void RenderRanges(const char* label, std::vector<Info::StlRange>& ranges) {
+			if (ImGui::TreeNode(label, "%s (%d)", label, static_cast<int>(ranges.size()))) {
+				if (ImGui::Button("Show All")) {
+					for (auto& range : ranges) {
+						range.visible = true;
+					}
+				}
+				ImGui::SameLine();
+				if (ImGui::Button("Clear Highlight")) {
+					for (auto& range : ranges) {
+						range.highlighted = false;
+					}
+				}
+
+				int id = 0;
+				for (auto& range : ranges) {
+					ImGui::PushID(id++);
+
+					ImGui::Checkbox(range.name.c_str(), &range.visible);
+					ImGui::SameLine();
+					ImGui::TextDisabled("%d triangles", range.count / 3);
+					ImGui::SameLine();
+
+					// 单独显示
+					if (ImGui::SmallButton("Isolate")) {
+						for (auto& other : ranges) {
+							other.visible = (&other == &range);
+						}
+					}
+					ImGui::SameLine();
+					ImGui::Checkbox("Highlight", &range.highlighted);
+
+					ImGui::PopID();
+				}
+
+				ImGui::TreePop();
+			}
+		}
+
+		void Render(
+			const RenderInfo& renderInfo
+		) override {
+			ImGui::Begin("STL Info");
+
+			RenderRanges("Parts", satInfo.stl.stlParts);
+			RenderRanges("Solids", satInfo.stl.stlSolids);
+
+			// 只有加载了面信息时才列出面
+			if (!satInfo.stl.stlTriangleToFaceMarkNums.empty()) {
+				RenderRanges("Faces", satInfo.stl.stlFaces);
+			}
+
+			ImGui::End();
+		}
+
+		StlGuiRenderer(Info::SatInfo& satInfo) : satInfo(satInfo) {}
+
+		~StlGuiRenderer() {}
+	};
+
+}
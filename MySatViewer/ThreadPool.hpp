@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/*
+	全局线程池
+	用途：加载阶段的数据并行（STL三角形展开、json分段解析等）
+	线程数由命令行 -j 设置，为1时所有并行接口都退化为在调用线程上串行执行
+*/
+
+namespace Utils {
+
+	class ThreadPool {
+	public:
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// 单例
+		static ThreadPool& GetInstance() {
+			static ThreadPool pool_instance;
+			return pool_instance;
+		}
+
+		// 设置线程数（包括调用线程本身）：0表示使用全部硬件线程
+		void SetThreadCount(size_t thread_count) {
+			if (thread_count == 0) {
+				thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+			}
+
+			_StopWorkers();
+
+			threadCount = thread_count;
+			stopping = false;
+
+			// 调用线程也参与计算，因此只需要额外开 thread_count - 1 个工作线程
+			for (size_t i = 1; i < threadCount; i++) {
+				workers.emplace_back([this]() { _WorkerLoop(); });
+			}
+		}
+
+		size_t ThreadCount() const {
+			return threadCount;
+		}
+
+		// 提交一个任务，返回对应的future（任务抛出的异常会在future.get()时重新抛出）
+		template <typename F>
+		auto Submit(F&& f) -> std::future<decltype(f())> {
+			using R = decltype(f());
+
+			auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+			std::future<R> res = task->get_future();
+
+			// 没有工作线程或者已经在工作线程中（避免嵌套等待导致死锁）：直接在当前线程执行
+			if (workers.empty() || isWorkerThread) {
+				(*task)();
+				return res;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				tasks.emplace([task]() { (*task)(); });
+			}
+			cv.notify_one();
+
+			return res;
+		}
+
+		// 把 [0, count) 切成若干连续的块并行处理：fn(begin, end, chunk_index)
+		// 块数不超过线程数，每个块的下标范围是确定的，因此调用方可以按chunk_index预留各自的归约结果
+		template <typename F>
+		void ParallelFor(size_t count, F&& fn, size_t min_chunk_size = 4096) {
+			size_t chunk_count = ChunkCount(count, min_chunk_size);
+
+			if (chunk_count <= 1) {
+				if (count > 0) {
+					fn(size_t(0), count, size_t(0));
+				}
+				return;
+			}
+
+			std::vector<std::future<void>> futures;
+			futures.reserve(chunk_count - 1);
+
+			for (size_t c = 1; c < chunk_count; c++) {
+				size_t begin = count * c / chunk_count;
+				size_t end = count * (c + 1) / chunk_count;
+				futures.emplace_back(Submit([&fn, begin, end, c]() { fn(begin, end, c); }));
+			}
+
+			// 第0块由调用线程完成
+			// 注意：任何一块抛出异常时，也要等所有块都结束后才能返回（各块引用了fn），之后再重新抛出第一个异常
+			std::exception_ptr first_exception;
+			try {
+				fn(size_t(0), count / chunk_count, size_t(0));
+			}
+			catch (...) {
+				first_exception = std::current_exception();
+			}
+
+			for (auto& f : futures) {
+				try {
+					f.get();
+				}
+				catch (...) {
+					if (!first_exception) {
+						first_exception = std::current_exception();
+					}
+				}
+			}
+
+			if (first_exception) {
+				std::rethrow_exception(first_exception);
+			}
+		}
+
+		// ParallelFor实际会使用的块数
+		size_t ChunkCount(size_t count, size_t min_chunk_size = 4096) const {
+			if (isWorkerThread || count == 0) {
+				return 1;
+			}
+
+			size_t by_size = (count + min_chunk_size - 1) / std::max<size_t>(1, min_chunk_size);
+			return std::max<size_t>(1, std::min(threadCount, by_size));
+		}
+
+		~ThreadPool() {
+			_StopWorkers();
+		}
+
+	private:
+		std::vector<std::thread> workers;
+		std::queue<std::function<void()>> tasks;
+
+		std::mutex mutex;
+		std::condition_variable cv;
+		bool stopping = false;
+		size_t threadCount = 1;
+
+		static inline thread_local bool isWorkerThread = false;
+
+		ThreadPool() {}
+
+		void _WorkerLoop() {
+			isWorkerThread = true;
+
+			while (true) {
+				std::function<void()> task;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					cv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+					if (stopping && tasks.empty()) {
+						return;
+					}
+
+					task = std::move(tasks.front());
+					tasks.pop();
+				}
+				task();
+			}
+		}
+
+		void _StopWorkers() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			cv.notify_all();
+
+			for (auto& w : workers) {
+				w.join();
+			}
+			workers.clear();
+		}
+	};
+}
@@ -11,8 +11,8 @@
 
 
 /*
-	Objģͼغõ˽ṹ
-	SatģʱûҪ
+	Obj模型加载后会用到的拓扑结构
+	（Sat模型暂时没必要用这个）
 */
 
 namespace Topology {
@@ -183,7 +183,25 @@ namespace Topology {
 	//	}
 	//};
 
-	struct Entity {};
+	enum class TopoType {
+		NoExist = 0,
+		Entity = 1,
+		Solid = 2,
+		Face = 3,
+		Loop = 4,
+		HalfEdge = 5,
+		Edge = 6,
+		Vertex = 7
+	};
+
+	// 类型数（用于按类型开数组）
+	const int TOPO_TYPE_COUNT = 8;
+
+	// 类型与计数直接存放在实体内，由ObjMarkNum在创建时写入
+	struct Entity {
+		TopoType type = TopoType::NoExist;
+		int id = -1;
+	};
 	struct Vertex;
 	struct HalfEdge;
 	struct Edge;
@@ -197,7 +215,7 @@ namespace Topology {
 
 	struct Edge : public Entity {
 		std::shared_ptr<Vertex> st, ed;
-		std::vector<std::shared_ptr<HalfEdge>> halfEdges; // ֤˳
+		std::vector<std::shared_ptr<HalfEdge>> halfEdges; // 不保证顺序
 
 		T_NUM Length() const {
 			return st->pointCoord.Distance(ed->pointCoord);
@@ -211,7 +229,7 @@ namespace Topology {
 	};
 
 	struct HalfEdge : public Entity {
-		// false: edgeһ, true: һ
+		// false: 与edge一致, true: 不一致
 		bool sense;
 		std::shared_ptr<HalfEdge> partner;
 		std::shared_ptr<Loop> loop;
@@ -257,20 +275,9 @@ namespace Topology {
 	};
 
 	void Edge::UpdateHalfEdgesPartner() {
-		// halfedge˳򴮳һ
+		// 按照halfedge添加顺序串成一个环
 		for (int h = 0; h < halfEdges.size(); h++) {
 			halfEdges[h]->partner = halfEdges[(h + 1) % halfEdges.size()];
 		}
 	}
-
-	enum class TopoType {
-		NoExist = 0,
-		Entity = 1,
-		Solid = 2,
-		Face = 3,
-		Loop = 4,
-		HalfEdge = 5,
-		Edge = 6,
-		Vertex = 7
-	};
 }
\ No newline at end of file
@@ -1,49 +1,20 @@
 #pragma once
 
 #include "Topology.hpp"
+#include "EdgeGeometryTable.hpp"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 /*
-	ҪڱGUIдʾ߼
-	ע⣺Ⱦ᲻ɱ漰Ҫʹ飨SOAʾйȾϢƷ࿪ͷһһIndexض͵Infoλ飨SOAеϢ
+	主要用于保存GUI中处理拓扑显示的逻辑
+	注意：由于渲染会不可避免地涉及到要使用数组（SOA）来表示有关渲染信息，因此所有品类开头第一项一定都是Index。对于特定类型的Info，可以用这个索引来反向定位数组（SOA）中的信息
 */
 
 namespace Info {
 
-	// Edge Geometry
-	struct EdgeGeometry {
-		std::string curveType;
-		std::vector<glm::vec3> sampledPoints;
-	};
-
-	struct IntcurveEdgeGeometry : public EdgeGeometry {
-		std::vector<glm::vec3> ctrlpts;
-	};
-
-	struct EllipseEdgeGeometry : public EdgeGeometry {
-		glm::vec3 centre;
-		glm::vec3 normal;
-		glm::vec3 majorAxis;
-
-		double majorAxisLength;
-		double minorAxisLength;
-	};
-
-	struct StraightEdgeGeometry : public EdgeGeometry {
-		glm::vec3 rootPoint;
-		glm::vec3 direction;
-	};
-
-	struct HelixEdgeGeometry : public EdgeGeometry {
-		// TODO
-	};
-
-	struct UndefcEdgeGeometry : public EdgeGeometry {
-		// TODO
-	};
+	// Edge Geometry：所有边的几何统一存放在EdgeGeometryTable中（见EdgeGeometryTable.hpp）
 
 	// HalfEdge Geometry
 	struct HalfEdgeGeometry {
@@ -112,24 +83,24 @@ namespace Info {
 
 
 	struct TopologyInfo {
-		int index; // غĶӦ±꣬±guiʾ±ǺͶȡйصģģͱûйϵ
+		int index; // 加载后的对应下标，这个下标会用于在gui中显示索引（这个下标是和读取有关的，和模型本身没有关系）
 
 		int markNum;
 		int bodyId;
 
-		glm::vec3 pos; // goť
+		glm::vec3 pos; // 用于go按钮
 	};
 
 
 	struct EdgeInfo: public TopologyInfo {
 		int nonmanifoldCount;
 
-		int stMarkNum; // markNum
-		int edMarkNum; // յmarkNum
-		std::vector<int> halfEdgesMarkNums; // õаߵmarkNum
+		int stMarkNum; // 起点的markNum
+		int edMarkNum; // 终点的markNum
+		std::vector<int> halfEdgesMarkNums; // 所引用的所有半边的markNum
 
 		// Geometry info need to show in here
-		std::unique_ptr<EdgeGeometry> geometryPtr;
+		int geometryIndex = -1; // 在SatInfo::BrepInfo::edgeGeometries中的行号，-1表示没有几何信息（读取失败的占位）
 
 
 		glm::vec3 GetColor() {
@@ -146,16 +117,16 @@ namespace Info {
 	};
 
 	struct VertexInfo: public TopologyInfo {
-		// ͬpos˴˴
+		// 由于坐标等同于pos，因此此处不再增加数据
 	};
 
 	struct HalfEdgeInfo: public TopologyInfo {
 		bool sense;
-		int edgeMarkNum; // ӦıߵmarkNum
-		int partnerMarkNum; // ӦpartnermarkNum
-		int preMarkNum; // ͬһеǰһ
-		int nextMarkNum; // ͬһеĺһ
-		int loopMarkNum; // ӦĻmarkNum
+		int edgeMarkNum; // 对应的边的markNum
+		int partnerMarkNum; // 对应的partner的markNum
+		int preMarkNum; // 同一个环中的前一个半边
+		int nextMarkNum; // 同一个环中的后一个半边
+		int loopMarkNum; // 对应的环的markNum
 
 		// Geometry info need to show in here
 		std::unique_ptr<HalfEdgeGeometry> halfEdgeGeometry;
@@ -163,13 +134,13 @@ namespace Info {
 
 	struct LoopInfo: public TopologyInfo {
 		
-		std::vector<int> halfEdgesMarkNums; // õаߵmarkNum
+		std::vector<int> halfEdgesMarkNums; // 所引用的所有半边的markNum
 
-		int faceMarkNum; // ӦmarkNum
+		int faceMarkNum; // 对应的面的markNum
 	};
 
 	struct FaceInfo : public TopologyInfo {
-		int stLoopMarkNum; // ӦĻmarkNum
+		int stLoopMarkNum; // 对应的环的markNum
 
 		// Geometry info need to show in here
 
@@ -198,8 +169,8 @@ namespace Info {
 	// Rays
 	struct OneRayInfo {
 		glm::vec3 start_point;
-		glm::vec3 direction; // λ
-		float r; // 
+		glm::vec3 direction; // 单位方向向量
+		float r; // 长度
 		int id;
 		int from_cell_id;
 		int to_meshbox_id;
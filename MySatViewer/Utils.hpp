@@ -1,6 +1,11 @@
 #pragma once
 
 #include <string>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -8,7 +13,7 @@
 
 
 namespace Utils {
-	glm::mat4 CalculateModelMatrix(const glm::vec3& position, const glm::vec3& rotation = glm::vec3(0.0f), const glm::vec3& scale = glm::vec3(1.0f)) { // ԭĬϱ𡭡
+	glm::mat4 CalculateModelMatrix(const glm::vec3& position, const glm::vec3& rotation = glm::vec3(0.0f), const glm::vec3& scale = glm::vec3(1.0f)) { // 原来引用能设置默认变量吗……
 		glm::mat4 trans = glm::mat4(1.0f);
 
 		trans = glm::translate(trans, position);
@@ -50,10 +55,106 @@ namespace Utils {
 		return res;
 	}
 
+	// 通配符匹配：* 匹配任意个字符，? 匹配一个字符
+	bool WildcardMatch(const std::string& pattern, const std::string& s) {
+		size_t p = 0, i = 0;
+		size_t star_p = std::string::npos, star_i = 0;
+
+		while (i < s.size()) {
+			if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == s[i])) {
+				p++;
+				i++;
+			}
+			else if (p < pattern.size() && pattern[p] == '*') {
+				star_p = p++;
+				star_i = i;
+			}
+			else if (star_p != std::string::npos) {
+				p = star_p + 1;
+				i = ++star_i;
+			}
+			else {
+				return false;
+			}
+		}
+
+		while (p < pattern.size() && pattern[p] == '*') {
+			p++;
+		}
+		return p == pattern.size();
+	}
+
+	// 展开逗号分隔的路径列表，每一项的文件名部分可以带通配符（例如 ./models/C_ent(1)_stl_*.stl），匹配结果按文件名排序
+	// 文件名中可能带逗号：整个参数就是一个存在的文件时不拆分；含有分号时只按分号拆分，这样可以列出带逗号的路径
+	std::vector<std::string> ExpandPaths(const std::string& path_list) {
+		namespace fs = std::filesystem;
+
+		std::error_code exists_ec;
+		if (fs::is_regular_file(path_list, exists_ec)) {
+			return { path_list };
+		}
+
+		std::vector<std::string> res;
+		char separator = path_list.find(';') != std::string::npos ? ';' : ',';
+		for (const std::string& item : SplitStr(path_list, separator)) {
+			fs::path item_path(item);
+			std::string file_pattern = item_path.filename().string();
+
+			if (file_pattern.find_first_of("*?") == std::string::npos) {
+				res.push_back(item);
+				continue;
+			}
+
+			fs::path dir = item_path.parent_path();
+			std::vector<std::string> matches;
+			std::error_code ec;
+			for (const auto& entry : fs::directory_iterator(dir.empty() ? fs::path(".") : dir, ec)) {
+				if (entry.is_regular_file() && WildcardMatch(file_pattern, entry.path().filename().string())) {
+					matches.push_back((dir / entry.path().filename()).string());
+				}
+			}
+
+			if (matches.empty()) {
+				throw std::runtime_error("No file matches: " + item);
+			}
+
+			std::sort(matches.begin(), matches.end());
+			res.insert(res.end(), matches.begin(), matches.end());
+		}
+		return res;
+	}
+
 	template <typename T>
 	T clamp(T value, T l, T r) {
 		if (value < l) return l;
 		if (value > r) return r;
 		return value;
 	}
+
+	// 默认初始化的分配器：vector.resize() 时不再对 float 等平凡类型逐个清零
+	// 用于预先分配好大小、随后会被完整覆盖写入的大数组（例如STL顶点数组）
+	template <typename T, typename A = std::allocator<T>>
+	class DefaultInitAllocator : public A {
+		using a_t = std::allocator_traits<A>;
+	public:
+		template <typename U>
+		struct rebind {
+			using other = DefaultInitAllocator<U, typename a_t::template rebind_alloc<U>>;
+		};
+
+		using A::A;
+
+		template <typename U>
+		void construct(U* ptr) noexcept(std::is_nothrow_default_constructible<U>::value) {
+			::new(static_cast<void*>(ptr)) U;
+		}
+
+		template <typename U, typename... Args>
+		void construct(U* ptr, Args&&... args) {
+			a_t::construct(static_cast<A&>(*this), ptr, std::forward<Args>(args)...);
+		}
+	};
+
+	template <typename T>
+	using UninitVector = std::vector<T, DefaultInitAllocator<T>>;
 }
\ No newline at end of file
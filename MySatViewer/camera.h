@@ -17,7 +17,7 @@ enum Camera_Movement {
 // Default camera values
 const float YAW = -90.0f;
 const float PITCH = 0.0f;
-const float SPEED = 1.0f; // ڴģ˵10̫
+const float SPEED = 1.0f; // 对于大多数模型来说10还是太快了
 const float SENSITIVITY = 0.1f;
 const float ZOOM = 45.0f;
 
@@ -21,6 +21,8 @@
 
 #include <iostream>
 #include <fstream>
+#include <set>
+#include <charconv>
 
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
@@ -30,7 +32,9 @@
 #include <spdlog/sinks/basic_file_sink.h>
 
 #include "BasicGuiRenderer.hpp"
+#include "Benchmark.hpp"
 #include "ScreenQuad.hpp"
+#include "ThreadPool.hpp"
 
 #include "SatInfo.hpp"
 #include "ObjInfo.hpp"
@@ -38,7 +42,7 @@
 #include "CellInfo.hpp"
 #include "RayInfo.hpp"
 
-#include "ObjMarkNum.hpp"
+#include "HalfEdgeMesh.hpp"
 
 #include "ObjRenderer.hpp"
 #include "ObjLineRenderer.hpp"
@@ -47,6 +51,7 @@
 #include "SatStlRenderer.hpp"
 #include "SatLineRenderer.hpp"
 #include "SatGuiRenderer.hpp"
+#include "StlGuiRenderer.hpp"
 
 #include "DebugShowRenderer.hpp"
 #include "DebugShowGuiRenderer.hpp"
@@ -99,23 +104,50 @@ int main(int argc, char const* argv[])
         .add_help_option()
         .use_color_error()
         .add_sc_option("-v", "--version", "show version info", []() {std::cout << "MySatViewer version: " << VERSION << std::endl; })
-        .add_option<std::string>("-m", "--mode", "SatViewer Mode. sat for stl & geometry from sat; obj for obj; cell for cell & meshbox & rays", "")
-        .add_option<int>("-b", "--body", "(Only For STL) Which body you want to show for lines.", -1)
+        .add_option<std::string>("-m", "--mode", "SatViewer Mode. sat for stl & geometry from sat; obj for obj; cell for cell & meshbox & rays; bench for benchmarks", "")
+        .add_option<std::string>("-b", "--body", "(Only For STL) Comma separated body ids (e.g. 1,3) whose geometry json records are loaded. Empty or -1 loads all bodies", "")
         .add_option<float>("-x", "--scale", "(Only For OBJ) Scale OBJ", 1.0)
         .add_option<double>("-D", "--distance", "(Only For OBJ) Distance Threshold for red short edges", 0.001)
         .add_option<double>("-A", "--angle", "(Only For OBJ) Angle Threshold for angle", 150.0)
-        .add_option<std::string>("-p", "--path", "OBJ or STL Path", "")
+        .add_option<std::string>("-p", "--path", "OBJ or STL Path. For STL a comma separated list and wildcards (e.g. ./models/C_ent(1)_stl_*.stl) load several parts; separate with ';' instead when a path contains a comma", "")
         .add_option<std::string>("-g", "--geometry", "(Only For STL) Geometry File Path", "")
 		.add_option<std::string>("-d", "--debugshow", "DebugShow File Path", "")
         .add_option<std::string>("", "--cell", "Cell Json File Path", "")
         .add_option<std::string>("", "--meshbox", "Meshbox Json File Path", "")
         .add_option<std::string>("", "--rays", "Rays Json File Path", "")
+        .add_option("", "--indexed", "(For STL and OBJ) Upload shared vertices with an index buffer instead of per-corner vertices. Face normals come from screen space derivatives")
+        .add_option("", "--compact-vertices", "(For STL and OBJ) Upload 16-bit quantized positions and octahedral normals instead of floats")
+        .add_option("", "--no-geometry-cache", "(Only For STL) Always parse the geometry json instead of reading or writing its binary cache")
+        .add_option("", "--lazy-edge-properties", "(Only For STL) Skip edge properties while parsing the geometry json and decode them when an edge is opened in the GUI")
+        .add_option<int>("-j", "--threads", "Worker threads used for loading files. 0 for all hardware threads", 1)
+        .add_option<std::string>("", "--bench", "(Only For bench) Benchmark name: stl_ascii, normals, geometry_json, geometry_cache, geometry_body, obj, topology, edge_hash", "stl_ascii")
+        .add_option<int>("", "--bench-size", "(Only For bench) Size in MB of the generated input (stl_ascii/geometry_json/geometry_cache/geometry_body/obj/topology/edge_hash: when -p does not exist; normals: vertex buffer size)", 1024)
+        .add_option<float>("", "--edge-tolerance", "(Only For STL) Screen space error in pixels when re-tessellating edges for the current view. 0 draws the sampled points from the geometry json", 0.5)
+        .add_option<double>("", "--weld-tolerance", "(Only For STL) Merge STL vertices closer than this in every axis. Defaults to the topology tolerance (Topology::GLOBAL_TOLERANCE); 0 merges identical coordinates only", static_cast<double>(Topology::GLOBAL_TOLERANCE))
         .parse(argc, argv);
 
-    // ģʽ
+    // 模式
 	std::string mode = args_parser.get_option<std::string>("-m");
 
-    int selected_body = args_parser.get_option<int>("-b");
+    // 负数（原来的-1）表示全部body
+    std::set<int> selected_bodies;
+    for (const std::string& body : Utils::SplitStr(args_parser.get_option<std::string>("-b"), ',')) {
+        // SplitStr不会去掉最后一项末尾的空白
+        const char* body_end = body.data() + body.size();
+        while (body_end > body.data() && (body_end[-1] == ' ' || body_end[-1] == '\t')) {
+            body_end--;
+        }
+        int body_id = -1;
+        auto [ptr, ec] = std::from_chars(body.data(), body_end, body_id);
+        if (ec != std::errc() || ptr != body_end) {
+            SPDLOG_ERROR("Invalid body id in -b/--body: \"{}\", expected comma separated integers (e.g. 1,3)", body);
+            args_parser.print_usage();
+            return -1;
+        }
+        if (body_id >= 0) {
+            selected_bodies.insert(body_id);
+        }
+    }
     float scale_factor = args_parser.get_option<float>("-x");
     double distance_threshold = args_parser.get_option<double>("-D");
     double angle_threshold = args_parser.get_option<double>("-A");
@@ -127,9 +159,30 @@ int main(int argc, char const* argv[])
     std::string meshbox_json_path = args_parser.get_option<std::string>("--meshbox");
     std::string rays_json_path = args_parser.get_option<std::string>("--rays");
 
+    int thread_count = args_parser.get_option<int>("-j");
+    bool indexed_vertices = args_parser.get_option<bool>("--indexed");
+    bool compact_vertices = args_parser.get_option<bool>("--compact-vertices");
+    bool no_geometry_cache = args_parser.get_option<bool>("--no-geometry-cache");
+    bool lazy_edge_properties = args_parser.get_option<bool>("--lazy-edge-properties");
+    double weld_tolerance = args_parser.get_option<double>("--weld-tolerance");
+    float edge_tolerance = args_parser.get_option<float>("--edge-tolerance");
+    std::string bench_name = args_parser.get_option<std::string>("--bench");
+    int bench_size = args_parser.get_option<int>("--bench-size");
+
     // parse args END
 
-    // ע⣺myRenderEngine ȹ
+    Utils::ThreadPool::GetInstance().SetThreadCount(std::max(thread_count, 0));
+
+    Info::StlLoadOptions stl_load_options;
+    stl_load_options.indexed = indexed_vertices;
+    stl_load_options.weldTolerance = weld_tolerance;
+
+    // 性能测试模式：不创建窗口
+    if (mode == "bench") {
+        return Benchmark::Run(bench_name, model_path, static_cast<size_t>(std::max(bench_size, 1)));
+    }
+
+    // 注意：myRenderEngine 必须先构造
     MyRenderEngine::MyRenderEngine myRenderEngine;
     
     Shader stlShader("./shaders/MySat/OIT/stlShader.vs", "./shaders/MySat/OIT/stlShader.fs");
@@ -156,7 +209,8 @@ int main(int argc, char const* argv[])
     myRenderEngine.SetScreenShader(&screenShader);
 
     Info::SatInfo satInfo;
-    Info::ObjInfo objInfo;// ע. ﲻܰŲif棬ΪĿǰobjRendererPtrͨõķʽϢģ
+    Info::ObjInfo objInfo;// 注意这两个对象的生命周期. 这里不能把这两个对象挪到if里面，因为目前objRendererPtr是通过引用的方式拿信息的！
+    Topology::HalfEdgeMesh objMesh; // 同上，ObjLineRenderer和ObjGuiRenderer引用它
     Info::DebugShowInfo debugShowInfo;
 
     Info::CellInfo cellInfo;
@@ -168,53 +222,59 @@ int main(int argc, char const* argv[])
         objInfo.LoadFromObj(model_path); 
         std::cout << "Loading OBJ Done." << std::endl;
 
-        ObjMarkNum::GetInstance().LoadFromObjInfo(objInfo); // עload
+        objMesh.Build(objInfo); // 注意这个必须先load
 
         auto objRendererPtr = std::make_shared<MyRenderEngine::ObjRenderer>(objInfo ,&(objShader), &(objTransparentShader));
-        objRendererPtr->Setup();
+        objRendererPtr->Setup(compact_vertices, indexed_vertices);
         myRenderEngine.AddOpaqueOrTransparentRenderable(objRendererPtr);
 
         //auto objNonManifoldLineWithGuiRendererPtr = std::make_shared<MyRenderEngine::ObjNonManifoldLineWithGuiRenderer>(MyRenderEngine::ObjMarkNum::GetInstance(), &(objLineShader), myRenderEngine);
         //objNonManifoldLineWithGuiRendererPtr->SetUp();
         //myRenderEngine.AddOpaqueRenderable(objNonManifoldLineWithGuiRendererPtr);
 
-		auto objLineRendererPtr = std::make_shared<MyRenderEngine::ObjLineRenderer>(&(objLineShader));
+		auto objLineRendererPtr = std::make_shared<MyRenderEngine::ObjLineRenderer>(objMesh, &(objLineShader));
         objLineRendererPtr->SetUp();
 		myRenderEngine.AddOpaqueRenderable(objLineRendererPtr);
 
-		auto objGuiRendererPtr = std::make_shared<MyRenderEngine::ObjGuiRenderer>();
+		auto objGuiRendererPtr = std::make_shared<MyRenderEngine::ObjGuiRenderer>(objMesh);
         objGuiRendererPtr->SetUp();
 		myRenderEngine.AddGuiRenderable(objGuiRendererPtr);
     }
     else if(mode == "sat") {
         std::cout << "Loading STL: " << model_path << std::endl;
-        satInfo.LoadStl(model_path);
+        satInfo.LoadStls(Utils::ExpandPaths(model_path), stl_load_options);
         std::cout << "Loading STL Done." << std::endl;
 
         std::cout << "Loading Geometry Json: " << geometry_path << std::endl;
-        satInfo.LoadGeometryJson(geometry_path, selected_body);
+        satInfo.useGeometryCache = !no_geometry_cache;
+        satInfo.lazyEdgeProperties = lazy_edge_properties;
+        satInfo.LoadGeometryJson(geometry_path, selected_bodies);
         std::cout << "Loading Geometry Json Done." << std::endl;
 
         myRenderEngine.SetCameraPos(satInfo.newCameraPos);
 
         auto satStlRendererPtr = std::make_shared<MyRenderEngine::SatStlRenderer>(&(stlShader), &(stlTransparentShader));
-        satStlRendererPtr->LoadFromSatInfo(satInfo);
+        satStlRendererPtr->LoadFromSatInfo(satInfo, compact_vertices);
         myRenderEngine.AddOpaqueOrTransparentRenderable(satStlRendererPtr);
 
         auto satLineRendererPtr = std::make_shared<MyRenderEngine::SatLineRenderer>(&(lineShader));
+        satLineRendererPtr->pixelTolerance = std::max(edge_tolerance, 0.0f);
         satLineRendererPtr->LoadFromSatInfo(satInfo);
         myRenderEngine.AddOpaqueRenderable(satLineRendererPtr);
 
         auto myGuiRendererPtr = std::make_shared<MyRenderEngine::SatGuiRenderer>(satInfo);
         myRenderEngine.AddGuiRenderable(myGuiRendererPtr);
+
+        auto stlGuiRendererPtr = std::make_shared<MyRenderEngine::StlGuiRenderer>(satInfo);
+        myRenderEngine.AddGuiRenderable(stlGuiRendererPtr);
 	}
 	else if (mode == "cell") {
-        // ʱsatĴ棿
+        // 先暂时用sat的代替？
 
         if (model_path != "")
         {
             std::cout << "Loading STL: " << model_path << std::endl;
-            satInfo.LoadStl(model_path);
+            satInfo.LoadStls(Utils::ExpandPaths(model_path), stl_load_options);
             std::cout << "Loading STL Done." << std::endl;
         }
 
@@ -233,9 +293,12 @@ int main(int argc, char const* argv[])
         myRenderEngine.SetCameraPos(satInfo.newCameraPos);
 
         auto satStlRendererPtr = std::make_shared<MyRenderEngine::SatStlRenderer>(&(stlShader), &(stlTransparentShader));
-        satStlRendererPtr->LoadFromSatInfo(satInfo);
+        satStlRendererPtr->LoadFromSatInfo(satInfo, compact_vertices);
         myRenderEngine.AddOpaqueOrTransparentRenderable(satStlRendererPtr);
 
+        auto stlGuiRendererPtr = std::make_shared<MyRenderEngine::StlGuiRenderer>(satInfo);
+        myRenderEngine.AddGuiRenderable(stlGuiRendererPtr);
+
         auto cellRendererPtr = std::make_shared<MyRenderEngine::CellRenderer>(&lineShader);
         cellRendererPtr->LoadFromCellInfo(cellInfo, glm::vec3{ 0.0f, 0.0f, 1.0f });
         myRenderEngine.AddOpaqueRenderable(cellRendererPtr);
@@ -193,7 +193,7 @@ private:
             {   // if texture hasn't been loaded already, load it
                 Texture texture;
 
-                // FDXļͼaiSceneУμģһڵ·
+                // FDX文件的贴图在aiScene中，参见模型一节的下方评论
                 const aiTexture* aitex = scene->GetEmbeddedTexture(str.C_Str());
 
                 if (aitex != nullptr) {
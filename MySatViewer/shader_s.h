@@ -121,17 +121,17 @@ public:
     }
 
     void setMatrix4(const std::string& name, glm::mat4 mat) const {
-        // uniformλֵĿǷתãĬ󣩣ָ루Ҫglm::value_ptrתʽ
+        // 参数：uniform位置值，矩阵数目，是否转置（默认是列主序矩阵），矩阵指针（需要调用glm::value_ptr转换形式）
         glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
     }
 
     void setMatrix3(const std::string& name, glm::mat3 mat) const {
-        // uniformλֵĿǷתãĬ󣩣ָ루Ҫglm::value_ptrתʽ
+        // 参数：uniform位置值，矩阵数目，是否转置（默认是列主序矩阵），矩阵指针（需要调用glm::value_ptr转换形式）
         glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
     }
 
     void setMatrix2(const std::string& name, glm::mat2 mat) const {
-        // uniformλֵĿǷתãĬ󣩣ָ루Ҫglm::value_ptrתʽ
+        // 参数：uniform位置值，矩阵数目，是否转置（默认是列主序矩阵），矩阵指针（需要调用glm::value_ptr转换形式）
         glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
     }
 
@@ -9,6 +9,7 @@ in VS_OUT {
 } fs_in;
 
 uniform vec3 viewPos;
+uniform bool flatNormalFromDerivatives; // 索引模式下顶点不带法向，由屏幕空间导数求面法向
 
 float transparency = 0.5;
 
@@ -21,7 +22,20 @@ void main()
 
     // diffuse
     vec3 viewDir = normalize(viewPos - fs_in.FragPos);
-    vec3 normal = normalize(fs_in.Normal);
+    vec3 normal;
+    if(flatNormalFromDerivatives)
+    {
+        // 导数求出的法向总是朝向相机，背面时翻转，使正反面着色与按环绕方向算出的法向一致
+        normal = normalize(cross(dFdx(fs_in.FragPos), dFdy(fs_in.FragPos)));
+        if(!gl_FrontFacing)
+        {
+            normal = -normal;
+        }
+    }
+    else
+    {
+        normal = normalize(fs_in.Normal);
+    }
     // float diff = max(dot(viewDir, normal), 0.0);
     float diff = dot(viewDir, normal);
     if(diff < 0.0)
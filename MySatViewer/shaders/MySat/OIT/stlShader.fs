@@ -7,17 +7,36 @@ in VS_OUT {
 } fs_in;
 
 uniform vec3 viewPos;
+uniform bool flatNormalFromDerivatives; // 索引模式下顶点不带法向，由屏幕空间导数求面法向
+uniform bool highlight; // 在GUI中高亮的面/part
 
 void main()
 {           
     vec3 color = vec3(1.0, 1.0, 0.0);
+    if(highlight)
+    {
+        color = vec3(0.0, 1.0, 1.0); // 青
+    }
 
     // ambient
     vec3 ambient = 0.05 * color;
 
     // diffuse
     vec3 viewDir = normalize(viewPos - fs_in.FragPos);
-    vec3 normal = normalize(fs_in.Normal);
+    vec3 normal;
+    if(flatNormalFromDerivatives)
+    {
+        // 导数求出的法向总是朝向相机，背面时翻转，使正反面着色与按环绕方向算出的法向一致
+        normal = normalize(cross(dFdx(fs_in.FragPos), dFdy(fs_in.FragPos)));
+        if(!gl_FrontFacing)
+        {
+            normal = -normal;
+        }
+    }
+    else
+    {
+        normal = normalize(fs_in.Normal);
+    }
     // float diff = max(dot(viewDir, normal), 0.0);
     float diff = dot(viewDir, normal);
     if(diff < 0.0)
@@ -11,9 +11,33 @@ uniform mat4 projection;
 uniform mat4 view;
 uniform mat4 model;
 
+// 紧凑顶点格式：aPos为按包围盒量化的归一化16位坐标，aNormal.xy为八面体编码的法向
+uniform bool compactVertices;
+uniform vec3 positionMin;
+uniform vec3 positionExtent;
+
+vec3 OctDecode(vec2 e)
+{
+    vec3 n = vec3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+    if(n.z < 0.0)
+    {
+        vec2 s = vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(e.yx)) * s;
+    }
+    return normalize(n);
+}
+
 void main()
 {
-    vs_out.FragPos = aPos;
-    vs_out.Normal = aNormal;
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    vec3 pos = aPos;
+    vec3 normal = aNormal;
+    if(compactVertices)
+    {
+        pos = positionMin + aPos * positionExtent;
+        normal = OctDecode(aNormal.xy);
+    }
+
+    vs_out.FragPos = pos;
+    vs_out.Normal = normal;
+    gl_Position = projection * view * model * vec4(pos, 1.0);
 }
\ No newline at end of file
@@ -29,7 +29,8 @@
  * The central function of this file is `ReadStlFile(...)`. It automatically recognizes
  * whether an *ASCII* or a *Binary* file is to be read. It identifies matching corner
  * coordinates of triangles with each other, so that the resulting coordinate
- * array does not contain the same coordinate-triple multiple times.
+ * array does not contain the same coordinate-triple multiple times. Corners are
+ * matched through a spatial hash grid, optionally within a user given tolerance.
  *
  * The function operates on template container types. Those containers should
  * have similar interfaces as `std::vector` and operate on `float` or `double` types
@@ -128,11 +129,19 @@
 #define __H__STL_READER
 
 #include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <exception>
 #include <fstream>
+#include <limits>
 #include <sstream>
 #include <vector>
 
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+
 #ifdef STL_READER_NO_EXCEPTIONS
 #define STL_READER_THROW(msg) return false;
 #define STL_READER_COND_THROW(cond, msg) if(cond) return false;
@@ -186,6 +195,15 @@ namespace stl_reader {
 	 *                              The type TIndexContainer should have the same interface
 	 *                              as std::vector<size_t>.
 	 *
+	 * \param weldTolerance  [in] Corners whose coordinates differ by at most weldTolerance
+	 *                            in every component are merged into one vertex. The default
+	 *                            of 0 merges exactly matching coordinates only.
+	 *
+	 * \param triangleMapOut [out] Optional. If not null, it receives one entry per triangle
+	 *                             of the file: the index of that triangle in trisOut, or
+	 *                             the maximum value of the index type if the triangle was
+	 *                             removed as degenerated after welding.
+	 *
 	 * \returns true if the file was successfully read into the provided container.
 	 */
 	template <class TNumberContainer1, class TNumberContainer2,
@@ -194,11 +212,16 @@ namespace stl_reader {
 		TNumberContainer1& coordsOut,
 		TNumberContainer2& normalsOut,
 		TIndexContainer1& trisOut,
-		TIndexContainer2& solidRangesOut);
+		TIndexContainer2& solidRangesOut,
+		double weldTolerance = 0,
+		TIndexContainer1* triangleMapOut = nullptr);
 
 
 	/// Reads an ASCII stl file into several arrays
-	/** \copydetails ReadStlFile
+	/** The file is memory mapped and split at facet boundaries into chunks, which
+	 * are parsed in parallel on the shared thread pool. If the file can't be mapped,
+	 * ReadStlFile_ASCII_Stream is used instead.
+	 * \copydetails ReadStlFile
 	 * \sa ReadStlFile, ReadStlFile_ASCII
 	 */
 	template <class TNumberContainer1, class TNumberContainer2,
@@ -207,7 +230,23 @@ namespace stl_reader {
 		TNumberContainer1& coordsOut,
 		TNumberContainer2& normalsOut,
 		TIndexContainer1& trisOut,
-		TIndexContainer2& solidRangesOut);
+		TIndexContainer2& solidRangesOut,
+		double weldTolerance = 0,
+		TIndexContainer1* triangleMapOut = nullptr);
+
+	/// Reads an ASCII stl file line by line through iostreams
+	/** \copydetails ReadStlFile
+	 * \sa ReadStlFile, ReadStlFile_ASCII
+	 */
+	template <class TNumberContainer1, class TNumberContainer2,
+		class TIndexContainer1, class TIndexContainer2>
+	bool ReadStlFile_ASCII_Stream(const char* filename,
+		TNumberContainer1& coordsOut,
+		TNumberContainer2& normalsOut,
+		TIndexContainer1& trisOut,
+		TIndexContainer2& solidRangesOut,
+		double weldTolerance = 0,
+		TIndexContainer1* triangleMapOut = nullptr);
 
 	/// Reads a binary stl file into several arrays
 	/** \copydetails ReadStlFile
@@ -220,7 +259,9 @@ namespace stl_reader {
 		TNumberContainer1& coordsOut,
 		TNumberContainer2& normalsOut,
 		TIndexContainer1& trisOut,
-		TIndexContainer2& solidRangesOut);
+		TIndexContainer2& solidRangesOut,
+		double weldTolerance = 0,
+		TIndexContainer1* triangleMapOut = nullptr);
 
 	/// Determines whether a stl file has ASCII format
 	/** The underlying mechanism is simply checks whether the provided file starts
@@ -241,21 +282,22 @@ namespace stl_reader {
 		}
 
 		/// initializes the mesh from the stl-file specified through filename
-		/** \{ */
-		StlMesh(const char* filename)
+		/** weldTolerance and triangleMapOut are forwarded to ReadStlFile.
+		 * \{ */
+		StlMesh(const char* filename, double weldTolerance = 0, std::vector<TIndex>* triangleMapOut = nullptr)
 		{
-			read_file(filename);
+			read_file(filename, weldTolerance, triangleMapOut);
 		}
 
-		StlMesh(const std::string& filename)
+		StlMesh(const std::string& filename, double weldTolerance = 0, std::vector<TIndex>* triangleMapOut = nullptr)
 		{
-			read_file(filename);
+			read_file(filename, weldTolerance, triangleMapOut);
 		}
 		/** \} */
 
 		/// fills the mesh with the contents of the specified stl-file
 		/** \{ */
-		bool read_file(const char* filename)
+		bool read_file(const char* filename, double weldTolerance = 0, std::vector<TIndex>* triangleMapOut = nullptr)
 		{
 			bool res = false;
 
@@ -263,7 +305,7 @@ namespace stl_reader {
 			try {
 #endif
 
-				res = ReadStlFile(filename, coords, normals, tris, solids);
+				res = ReadStlFile(filename, coords, normals, tris, solids, weldTolerance, triangleMapOut);
 
 #ifndef STL_READER_NO_EXCEPTIONS
 			}
@@ -282,9 +324,9 @@ namespace stl_reader {
 				return res;
 			}
 
-			bool read_file(const std::string & filename)
+			bool read_file(const std::string & filename, double weldTolerance = 0, std::vector<TIndex>* triangleMapOut = nullptr)
 			{
-				return read_file(filename.c_str());
+				return read_file(filename.c_str(), weldTolerance, triangleMapOut);
 			}
 			/** \} */
 
@@ -416,86 +458,227 @@ namespace stl_reader {
 
 		namespace stl_reader_impl {
 
-			// a coordinate triple with an additional index. The index is required
-			// for RemoveDoubles, so that triangles can be reindexed properly.
-			template <typename number_t, typename index_t>
-			struct CoordWithIndex {
-				number_t data[3];
-				index_t index;
-
-				bool operator == (const CoordWithIndex& c) const
-				{
-					return (c[0] == data[0]) && (c[1] == data[1]) && (c[2] == data[2]);
-				}
-
-				bool operator != (const CoordWithIndex& c) const
-				{
-					return (c[0] != data[0]) || (c[1] != data[1]) || (c[2] != data[2]);
-				}
-
-				bool operator < (const CoordWithIndex& c) const
-				{
-					return (data[0] < c[0])
-						|| (data[0] == c[0] && data[1] < c[1])
-						|| (data[0] == c[0] && data[1] == c[1] && data[2] < c[2]);
+			// Returns the grid cell of a coordinate triple. With a positive tolerance the
+			// cell size equals the tolerance, so that two coordinates which differ by at
+			// most the tolerance in every component lie in the same or in adjacent cells.
+			// Without tolerance the bit pattern of the coordinates itself is used as key.
+			template <typename number_t>
+			inline void WeldCellKey(const number_t* c, const number_t tolerance, int64_t key[3])
+			{
+				for (int i = 0; i < 3; ++i) {
+					if (tolerance > 0) {
+						const number_t limit = static_cast<number_t>(int64_t(1) << 62);
+						const number_t cell = std::floor(c[i] / tolerance);
+						key[i] = static_cast<int64_t>(std::max(-limit, std::min(limit, cell)));
+					}
+					else {
+						// +0 and -0 compare equal and thus have to share a key
+						const number_t v = (c[i] == 0) ? number_t(0) : c[i];
+						key[i] = 0;
+						std::memcpy(&key[i], &v, sizeof(number_t));
+					}
 				}
+			}
 
-				inline number_t& operator [] (const size_t i) { return data[i]; }
-				inline number_t operator [] (const size_t i) const { return data[i]; }
-			};
+			inline uint64_t WeldCellHash(const int64_t key[3])
+			{
+				uint64_t h = static_cast<uint64_t>(key[0]) * 0x9E3779B97F4A7C15ull
+					^ static_cast<uint64_t>(key[1]) * 0xC2B2AE3D27D4EB4Full
+					^ static_cast<uint64_t>(key[2]) * 0x165667B19E3779F9ull;
+				h ^= h >> 31;
+				h *= 0xD6E8FEB86659FD93ull;
+				h ^= h >> 32;
+				return h;
+			}
 
-			// sorts the array coordsWithIndexInOut and copies unique indices to coordsOut.
-			// Triangle-corners are re-indexed on the fly and degenerated triangles are removed.
+			// Merges the corner coordinates coordsIn (3 entries per corner) into unique
+			// vertices and writes them to uniqueCoordsOut. Triangle-corners are re-indexed
+			// on the fly and degenerated triangles are removed. If triangleMapOut is not
+			// null, it receives the new index of every input triangle (noIndex if removed).
+			//
+			// Corners are bucketed into a spatial hash grid. The grid is split into
+			// partitions by cell hash, and each partition owns an open addressing table
+			// whose cells link their corners in ascending index order. Partitions are
+			// built in parallel, afterwards every corner looks up its own cell (and with
+			// a positive tolerance the 26 neighbouring cells) in parallel and picks the
+			// smallest corner index within tolerance as representative. Representatives are
+			// resolved in index order, so the result is deterministic and unique vertices
+			// appear in the order of their first occurrence. The expected cost is linear
+			// in the number of corners.
 			template <class TNumberContainer1, class TNumberContainer2,
 				class TIndexContainer1, class TIndexContainer2>
-			void RemoveDoubles(TNumberContainer1& uniqueCoordsOut,
+			void WeldVertices(TNumberContainer1& uniqueCoordsOut,
 				TIndexContainer1& trisInOut,
 				TNumberContainer2& normalsInOut,
 				TIndexContainer2& solidsInOut,
-				std::vector <CoordWithIndex<
-				typename TNumberContainer1::value_type,
-				typename TIndexContainer1::value_type> >
-				& coordsWithIndexInOut)
+				const std::vector<typename TNumberContainer1::value_type>& coordsIn,
+				const double weldTolerance,
+				TIndexContainer1* triangleMapOut = nullptr)
 			{
 				using namespace std;
 
 				typedef typename TNumberContainer1::value_type number_t;
 				typedef typename TIndexContainer1::value_type  index_t;
 
-				sort(coordsWithIndexInOut.begin(), coordsWithIndexInOut.end());
-
-				//  first count unique indices
-				index_t numUnique = 1;
-				for (size_t i = 1; i < coordsWithIndexInOut.size(); ++i) {
-					if (coordsWithIndexInOut[i] != coordsWithIndexInOut[i - 1])
-						++numUnique;
+				const size_t numCorners = coordsIn.size() / 3;
+				const number_t tolerance = static_cast<number_t>(max(0.0, weldTolerance));
+				const int cellRange = (tolerance > 0) ? 1 : 0;
+				const index_t noIndex = numeric_limits<index_t>::max();
+
+				uniqueCoordsOut.clear();
+				if (triangleMapOut)
+					triangleMapOut->assign(trisInOut.size() / 3, noIndex);
+				if (numCorners == 0) {
+					trisInOut.clear();
+					normalsInOut.clear();
+					return;
 				}
 
-				uniqueCoordsOut.resize(numUnique * 3);
-				vector<index_t> newIndex(coordsWithIndexInOut.size());
+				auto& pool = Utils::ThreadPool::GetInstance();
+
+				size_t numParts = 1;
+				while (numParts < pool.ThreadCount() * 4)
+					numParts <<= 1;
+
+				auto cellHash = [&](size_t i) {
+					int64_t key[3];
+					WeldCellKey(&coordsIn[3 * i], tolerance, key);
+					return WeldCellHash(key);
+				};
+
+				//  stable counting sort of all corners by partition. Each chunk counts
+				//  its corners per partition first, the chunk offsets are then laid out
+				//  partition-major so that every partition keeps ascending corner indices.
+				const size_t numChunks = pool.ChunkCount(numCorners);
+				vector<size_t> chunkOffsets(numChunks * numParts, 0);
+
+				pool.ParallelFor(numCorners, [&](size_t begin, size_t end, size_t chunk) {
+					size_t* counts = &chunkOffsets[chunk * numParts];
+					for (size_t i = begin; i < end; ++i)
+						++counts[cellHash(i) & (numParts - 1)];
+				});
+
+				vector<size_t> partBegin(numParts + 1, 0);
+				vector<size_t> tableBegin(numParts + 1, 0);
+				size_t offset = 0;
+				for (size_t p = 0; p < numParts; ++p) {
+					partBegin[p] = offset;
+					for (size_t c = 0; c < numChunks; ++c) {
+						const size_t count = chunkOffsets[c * numParts + p];
+						chunkOffsets[c * numParts + p] = offset;
+						offset += count;
+					}
 
-				TIndexContainer2 newSolids;
+					size_t tableSize = 2;
+					while (tableSize < 2 * (offset - partBegin[p]))
+						tableSize <<= 1;
+					tableBegin[p + 1] = tableBegin[p] + tableSize;
+				}
+				partBegin[numParts] = offset;
+
+				vector<index_t> order(numCorners);
+				pool.ParallelFor(numCorners, [&](size_t begin, size_t end, size_t chunk) {
+					size_t* offsets = &chunkOffsets[chunk * numParts];
+					for (size_t i = begin; i < end; ++i)
+						order[offsets[cellHash(i) & (numParts - 1)]++] = static_cast<index_t>(i);
+				});
+
+				//  per partition hash tables: a slot stores the first and the last corner
+				//  of a cell, 'nextInCell' links the corners of a cell.
+				vector<index_t> cellHead(tableBegin[numParts], noIndex);
+				vector<index_t> cellTail(tableBegin[numParts], noIndex);
+				vector<index_t> nextInCell(numCorners, noIndex);
+
+				//  returns the slot of the given cell, or the empty slot where it would be inserted
+				auto findSlot = [&](const int64_t key[3]) {
+					const uint64_t h = WeldCellHash(key);
+					const size_t p = h & (numParts - 1);
+					const size_t mask = tableBegin[p + 1] - tableBegin[p] - 1;
+					size_t slot = static_cast<size_t>(h >> 24) & mask;
+					while (true) {
+						const index_t head = cellHead[tableBegin[p] + slot];
+						if (head == noIndex)
+							return tableBegin[p] + slot;
+
+						int64_t headKey[3];
+						WeldCellKey(&coordsIn[3 * head], tolerance, headKey);
+						if (headKey[0] == key[0] && headKey[1] == key[1] && headKey[2] == key[2])
+							return tableBegin[p] + slot;
+
+						slot = (slot + 1) & mask;
+					}
+				};
+
+				pool.ParallelFor(numParts, [&](size_t begin, size_t end, size_t) {
+					for (size_t p = begin; p < end; ++p) {
+						for (size_t k = partBegin[p]; k < partBegin[p + 1]; ++k) {
+							const index_t i = order[k];
+							int64_t key[3];
+							WeldCellKey(&coordsIn[3 * i], tolerance, key);
+
+							const size_t slot = findSlot(key);
+							if (cellHead[slot] == noIndex)
+								cellHead[slot] = i;
+							else
+								nextInCell[cellTail[slot]] = i;
+							cellTail[slot] = i;
+						}
+					}
+				}, 1);
+
+				//  every corner picks the smallest corner index within tolerance.
+				//  The corner itself is always found, so representative[i] <= i.
+				vector<index_t> representative(numCorners);
+				pool.ParallelFor(numCorners, [&](size_t begin, size_t end, size_t) {
+					for (size_t i = begin; i < end; ++i) {
+						const number_t* ci = &coordsIn[3 * i];
+						int64_t key[3];
+						WeldCellKey(ci, tolerance, key);
+
+						index_t best = static_cast<index_t>(i);
+						for (int dx = -cellRange; dx <= cellRange; ++dx)
+						for (int dy = -cellRange; dy <= cellRange; ++dy)
+						for (int dz = -cellRange; dz <= cellRange; ++dz) {
+							const int64_t neighbourKey[3] = { key[0] + dx, key[1] + dy, key[2] + dz };
+							for (index_t j = cellHead[findSlot(neighbourKey)]; j != noIndex && j < best; j = nextInCell[j]) {
+								const number_t* cj = &coordsIn[3 * j];
+								const bool match = (tolerance > 0)
+									? (fabs(ci[0] - cj[0]) <= tolerance && fabs(ci[1] - cj[1]) <= tolerance && fabs(ci[2] - cj[2]) <= tolerance)
+									: (ci[0] == cj[0] && ci[1] == cj[1] && ci[2] == cj[2]);
+								if (match) {
+									best = j;
+									break;
+								}
+							}
+						}
+						representative[i] = best;
+					}
+				});
+
+				//  resolve representatives in index order and copy unique coordinates to
+				//  'uniqueCoordsOut'. 'newIndex' allows to re-index triangles later on.
+				vector<index_t> newIndex(numCorners);
+				index_t numUnique = 0;
+				for (size_t i = 0; i < numCorners; ++i) {
+					if (representative[i] == i)
+						++numUnique;
+				}
 
-				//  copy unique coordinates to 'uniqueCoordsOut' and create an index-map
-				//  'newIndex', which allows to re-index triangles later on.
+				uniqueCoordsOut.resize(static_cast<size_t>(numUnique) * 3);
 				index_t curInd = 0;
-				newIndex[coordsWithIndexInOut[0].index] = 0;
-				for (index_t i = 0; i < 3; ++i)
-					uniqueCoordsOut[i] = coordsWithIndexInOut[0][i];
-
-				for (size_t i = 1; i < coordsWithIndexInOut.size(); ++i) {
-					const CoordWithIndex <number_t, index_t> c = coordsWithIndexInOut[i];
-					if (c != coordsWithIndexInOut[i - 1]) {
-						++curInd;
-						for (index_t j = 0; j < 3; ++j)
-							uniqueCoordsOut[curInd * 3 + j] = coordsWithIndexInOut[i][j];
+				for (size_t i = 0; i < numCorners; ++i) {
+					if (representative[i] == i) {
+						for (size_t j = 0; j < 3; ++j)
+							uniqueCoordsOut[static_cast<size_t>(curInd) * 3 + j] = coordsIn[3 * i + j];
+						newIndex[i] = curInd++;
 					}
-
-					newIndex[c.index] = static_cast<index_t> (curInd);
+					else
+						newIndex[i] = newIndex[representative[i]];
 				}
 
 				//  re-index triangles, so that they refer to 'uniqueCoordsOut'
 				//  make sure to only add triangles which refer to three different indices
+				TIndexContainer2 newSolids;
 				index_t numUniqueTriInds = 0;
 				for (index_t i = 0; i < trisInOut.size(); i += 3) {
 
@@ -517,6 +700,8 @@ namespace stl_reader {
 							trisInOut[numUniqueTriInds + j] = ni[j];
 							normalsInOut[numUniqueTriInds + j] = normalsInOut[i + j];
 						}
+						if (triangleMapOut)
+							(*triangleMapOut)[triInd] = newTriInd;
 						numUniqueTriInds += 3;
 					}
 				}
@@ -533,6 +718,152 @@ namespace stl_reader {
 				using std::swap;
 				swap(solidsInOut, newSolids);
 			}
+
+			// the result of parsing one chunk of an ascii stl file
+			template <typename number_t, typename index_t>
+			struct AsciiStlChunk {
+				std::vector<number_t> cornerCoords;
+				std::vector<number_t> normals;
+				std::vector<index_t>  triFirstCorners; // chunk local index of the first corner of each triangle
+				std::vector<index_t>  solids;          // chunk local index of the first triangle of each solid
+				size_t      numLines = 0;
+				const char* error = nullptr;           // set if parsing failed in line numLines of this chunk
+			};
+
+			inline bool IsAsciiStlSpace(const char c)
+			{
+				return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+			}
+
+			// returns the next token in [p, lineEnd) and moves p behind it.
+			// The returned token is empty if the end of the line was reached.
+			inline std::pair<const char*, const char*> NextAsciiStlToken(const char*& p, const char* lineEnd)
+			{
+				while (p < lineEnd && IsAsciiStlSpace(*p))
+					++p;
+				const char* tokBegin = p;
+				while (p < lineEnd && !IsAsciiStlSpace(*p))
+					++p;
+				return std::make_pair(tokBegin, p);
+			}
+
+			inline bool AsciiStlTokenIs(const std::pair<const char*, const char*>& tok, const char* word)
+			{
+				const size_t len = std::strlen(word);
+				return static_cast<size_t>(tok.second - tok.first) == len
+					&& std::memcmp(tok.first, word, len) == 0;
+			}
+
+			// parses a number like atof does: invalid input yields 0
+			inline double ParseAsciiStlNumber(const std::pair<const char*, const char*>& tok)
+			{
+				const char* b = tok.first;
+				if (b < tok.second && *b == '+')
+					++b;
+				double v = 0;
+				std::from_chars(b, tok.second, v);
+				return v;
+			}
+
+			// returns the first position >= pos which starts a line beginning with
+			// 'facet', 'solid' or 'endsolid'. Chunks may start at such lines only,
+			// since no facet is open there.
+			inline size_t FindAsciiStlChunkStart(const char* data, const size_t size, size_t pos)
+			{
+				if (pos == 0)
+					return 0;
+
+				while (pos < size) {
+					const char* nl = static_cast<const char*>(std::memchr(data + pos - 1, '\n', size - pos + 1));
+					if (!nl)
+						return size;
+					pos = static_cast<size_t>(nl - data) + 1;
+
+					const char* p = data + pos;
+					const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', size - pos));
+					if (!lineEnd)
+						lineEnd = data + size;
+					const std::pair<const char*, const char*> tok = NextAsciiStlToken(p, lineEnd);
+					if (AsciiStlTokenIs(tok, "facet") || AsciiStlTokenIs(tok, "solid") || AsciiStlTokenIs(tok, "endsolid"))
+						return pos;
+					++pos;
+				}
+				return size;
+			}
+
+			// parses the lines in [begin, end). 'begin' has to be the start of a line.
+			template <typename number_t, typename index_t>
+			void ParseAsciiStlChunk(const char* begin, const char* end, AsciiStlChunk<number_t, index_t>& chunk)
+			{
+				typedef std::pair<const char*, const char*> token_t;
+
+				size_t numFaceVrts = 0;
+				const char* lineBegin = begin;
+
+				while (lineBegin < end)
+				{
+					const char* lineEnd = static_cast<const char*>(std::memchr(lineBegin, '\n', end - lineBegin));
+					if (!lineEnd)
+						lineEnd = end;
+
+					const char* p = lineBegin;
+					const token_t tok = NextAsciiStlToken(p, lineEnd);
+
+					if (AsciiStlTokenIs(tok, "vertex")) {
+						token_t vals[3];
+						for (size_t i = 0; i < 3; ++i)
+							vals[i] = NextAsciiStlToken(p, lineEnd);
+						if (vals[2].first == vals[2].second) {
+							chunk.error = "vertex not specified correctly";
+							return;
+						}
+
+						//  read the position
+						for (size_t i = 0; i < 3; ++i)
+							chunk.cornerCoords.push_back(static_cast<number_t> (ParseAsciiStlNumber(vals[i])));
+						++numFaceVrts;
+					}
+					else if (AsciiStlTokenIs(tok, "facet")) {
+						const token_t normalTok = NextAsciiStlToken(p, lineEnd);
+						token_t vals[3];
+						for (size_t i = 0; i < 3; ++i)
+							vals[i] = NextAsciiStlToken(p, lineEnd);
+						if (vals[2].first == vals[2].second) {
+							chunk.error = "triangle not specified correctly";
+							return;
+						}
+						if (!AsciiStlTokenIs(normalTok, "normal")) {
+							chunk.error = "Missing normal specifier";
+							return;
+						}
+
+						//  read the normal
+						for (size_t i = 0; i < 3; ++i)
+							chunk.normals.push_back(static_cast<number_t> (ParseAsciiStlNumber(vals[i])));
+
+						numFaceVrts = 0;
+					}
+					else if (AsciiStlTokenIs(tok, "outer")) {
+						if (!AsciiStlTokenIs(NextAsciiStlToken(p, lineEnd), "loop")) {
+							chunk.error = "expecting outer loop";
+							return;
+						}
+					}
+					else if (AsciiStlTokenIs(tok, "endfacet")) {
+						if (numFaceVrts != 3) {
+							chunk.error = "bad number of vertices specified for face";
+							return;
+						}
+						chunk.triFirstCorners.push_back(static_cast<index_t> (chunk.cornerCoords.size() / 3 - 3));
+					}
+					else if (AsciiStlTokenIs(tok, "solid")) {
+						chunk.solids.push_back(static_cast<index_t> (chunk.triFirstCorners.size()));
+					}
+
+					lineBegin = lineEnd + 1;
+					++chunk.numLines;
+				}
+			}
 		}// end of namespace stl_reader_impl
 
 
@@ -542,12 +873,14 @@ namespace stl_reader {
 			TNumberContainer1& coordsOut,
 			TNumberContainer2& normalsOut,
 			TIndexContainer1& trisOut,
-			TIndexContainer2& solidRangesOut)
+			TIndexContainer2& solidRangesOut,
+			double weldTolerance,
+			TIndexContainer1* triangleMapOut)
 		{
 			if (StlFileHasASCIIFormat(filename))
-				return ReadStlFile_ASCII(filename, coordsOut, normalsOut, trisOut, solidRangesOut);
+				return ReadStlFile_ASCII(filename, coordsOut, normalsOut, trisOut, solidRangesOut, weldTolerance, triangleMapOut);
 			else
-				return ReadStlFile_BINARY(filename, coordsOut, normalsOut, trisOut, solidRangesOut);
+				return ReadStlFile_BINARY(filename, coordsOut, normalsOut, trisOut, solidRangesOut, weldTolerance, triangleMapOut);
 		}
 
 
@@ -557,7 +890,104 @@ namespace stl_reader {
 			TNumberContainer1& coordsOut,
 			TNumberContainer2& normalsOut,
 			TIndexContainer1& trisOut,
-			TIndexContainer2& solidRangesOut)
+			TIndexContainer2& solidRangesOut,
+			double weldTolerance,
+			TIndexContainer1* triangleMapOut)
+		{
+			using namespace std;
+			using namespace stl_reader_impl;
+
+			typedef typename TNumberContainer1::value_type  number_t;
+			typedef typename TIndexContainer1::value_type index_t;
+
+			Utils::MappedFile file;
+			if (!file.Open(filename))
+				return ReadStlFile_ASCII_Stream(filename, coordsOut, normalsOut, trisOut, solidRangesOut, weldTolerance, triangleMapOut);
+
+			coordsOut.clear();
+			normalsOut.clear();
+			trisOut.clear();
+			solidRangesOut.clear();
+
+			const char* data = file.Data();
+			const size_t size = file.Size();
+
+			//  split the file into chunks of at least 1MB, each starting at a facet boundary
+			auto& pool = Utils::ThreadPool::GetInstance();
+			const size_t numChunks = pool.ChunkCount(size, size_t(1) << 20);
+
+			vector<size_t> chunkBegin(numChunks + 1, size);
+			chunkBegin[0] = 0;
+			for (size_t c = 1; c < numChunks; ++c)
+				chunkBegin[c] = FindAsciiStlChunkStart(data, size, max(chunkBegin[c - 1], size * c / numChunks));
+
+			vector<AsciiStlChunk<number_t, index_t> > chunks(numChunks);
+			pool.ParallelFor(numChunks, [&](size_t begin, size_t end, size_t) {
+				for (size_t c = begin; c < end; ++c)
+					ParseAsciiStlChunk(data + chunkBegin[c], data + chunkBegin[c + 1], chunks[c]);
+			}, 1);
+
+			//  report the first error in file order
+			size_t lineCount = 1;
+			for (size_t c = 0; c < numChunks; ++c) {
+				STL_READER_COND_THROW(chunks[c].error,
+					"ERROR while reading from " << filename <<
+					": " << chunks[c].error << " in line " << lineCount + chunks[c].numLines);
+				lineCount += chunks[c].numLines;
+			}
+
+			//  concatenate the chunks. Corner and triangle indices are offset by the
+			//  number of corners and triangles of all preceding chunks.
+			vector<size_t> cornerOffsets(numChunks + 1, 0);
+			vector<size_t> normalOffsets(numChunks + 1, 0);
+			vector<size_t> triOffsets(numChunks + 1, 0);
+			for (size_t c = 0; c < numChunks; ++c) {
+				cornerOffsets[c + 1] = cornerOffsets[c] + chunks[c].cornerCoords.size();
+				normalOffsets[c + 1] = normalOffsets[c] + chunks[c].normals.size();
+				triOffsets[c + 1] = triOffsets[c] + chunks[c].triFirstCorners.size();
+
+				for (size_t i = 0; i < chunks[c].solids.size(); ++i)
+					solidRangesOut.push_back(static_cast<index_t> (triOffsets[c] + chunks[c].solids[i]));
+			}
+			solidRangesOut.push_back(static_cast<index_t> (triOffsets[numChunks]));
+
+			vector<number_t> cornerCoords(cornerOffsets[numChunks]);
+			normalsOut.resize(normalOffsets[numChunks]);
+			trisOut.resize(triOffsets[numChunks] * 3);
+
+			pool.ParallelFor(numChunks, [&](size_t begin, size_t end, size_t) {
+				for (size_t c = begin; c < end; ++c) {
+					const AsciiStlChunk<number_t, index_t>& chunk = chunks[c];
+					copy(chunk.cornerCoords.begin(), chunk.cornerCoords.end(), cornerCoords.begin() + cornerOffsets[c]);
+
+					for (size_t i = 0; i < chunk.normals.size(); ++i)
+						normalsOut[normalOffsets[c] + i] = chunk.normals[i];
+
+					const index_t cornerOffset = static_cast<index_t> (cornerOffsets[c] / 3);
+					for (size_t i = 0; i < chunk.triFirstCorners.size(); ++i) {
+						for (index_t j = 0; j < 3; ++j)
+							trisOut[(triOffsets[c] + i) * 3 + j] = cornerOffset + chunk.triFirstCorners[i] + j;
+					}
+				}
+			}, 1);
+
+			chunks.clear();
+
+			WeldVertices(coordsOut, trisOut, normalsOut, solidRangesOut, cornerCoords, weldTolerance, triangleMapOut);
+
+			return true;
+		}
+
+
+		template <class TNumberContainer1, class TNumberContainer2,
+			class TIndexContainer1, class TIndexContainer2>
+		bool ReadStlFile_ASCII_Stream(const char* filename,
+			TNumberContainer1& coordsOut,
+			TNumberContainer2& normalsOut,
+			TIndexContainer1& trisOut,
+			TIndexContainer2& solidRangesOut,
+			double weldTolerance,
+			TIndexContainer1* triangleMapOut)
 		{
 			using namespace std;
 			using namespace stl_reader_impl;
@@ -573,7 +1003,7 @@ namespace stl_reader {
 			ifstream in(filename);
 			STL_READER_COND_THROW(!in, "Couldn't open file " << filename);
 
-			vector<CoordWithIndex <number_t, index_t> > coordsWithIndex;
+			vector<number_t> cornerCoords;
 
 			string buffer;
 			vector<string> tokens;
@@ -609,11 +1039,8 @@ namespace stl_reader {
 						}
 
 						//  read the position
-						CoordWithIndex <number_t, index_t> c;
 						for (size_t i = 0; i < 3; ++i)
-							c[i] = static_cast<number_t> (atof(tokens[i + 1].c_str()));
-						c.index = static_cast<index_t>(coordsWithIndex.size());
-						coordsWithIndex.push_back(c);
+							cornerCoords.push_back(static_cast<number_t> (atof(tokens[i + 1].c_str())));
 						++numFaceVrts;
 					}
 					else if (tok.compare("facet") == 0)
@@ -642,9 +1069,9 @@ namespace stl_reader {
 							"ERROR while reading from " << filename <<
 							": bad number of vertices specified for face in line " << lineCount);
 
-						trisOut.push_back(static_cast<index_t> (coordsWithIndex.size() - 3));
-						trisOut.push_back(static_cast<index_t> (coordsWithIndex.size() - 2));
-						trisOut.push_back(static_cast<index_t> (coordsWithIndex.size() - 1));
+						trisOut.push_back(static_cast<index_t> (cornerCoords.size() / 3 - 3));
+						trisOut.push_back(static_cast<index_t> (cornerCoords.size() / 3 - 2));
+						trisOut.push_back(static_cast<index_t> (cornerCoords.size() / 3 - 1));
 					}
 					else if (tok.compare("solid") == 0) {
 						solidRangesOut.push_back(static_cast<index_t> (trisOut.size() / 3));
@@ -655,7 +1082,7 @@ namespace stl_reader {
 
 			solidRangesOut.push_back(static_cast<index_t> (trisOut.size() / 3));
 
-			RemoveDoubles(coordsOut, trisOut, normalsOut, solidRangesOut, coordsWithIndex);
+			WeldVertices(coordsOut, trisOut, normalsOut, solidRangesOut, cornerCoords, weldTolerance, triangleMapOut);
 
 			return true;
 		}
@@ -667,7 +1094,9 @@ namespace stl_reader {
 			TNumberContainer1& coordsOut,
 			TNumberContainer2& normalsOut,
 			TIndexContainer1& trisOut,
-			TIndexContainer2& solidRangesOut)
+			TIndexContainer2& solidRangesOut,
+			double weldTolerance,
+			TIndexContainer1* triangleMapOut)
 		{
 			using namespace std;
 			using namespace stl_reader_impl;
@@ -691,7 +1120,11 @@ namespace stl_reader {
 			in.read((char*)&numTris, 4);
 			STL_READER_COND_THROW(!in, "Couldnt determine number of triangles in binary stl file " << filename);
 
-			vector<CoordWithIndex <number_t, index_t> > coordsWithIndex;
+			vector<number_t> cornerCoords;
+
+			cornerCoords.reserve(static_cast<size_t>(numTris) * 9);
+			normalsOut.reserve(static_cast<size_t>(numTris) * 3);
+			trisOut.reserve(static_cast<size_t>(numTris) * 3);
 
 			for (unsigned int tri = 0; tri < numTris; ++tri) {
 				float d[12];
@@ -702,16 +1135,13 @@ namespace stl_reader {
 					normalsOut.push_back(d[i]);
 
 				for (size_t ivrt = 1; ivrt < 4; ++ivrt) {
-					CoordWithIndex <number_t, index_t> c;
 					for (size_t i = 0; i < 3; ++i)
-						c[i] = d[ivrt * 3 + i];
-					c.index = static_cast<index_t>(coordsWithIndex.size());
-					coordsWithIndex.push_back(c);
+						cornerCoords.push_back(d[ivrt * 3 + i]);
 				}
 
-				trisOut.push_back(static_cast<index_t> (coordsWithIndex.size() - 3));
-				trisOut.push_back(static_cast<index_t> (coordsWithIndex.size() - 2));
-				trisOut.push_back(static_cast<index_t> (coordsWithIndex.size() - 1));
+				trisOut.push_back(static_cast<index_t> (cornerCoords.size() / 3 - 3));
+				trisOut.push_back(static_cast<index_t> (cornerCoords.size() / 3 - 2));
+				trisOut.push_back(static_cast<index_t> (cornerCoords.size() / 3 - 1));
 
 				char addData[2];
 				in.read(addData, 2);
@@ -721,7 +1151,7 @@ namespace stl_reader {
 			solidRangesOut.push_back(0);
 			solidRangesOut.push_back(static_cast<index_t> (trisOut.size() / 3));
 
-			RemoveDoubles(coordsOut, trisOut, normalsOut, solidRangesOut, coordsWithIndex);
+			WeldVertices(coordsOut, trisOut, normalsOut, solidRangesOut, cornerCoords, weldTolerance, triangleMapOut);
 
 			return true;
 		}